@@ -64,6 +64,26 @@ inline bool exists_if(const std::set<T>& container, P predicate)
 	return (std::find_if(container.begin(), container.end(), predicate) != container.end());
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! Search to see if the value exists within the sequence. The search stops at
+//! the first match, which allows it to be used with lazily evaluated sequences.
+
+template<typename I, typename T>
+inline bool exists(I first, I last, const T& value)
+{
+	return (std::find(first, last, value) != last);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Search to see if the value exists within the sequence using the predicate.
+//! The search stops at the first match.
+
+template<typename I, typename P>
+inline bool exists_if(I first, I last, P predicate)
+{
+	return (std::find_if(first, last, predicate) != last);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Perform a deep copy of the container.
 
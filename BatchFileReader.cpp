@@ -0,0 +1,292 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   BatchFileReader.cpp
+//! \brief  The BatchFileReader class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "BatchFileReader.hpp"
+#include "Win32Error.hpp"
+#include "FileSystemException.hpp"
+#include "InvalidArgException.hpp"
+#include "StringUtils.hpp"
+#include "Interlocked.hpp"
+#include <windows.h>
+#include <limits.h>
+#include <limits>
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The largest number of bytes requested by a single ReadFile().
+
+static const size_t MAX_READ_SIZE = INT_MAX;
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the entire contents of a file into the buffer. The buffer is sized up
+//! front from the file size, but the file is read until the end in case it
+//! has grown since.
+
+static void readWholeFile(const tstring& filename, std::vector<char>& content)
+{
+	HandlePtr file(::CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+								OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr), closeHandle);
+
+	if (file.get() == INVALID_HANDLE_VALUE)
+	{
+		file.detach();
+		throwLastError(TXT("Failed to open file"), filename);
+	}
+
+	LARGE_INTEGER size;
+
+	if (!::GetFileSizeEx(file.get(), &size))
+		throwLastError(TXT("Failed to query the size of file"), filename);
+
+	if (static_cast<ulonglong>(size.QuadPart) >= std::numeric_limits<size_t>::max())
+		throw FileSystemException(Core::fmt(TXT("The file '%s' is too large to be read into memory"), filename.c_str()));
+
+	content.resize(static_cast<size_t>(size.QuadPart) + 1);
+
+	size_t length = 0;
+
+	for (;;)
+	{
+		if (length == content.size())
+			content.resize(content.size() * 2);
+
+		DWORD available = static_cast<DWORD>(std::min(content.size() - length, MAX_READ_SIZE));
+		DWORD read = 0;
+
+		if (!::ReadFile(file.get(), &content[length], available, &read, nullptr))
+			throwLastError(TXT("Failed to read from file"), filename);
+
+		if (read == 0)
+			break;
+
+		length += read;
+	}
+
+	content.resize(length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The LineReader used to read the lines of a file read into memory.
+
+class ContentReader : public LineReader
+{
+public:
+	//! Construction from the file contents, which are taken over.
+	explicit ContentReader(std::vector<char>& content)
+		: m_content()
+		, m_read(false)
+	{
+		m_content.swap(content);
+	}
+
+private:
+	//
+	// Members.
+	//
+	std::vector<char>	m_content;	//!< The file contents.
+	bool				m_read;		//!< Has the content been returned?
+
+	//! Get the next block, which is the entire content.
+	virtual bool nextBlock(const char*& begin, const char*& end)
+	{
+		if (m_read || m_content.empty())
+			return false;
+
+		m_read = true;
+
+		begin = &m_content.front();
+		end = begin + m_content.size();
+
+		return true;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the files to read, number of threads, the maximum number
+//! of files read ahead of the consumer and the order they are returned in. If
+//! the number of threads is zero one is used per processor. The workers start
+//! reading immediately.
+
+BatchFileReader::BatchFileReader(const Filenames& filenames, size_t threads, size_t maxPending, Order order)
+	: m_filenames(filenames)
+	, m_order(order)
+	, m_nextFile(0)
+	, m_returned(0)
+	, m_stopping(0)
+	, m_slots(static_cast<long>(std::min<size_t>(maxPending, LONG_MAX)), LONG_MAX)
+	, m_lock()
+	, m_completed()
+	, m_fileReady(Event::AUTO_RESET)
+	, m_threads()
+{
+	if (maxPending == 0)
+		throw InvalidArgException(TXT("The maximum number of pending files cannot be zero"));
+
+	if (threads == 0)
+		threads = Thread::processorCount();
+
+	try
+	{
+		for (size_t i = 0; i != std::min(threads, m_filenames.size()); ++i)
+			m_threads.push_back(ThreadPtr(new Thread(worker, this)));
+	}
+	catch (...)
+	{
+		stop();
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. Any reads in progress are completed before the workers stop.
+
+BatchFileReader::~BatchFileReader()
+{
+	stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the next file to be read, if there is one, waiting for a worker to
+//! finish reading it if necessary. Files are returned in the order their
+//! reads complete, unless ORDERED, when files which complete early are held
+//! back. As the workers take the files in order, the next file is always
+//! being read or has been read, and so holding files back cannot exhaust the
+//! read ahead. If a file could not be read the exception is rethrown, with
+//! its original type, when the file would have been returned; the remaining
+//! files can still be read by calling this method again.
+
+bool BatchFileReader::nextFile(size_t& index, LineReaderPtr& lines)
+{
+	if (m_returned == m_filenames.size())
+		return false;
+
+	CharBuffer        content;
+	bool              failed = false;
+	CapturedException failure;
+
+	for (;;)
+	{
+		{
+			AutoLock lock(m_lock);
+
+			CompletedFiles::iterator it = m_completed.begin();
+
+			if (m_order == ORDERED)
+			{
+				while ( (it != m_completed.end()) && (it->m_index != m_returned) )
+					++it;
+			}
+
+			if (it != m_completed.end())
+			{
+				index = it->m_index;
+				content.swap(it->m_content);
+				failed = it->m_failed;
+				failure = it->m_failure;
+
+				m_completed.erase(it);
+				break;
+			}
+		}
+
+		m_fileReady.wait();
+	}
+
+	++m_returned;
+
+	m_slots.release();
+
+	if (failed)
+		failure.rethrow();
+
+	lines = LineReaderPtr(new ContentReader(content));
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read files until there are none left or the reader is destroyed. A worker
+//! must take a slot before reading a file, which limits how far the workers
+//! can get ahead of the consumer.
+
+void BatchFileReader::readFiles()
+{
+	const size_t count = m_filenames.size();
+
+	for (;;)
+	{
+		m_slots.wait();
+
+		if (m_stopping != 0)
+			break;
+
+		const size_t index = static_cast<size_t>(atomicIncrement(m_nextFile) - 1);
+
+		// Let any other waiting workers see that there are no files left.
+		if (index >= count)
+		{
+			m_slots.release();
+			break;
+		}
+
+		CharBuffer        content;
+		bool              failed = false;
+		CapturedException failure;
+
+		try
+		{
+			readWholeFile(m_filenames[index], content);
+		}
+		catch (...)
+		{
+			failure.capture();
+			failed = true;
+		}
+
+		{
+			AutoLock lock(m_lock);
+
+			m_completed.push_back(Completed());
+
+			Completed& file = m_completed.back();
+
+			file.m_index = index;
+			file.m_content.swap(content);
+			file.m_failed = failed;
+			file.m_failure = failure;
+		}
+
+		m_fileReady.signal();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Stop the worker threads. Each worker waiting for a slot is given one so
+//! that it can see that it needs to stop.
+
+void BatchFileReader::stop()
+{
+	atomicIncrement(m_stopping);
+
+	if (!m_threads.empty())
+		m_slots.release(static_cast<long>(m_threads.size()));
+
+	m_threads.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The worker thread function.
+
+void BatchFileReader::worker(void* param)
+{
+	static_cast<BatchFileReader*>(param)->readFiles();
+}
+
+//namespace Core
+}
@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   BatchFileReader.hpp
+//! \brief  The BatchFileReader class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_BATCHFILEREADER_HPP
+#define CORE_BATCHFILEREADER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include <deque>
+#include "LineReader.hpp"
+#include "CriticalSection.hpp"
+#include "Event.hpp"
+#include "Semaphore.hpp"
+#include "Thread.hpp"
+#include "CapturedException.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Reads the contents of many files concurrently using a pool of threads. Each
+//! file is opened and read whole into a buffer by a worker thread and is then
+//! returned, either in the order the reads complete or in the order given,
+//! with a LineReader over the buffer. The number of files read but not yet
+//! returned is bounded to limit the memory used when the consumer is the
+//! bottleneck.
+
+class BatchFileReader /*: private NotCopyable*/
+{
+public:
+	//! The collection of files to read.
+	typedef std::vector<tstring> Filenames;
+
+	//! The order in which files are returned.
+	enum Order
+	{
+		UNORDERED,	//!< Return files as soon as they have been read.
+		ORDERED,	//!< Return files in the order they were given.
+	};
+
+	//! The default maximum number of files read ahead of the consumer.
+	static const size_t DEFAULT_MAX_PENDING = 64;
+
+public:
+	//! Construction from the files to read, number of threads, read ahead and order.
+	BatchFileReader(const Filenames& filenames, size_t threads = 0, size_t maxPending = DEFAULT_MAX_PENDING, Order order = UNORDERED); // throw(InvalidArgException, RuntimeException)
+
+	//! Destructor.
+	~BatchFileReader();
+
+	//
+	// Properties.
+	//
+
+	//! Get the number of files to read.
+	size_t fileCount() const;
+
+	//! Get the name of a file.
+	const tstring& filename(size_t index) const;
+
+	//
+	// Methods.
+	//
+
+	//! Get the next file to be read, if there is one.
+	bool nextFile(size_t& index, LineReaderPtr& lines); // throw(Exception)
+
+private:
+	//! A buffer of characters.
+	typedef std::vector<char> CharBuffer;
+
+	//! A file that has been read by a worker thread.
+	struct Completed
+	{
+		size_t				m_index;	//!< The index of the file.
+		CharBuffer			m_content;	//!< The file contents.
+		bool				m_failed;	//!< Did reading the file fail?
+		CapturedException	m_failure;	//!< The exception thrown by the failed read.
+	};
+
+	//! The queue of files waiting to be returned.
+	typedef std::deque<Completed> CompletedFiles;
+	//! The smart pointer type for a worker thread.
+	typedef SharedPtr<Thread> ThreadPtr;
+	//! The collection of worker threads.
+	typedef std::vector<ThreadPtr> Threads;
+
+	//
+	// Members.
+	//
+	Filenames		m_filenames;	//!< The files to read.
+	Order			m_order;		//!< The order in which files are returned.
+	long			m_nextFile;		//!< The next file to be read.
+	size_t			m_returned;		//!< The number of files returned.
+	long			m_stopping;		//!< Should the workers stop?
+	Semaphore		m_slots;		//!< The number of files that can be read ahead.
+	CriticalSection	m_lock;			//!< The lock for the completed files.
+	CompletedFiles	m_completed;	//!< The files waiting to be returned.
+	Event			m_fileReady;	//!< Signalled when a file has been read.
+	Threads			m_threads;		//!< The worker threads.
+
+	//
+	// Internal methods.
+	//
+
+	//! Read files until there are none left or the reader is destroyed.
+	void readFiles();
+
+	//! Stop the worker threads.
+	void stop();
+
+	//! The worker thread function.
+	static void worker(void* param);
+
+	// NotCopyable.
+	BatchFileReader(const BatchFileReader&);
+	BatchFileReader& operator=(const BatchFileReader&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of files to read.
+
+inline size_t BatchFileReader::fileCount() const
+{
+	return m_filenames.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the name of a file.
+
+inline const tstring& BatchFileReader::filename(size_t index) const
+{
+	return m_filenames.at(index);
+}
+
+//namespace Core
+}
+
+#endif // CORE_BATCHFILEREADER_HPP
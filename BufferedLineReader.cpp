@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   BufferedLineReader.cpp
+//! \brief  The BufferedLineReader class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "BufferedLineReader.hpp"
+#include "InvalidArgException.hpp"
+#include "FileSystemException.hpp"
+#include "AnsiWide.hpp"
+#include "StringUtils.hpp"
+#include <io.h>
+#include <limits.h>
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The largest number of bytes that can be requested by a single _read().
+
+static const size_t MAX_BLOCK_SIZE = INT_MAX;
+
+////////////////////////////////////////////////////////////////////////////////
+//! Validate the block size.
+
+static size_t validateBlockSize(size_t blockSize)
+{
+	if (blockSize == 0)
+		throw InvalidArgException(TXT("The block size cannot be zero"));
+
+	return std::min(blockSize, MAX_BLOCK_SIZE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a CRT file descriptor, e.g. _fileno(stdin). A descriptor
+//! opened in text mode will have had any CRs removed by the CRT.
+
+BufferedLineReader::BufferedLineReader(int fd, size_t blockSize)
+	: m_fd(fd)
+	, m_stream(nullptr)
+	, m_buffer(validateBlockSize(blockSize))
+{
+	if (m_fd < 0)
+		throw InvalidArgException(TXT("Invalid file descriptor"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a byte stream. The stream should be opened in binary
+//! mode as both LF and CRLF line terminators are handled.
+
+BufferedLineReader::BufferedLineReader(std::istream& stream, size_t blockSize)
+	: m_fd(-1)
+	, m_stream(&stream)
+	, m_buffer(validateBlockSize(blockSize))
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+BufferedLineReader::~BufferedLineReader()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the next block of characters, if there is one. The block overwrites
+//! the previous one. A pipe may return less than a full block, as only the
+//! characters that have already arrived are taken, so that a line can be
+//! processed without waiting for the rest of the block to be filled.
+
+bool BufferedLineReader::nextBlock(const char*& begin, const char*& end)
+{
+	char*  buffer = &m_buffer.front();
+	size_t count = 0;
+
+	if (m_stream != nullptr)
+	{
+		count = static_cast<size_t>(m_stream->readsome(buffer, m_buffer.size()));
+
+		// Nothing buffered, so wait for the next character.
+		if ( (count == 0) && !m_stream->bad() )
+		{
+			const std::istream::int_type next = m_stream->get();
+
+			if (next != std::istream::traits_type::eof())
+			{
+				buffer[count++] = std::istream::traits_type::to_char_type(next);
+				count += static_cast<size_t>(m_stream->readsome(buffer + count, m_buffer.size() - count));
+			}
+		}
+
+		if (m_stream->bad())
+			throw FileSystemException(TXT("Failed to read from the stream"));
+	}
+	else
+	{
+		int result = ::_read(m_fd, buffer, static_cast<uint>(m_buffer.size()));
+
+		if (result < 0)
+		{
+			int     errorCode = errno;
+			tstring errorText = A2T(strerror(errorCode));
+
+			throw FileSystemException(Core::fmt(TXT("Failed to read from file descriptor %d [%d - %s]"), m_fd, errorCode, errorText.c_str()));
+		}
+
+		count = result;
+	}
+
+	if (count == 0)
+		return false;
+
+	begin = buffer;
+	end = buffer + count;
+
+	return true;
+}
+
+//namespace Core
+}
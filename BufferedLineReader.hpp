@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   BufferedLineReader.hpp
+//! \brief  The BufferedLineReader class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_BUFFEREDLINEREADER_HPP
+#define CORE_BUFFEREDLINEREADER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "LineReader.hpp"
+#include <istream>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A LineReader that reads large blocks from a CRT file descriptor or a byte
+//! stream into a single buffer. This is for sources that cannot be mapped,
+//! such as pipes and the standard input. The descriptor or stream must remain
+//! valid for the reader's lifetime.
+
+class BufferedLineReader : public LineReader
+{
+public:
+	//! The default number of bytes read at a time.
+	static const size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+public:
+	//! Construction from a CRT file descriptor, e.g. _fileno(stdin).
+	explicit BufferedLineReader(int fd, size_t blockSize = DEFAULT_BLOCK_SIZE); // throw(InvalidArgException)
+
+	//! Construction from a byte stream.
+	explicit BufferedLineReader(std::istream& stream, size_t blockSize = DEFAULT_BLOCK_SIZE); // throw(InvalidArgException)
+
+	//! Destructor.
+	virtual ~BufferedLineReader();
+
+private:
+	//! The block buffer type.
+	typedef std::vector<char> Buffer;
+
+	//
+	// Members.
+	//
+	int				m_fd;		//!< The file descriptor, or -1 if using a stream.
+	std::istream*	m_stream;	//!< The stream, or null if using a file descriptor.
+	Buffer			m_buffer;	//!< The block buffer.
+
+	//
+	// LineReader methods.
+	//
+
+	//! Get the next block of characters, if there is one.
+	virtual bool nextBlock(const char*& begin, const char*& end); // throw(FileSystemException)
+};
+
+//namespace Core
+}
+
+#endif // CORE_BUFFEREDLINEREADER_HPP
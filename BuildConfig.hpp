@@ -87,6 +87,14 @@
 
 //#define _STLP_VERBOSE_AUTO_LINK	//!< Display the linkage type.
 
+////////////////////////////////////////////////////////////////////////////////
+// Optional third-party libraries. These are enabled by defining the symbol in
+// the project settings, in which case the application must also link with the
+// library.
+
+//#define CORE_USE_ZLIB				//!< Decompress gzip files with zlib.
+//#define CORE_USE_ZSTD				//!< Decompress zstd files with libzstd.
+
 ////////////////////////////////////////////////////////////////////////////////
 // Attributes.
 
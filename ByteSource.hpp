@@ -0,0 +1,39 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ByteSource.hpp
+//! \brief  The ByteSource class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_BYTESOURCE_HPP
+#define CORE_BYTESOURCE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "SharedPtr.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The interface for a sequential source of bytes, such as a file or the
+//! output of a decompressor, which can be read in blocks.
+
+class ByteSource
+{
+public:
+	//! Destructor.
+	virtual ~ByteSource() {}
+
+	//! Read up to the given number of bytes, returning 0 at the end.
+	virtual size_t read(char* buffer, size_t size) = 0;
+};
+
+//! The default ByteSource smart-pointer type.
+typedef SharedPtr<ByteSource> ByteSourcePtr;
+
+//namespace Core
+}
+
+#endif // CORE_BYTESOURCE_HPP
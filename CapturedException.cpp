@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   CapturedException.cpp
+//! \brief  The CapturedException class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "CapturedException.hpp"
+#include "BadLogicException.hpp"
+#include "CmdLineException.hpp"
+#include "ConfigurationException.hpp"
+#include "FileSystemException.hpp"
+#include "InvalidArgException.hpp"
+#include "NotImplException.hpp"
+#include "NullPtrException.hpp"
+#include "ParseException.hpp"
+#include "RuntimeException.hpp"
+#include "AnsiWide.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Throw the exception as its original type.
+
+template<typename T>
+static void throwAs(const Exception& exception)
+{
+	throw static_cast<const T&>(exception);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+CapturedException::CapturedException()
+	: m_exception()
+	, m_thrower(nullptr)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+CapturedException::~CapturedException()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the details of the captured exception.
+
+const tchar* CapturedException::twhat() const
+{
+	ASSERT(isCaptured());
+
+	return m_exception->twhat();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Store a copy of the exception along with the function that throws it.
+
+template<typename T>
+void CapturedException::store(const T& exception)
+{
+	m_exception.reset(new T(exception));
+	m_thrower = throwAs<T>;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Capture the exception currently being handled. This must only be called
+//! from within a catch block. Any previously captured exception is replaced.
+
+void CapturedException::capture()
+{
+	try
+	{
+		throw;
+	}
+	catch (const BadLogicException& e)
+	{
+		store(e);
+	}
+	catch (const CmdLineException& e)
+	{
+		store(e);
+	}
+	catch (const ConfigurationException& e)
+	{
+		store(e);
+	}
+	catch (const FileSystemException& e)
+	{
+		store(e);
+	}
+	catch (const InvalidArgException& e)
+	{
+		store(e);
+	}
+	catch (const NotImplException& e)
+	{
+		store(e);
+	}
+	catch (const NullPtrException& e)
+	{
+		store(e);
+	}
+	catch (const ParseException& e)
+	{
+		store(e);
+	}
+	catch (const RuntimeException& e)
+	{
+		store(e);
+	}
+	catch (const Exception& e)
+	{
+		store(RuntimeException(e.twhat()));
+	}
+	catch (const std::exception& e)
+	{
+		store(RuntimeException(A2T(e.what())));
+	}
+	catch (...)
+	{
+		store(RuntimeException(TXT("Unknown exception")));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Throw a copy of the captured exception with its original type.
+
+void CapturedException::rethrow() const
+{
+	ASSERT(isCaptured());
+
+	m_thrower(*m_exception);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Discard the captured exception.
+
+void CapturedException::reset()
+{
+	m_exception.reset();
+	m_thrower = nullptr;
+}
+
+//namespace Core
+}
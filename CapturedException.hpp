@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   CapturedException.hpp
+//! \brief  The CapturedException class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_CAPTUREDEXCEPTION_HPP
+#define CORE_CAPTUREDEXCEPTION_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Exception.hpp"
+#include "SharedPtr.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Holds a copy of a caught exception so that it can be rethrown later, such
+//! as on another thread. The Core exception types are rethrown with their
+//! original type. Any other exception is rethrown as a RuntimeException with
+//! the same details.
+
+class CapturedException
+{
+public:
+	//! Default constructor.
+	CapturedException();
+
+	//! Destructor.
+	~CapturedException();
+
+	//
+	// Properties.
+	//
+
+	//! Query if an exception has been captured.
+	bool isCaptured() const;
+
+	//! Get the details of the captured exception.
+	const tchar* twhat() const;
+
+	//
+	// Methods.
+	//
+
+	//! Capture the exception currently being handled.
+	void capture();
+
+	//! Throw a copy of the captured exception.
+	void rethrow() const; // throw(Exception)
+
+	//! Discard the captured exception.
+	void reset();
+
+private:
+	//! The function used to throw a copy with its original type.
+	typedef void (*Thrower)(const Exception& exception);
+
+	//
+	// Members.
+	//
+	SharedPtr<Exception>	m_exception;	//!< The copy of the exception.
+	Thrower					m_thrower;		//!< Throws the copy as its original type.
+
+	//
+	// Internal methods.
+	//
+
+	//! Store a copy of the exception.
+	template<typename T>
+	void store(const T& exception);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if an exception has been captured.
+
+inline bool CapturedException::isCaptured() const
+{
+	return (m_exception.get() != nullptr);
+}
+
+//namespace Core
+}
+
+#endif // CORE_CAPTUREDEXCEPTION_HPP
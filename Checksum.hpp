@@ -0,0 +1,25 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Checksum.hpp
+//! \brief  Checksum functions.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_CHECKSUM_HPP
+#define CORE_CHECKSUM_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+// Calculate the CRC-32 of a block of bytes.
+
+uint crc32(const void* data, size_t size, uint crc = 0);
+
+//namespace Core
+}
+
+#endif // CORE_CHECKSUM_HPP
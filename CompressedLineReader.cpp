@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   CompressedLineReader.cpp
+//! \brief  The CompressedLineReader class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "CompressedLineReader.hpp"
+#include "InvalidArgException.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the file to read and the block size.
+
+CompressedLineReader::CompressedLineReader(const tstring& filename, size_t blockSize)
+	: m_decompressor(filename)
+	, m_buffer()
+{
+	if (blockSize == 0)
+		throw InvalidArgException(TXT("The block size cannot be zero"));
+
+	m_buffer.resize(blockSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+CompressedLineReader::~CompressedLineReader()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the next block of characters, if there is one. The block overwrites
+//! the previous one.
+
+bool CompressedLineReader::nextBlock(const char*& begin, const char*& end)
+{
+	const size_t read = m_decompressor.read(&m_buffer.front(), m_buffer.size());
+
+	if (read == 0)
+		return false;
+
+	begin = &m_buffer.front();
+	end = begin + read;
+
+	return true;
+}
+
+//namespace Core
+}
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   CompressedLineReader.hpp
+//! \brief  The CompressedLineReader class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_COMPRESSEDLINEREADER_HPP
+#define CORE_COMPRESSEDLINEREADER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include "LineReader.hpp"
+#include "Decompressor.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A LineReader for files which may be compressed with gzip or zstd. The file
+//! is decompressed in large blocks on the reading thread. To decompress on a
+//! background thread instead, so that it overlaps with processing the lines,
+//! use a ReadAheadLineReader with a Decompressor as its source.
+
+class CompressedLineReader : public LineReader
+{
+public:
+	//! The default number of decompressed bytes per block.
+	static const size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+public:
+	//! Construction from the file to read and the block size.
+	explicit CompressedLineReader(const tstring& filename, size_t blockSize = DEFAULT_BLOCK_SIZE); // throw(FileSystemException, NotImplException, InvalidArgException)
+
+	//! Destructor.
+	virtual ~CompressedLineReader();
+
+	//
+	// Properties.
+	//
+
+	//! Get the format of the file.
+	Decompressor::Format format() const;
+
+private:
+	//
+	// Members.
+	//
+	Decompressor		m_decompressor;	//!< The file decompressor.
+	std::vector<char>	m_buffer;		//!< The decompressed block.
+
+	//
+	// LineReader methods.
+	//
+
+	//! Get the next block of characters, if there is one.
+	virtual bool nextBlock(const char*& begin, const char*& end); // throw(FileSystemException)
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the format of the file.
+
+inline Decompressor::Format CompressedLineReader::format() const
+{
+	return m_decompressor.format();
+}
+
+//namespace Core
+}
+
+#endif // CORE_COMPRESSEDLINEREADER_HPP
@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   CriticalSection.cpp
+//! \brief  The CriticalSection class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "CriticalSection.hpp"
+#include <windows.h>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+CriticalSection::CriticalSection()
+	: m_section(new CRITICAL_SECTION)
+{
+	::InitializeCriticalSection(static_cast<CRITICAL_SECTION*>(m_section));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+CriticalSection::~CriticalSection()
+{
+	CRITICAL_SECTION* section = static_cast<CRITICAL_SECTION*>(m_section);
+
+	::DeleteCriticalSection(section);
+
+	delete section;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Acquire the lock, waiting if it is held by another thread.
+
+void CriticalSection::enter()
+{
+	::EnterCriticalSection(static_cast<CRITICAL_SECTION*>(m_section));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Release the lock.
+
+void CriticalSection::leave()
+{
+	::LeaveCriticalSection(static_cast<CRITICAL_SECTION*>(m_section));
+}
+
+//namespace Core
+}
@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   CriticalSection.hpp
+//! \brief  The CriticalSection and AutoLock class declarations.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_CRITICALSECTION_HPP
+#define CORE_CRITICALSECTION_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A lock used to serialise access to shared state between the threads of a
+//! single process. The lock can be re-entered by the thread that holds it.
+
+class CriticalSection /*: private NotCopyable*/
+{
+public:
+	//! Default constructor.
+	CriticalSection();
+
+	//! Destructor.
+	~CriticalSection();
+
+	//
+	// Methods.
+	//
+
+	//! Acquire the lock, waiting if it is held by another thread.
+	void enter();
+
+	//! Release the lock.
+	void leave();
+
+private:
+	//
+	// Members.
+	//
+	void*	m_section;	//!< The underlying CRITICAL_SECTION.
+
+	// NotCopyable.
+	CriticalSection(const CriticalSection&);
+	CriticalSection& operator=(const CriticalSection&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Helper class to hold a lock for the lifetime of a scope.
+
+class AutoLock /*: private NotCopyable*/
+{
+public:
+	//! Acquire the lock.
+	explicit AutoLock(CriticalSection& lock);
+
+	//! Release the lock.
+	~AutoLock();
+
+private:
+	//
+	// Members.
+	//
+	CriticalSection&	m_lock;		//!< The lock being held.
+
+	// NotCopyable.
+	AutoLock(const AutoLock&);
+	AutoLock& operator=(const AutoLock&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Acquire the lock.
+
+inline AutoLock::AutoLock(CriticalSection& lock)
+	: m_lock(lock)
+{
+	m_lock.enter();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Release the lock.
+
+inline AutoLock::~AutoLock()
+{
+	m_lock.leave();
+}
+
+//namespace Core
+}
+
+#endif // CORE_CRITICALSECTION_HPP
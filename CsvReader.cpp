@@ -0,0 +1,300 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   CsvReader.cpp
+//! \brief  The CsvReader class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "CsvReader.hpp"
+#include "AnsiWide.hpp"
+#include "FileSystemException.hpp"
+#include "InvalidArgException.hpp"
+#include "ParseException.hpp"
+#include "StringUtils.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a stream, separator, flags and quoting characters. The
+//! stream must outlive the reader.
+
+CsvReader::CsvReader(tistream& stream, tchar separator, uint flags, tchar quote, tchar escape, size_t chunkSize)
+	: m_file()
+	, m_stream(stream)
+	, m_separator(separator)
+	, m_flags(flags)
+	, m_quote(quote)
+	, m_escape(escape)
+	, m_buffer(chunkSize)
+	, m_begin(0)
+	, m_end(0)
+	, m_eof(false)
+	, m_escaped()
+{
+	validate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a file, separator, flags and quoting characters. The file
+//! is opened in binary mode as line endings are handled by the reader.
+
+CsvReader::CsvReader(const tstring& filename, tchar separator, uint flags, tchar quote, tchar escape, size_t chunkSize)
+	: m_file(new tifstream(T2A(filename), std::ios::in | std::ios::binary))
+	, m_stream(*m_file)
+	, m_separator(separator)
+	, m_flags(flags)
+	, m_quote(quote)
+	, m_escape(escape)
+	, m_buffer(chunkSize)
+	, m_begin(0)
+	, m_end(0)
+	, m_eof(false)
+	, m_escaped()
+{
+	if (!m_file->is_open())
+		throw FileSystemException(Core::fmt(TXT("Failed to open file '%s'"), filename.c_str()));
+
+	validate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+CsvReader::~CsvReader()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the next record. The fields are only valid until the next record is
+//! read. Returns false when the end of the stream has been reached.
+
+bool CsvReader::readRecord(Fields& fields)
+{
+	for (;;)
+	{
+		if ( (m_begin == m_end) && m_eof )
+			return false;
+
+		size_t next = m_begin;
+
+		if (parseRecord(fields, next))
+		{
+			for (Indices::const_iterator it = m_escaped.begin(); it != m_escaped.end(); ++it)
+				unescape(fields[*it]);
+
+			m_begin = next;
+
+			return true;
+		}
+
+		readChunk();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Validate the construction parameters.
+
+void CsvReader::validate() const
+{
+	if (m_buffer.empty())
+		throw InvalidArgException(TXT("The chunk size cannot be zero"));
+
+	if (m_flags & Tokeniser::RETURN_SEPS)
+		throw InvalidArgException(TXT("Returning separators is not supported by the CsvReader"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Try and parse a whole record from the buffer. Returns false if the record
+//! is incomplete and more of the stream needs to be read first. Unquoted
+//! fields are found with a simple scan for the separator or newline, which is
+//! the common case, and only quoted fields need any further inspection.
+
+bool CsvReader::parseRecord(Fields& fields, size_t& next)
+{
+	const bool   quoting = ((m_flags & Tokeniser::QUOTED_FIELDS) != 0);
+	const bool   merging = ((m_flags & Tokeniser::MERGE_SEPS) != 0);
+	const tchar* buffer = &m_buffer[0];
+	const tchar* it = buffer + m_begin;
+	const tchar* end = buffer + m_end;
+
+	fields.clear();
+	m_escaped.clear();
+
+	for (;;)
+	{
+		const tchar* first = it;
+		const tchar* last = it;
+		bool         quoted = false;
+
+		// Quoted value?
+		if ( quoting && (it != end) && (*it == m_quote) )
+		{
+			bool escaped = false;
+
+			first = ++it;
+
+			for (;;)
+			{
+				// Find next quote or escape character.
+				while ( (it != end) && (*it != m_quote) && (*it != m_escape) )
+					++it;
+
+				if (it == end)
+				{
+					if (m_eof)
+						throw ParseException(TXT("Unterminated quoted value"));
+
+					return false;
+				}
+
+				const tchar* peek = it + 1;
+
+				if ( (peek == end) && !m_eof )
+					return false;
+
+				// Escaped character?
+				if ( (peek != end) && ( ((*it == m_escape) && (m_escape != m_quote))
+									 || ((*peek == m_quote) && (m_escape == m_quote)) ) )
+				{
+					escaped = true;
+					it = peek + 1;
+				}
+				// Closing quote?
+				else if (*it == m_quote)
+				{
+					last = it;
+					it = peek;
+					break;
+				}
+				else
+				{
+					throw ParseException(TXT("Unterminated quoted value"));
+				}
+			}
+
+			if (escaped)
+				m_escaped.push_back(fields.size());
+
+			quoted = true;
+		}
+		// Unquoted value.
+		else
+		{
+			while ( (it != end) && (*it != m_separator) && (*it != TXT('\n')) )
+				++it;
+
+			last = it;
+		}
+
+		// Reached the end of the buffer?
+		if (it == end)
+		{
+			if (!m_eof)
+				return false;
+
+			if ( !quoted && (last != first) && (*(last-1) == TXT('\r')) )
+				--last;
+
+			fields.push_back(TextRange(first, last));
+			break;
+		}
+
+		// Stopped on a separator?
+		if (*it == m_separator)
+		{
+			fields.push_back(TextRange(first, last));
+
+			++it;
+
+			// Merge consecutive separators?
+			if (merging)
+			{
+				while ( (it != end) && (*it == m_separator) )
+					++it;
+
+				if ( (it == end) && !m_eof )
+					return false;
+			}
+
+			continue;
+		}
+
+		// Allow for a CR/LF pair after a quoted value.
+		if ( quoted && (*it == TXT('\r')) )
+		{
+			if ( (it+1 == end) && !m_eof )
+				return false;
+
+			if ( (it+1 != end) && (*(it+1) == TXT('\n')) )
+				++it;
+		}
+
+		if (*it != TXT('\n'))
+			throw ParseException(Core::fmt(TXT("Unexpected character '%c' after closing quote"), *it));
+
+		if ( !quoted && (last != first) && (*(last-1) == TXT('\r')) )
+			--last;
+
+		fields.push_back(TextRange(first, last));
+
+		++it;
+		break;
+	}
+
+	next = it - buffer;
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the next chunk from the stream. Any partial record is moved to the
+//! front of the buffer first, which is the only time the text is copied. The
+//! buffer is only grown when a single record is larger than it.
+
+void CsvReader::readChunk()
+{
+	ASSERT(!m_eof);
+
+	if (m_begin != 0)
+	{
+		std::copy(m_buffer.begin() + m_begin, m_buffer.begin() + m_end, m_buffer.begin());
+
+		m_end  -= m_begin;
+		m_begin = 0;
+	}
+
+	if (m_end == m_buffer.size())
+		m_buffer.resize(m_buffer.size() * 2);
+
+	m_stream.read(&m_buffer[m_end], static_cast<std::streamsize>(m_buffer.size() - m_end));
+
+	m_end += static_cast<size_t>(m_stream.gcount());
+
+	if (!m_stream)
+		m_eof = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Remove the escape characters from a quoted value. As the result is never
+//! longer than the original the value is unescaped in place.
+
+void CsvReader::unescape(TextRange& field)
+{
+	tchar*       output = &m_buffer[0] + (field.begin() - &m_buffer[0]);
+	const tchar* begin = output;
+	const tchar* it = field.begin();
+	const tchar* end = field.end();
+
+	while (it != end)
+	{
+		if ( ((*it == m_escape) || (*it == m_quote)) && (it+1 != end) )
+			++it;
+
+		*output++ = *it++;
+	}
+
+	field = TextRange(begin, output);
+}
+
+//namespace Core
+}
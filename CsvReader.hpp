@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   CsvReader.hpp
+//! \brief  The CsvReader class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_CSVREADER_HPP
+#define CORE_CSVREADER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include "Range.hpp"
+#include "Tokeniser.hpp"
+#include "UniquePtr.hpp"
+#include "tfstream.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A class to read the records of a CSV (or TSV) file or stream. The input is
+//! read in large chunks and each record is returned as a collection of views
+//! onto the chunk so that fields are not copied. Quoted values (RFC 4180) may
+//! contain separators, escaped quotes and newlines. The separator handling is
+//! controlled using the Tokeniser flags, although RETURN_SEPS is not supported.
+
+class CsvReader /*: private NotCopyable*/
+{
+public:
+	//! The fields of a single record.
+	typedef std::vector<TextRange> Fields;
+
+	//! The default number of characters read from the stream at a time.
+	static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+public:
+	//! Construction from a stream, separator, flags and quoting characters.
+	CsvReader(tistream& stream, tchar separator = TXT(','), uint flags = Tokeniser::QUOTED_FIELDS,
+				tchar quote = TXT('"'), tchar escape = TXT('"'), size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+	//! Construction from a file, separator, flags and quoting characters.
+	CsvReader(const tstring& filename, tchar separator = TXT(','), uint flags = Tokeniser::QUOTED_FIELDS,
+				tchar quote = TXT('"'), tchar escape = TXT('"'), size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+	//! Destructor.
+	~CsvReader();
+
+	//
+	// Methods.
+	//
+
+	//! Read the next record.
+	bool readRecord(Fields& fields); // throw(ParseException)
+
+private:
+	//! The underlying input file stream.
+	typedef UniquePtr<tifstream> StreamPtr;
+	//! The chunk buffer type.
+	typedef std::vector<tchar> Buffer;
+	//! The indices of the fields that need unescaping.
+	typedef std::vector<size_t> Indices;
+
+	//
+	// Members.
+	//
+	StreamPtr	m_file;			//!< The file stream, if we own it.
+	tistream&	m_stream;		//!< The stream being read.
+	tchar		m_separator;	//!< The field separator.
+	uint		m_flags;		//!< The tokenising control flags.
+	tchar		m_quote;		//!< The character used to quote values.
+	tchar		m_escape;		//!< The character used to escape a quote.
+	Buffer		m_buffer;		//!< The chunk buffer.
+	size_t		m_begin;		//!< The start of the unconsumed characters.
+	size_t		m_end;			//!< The end of the valid characters.
+	bool		m_eof;			//!< Have we read the entire stream?
+	Indices		m_escaped;		//!< The fields in the record that need unescaping.
+
+	//
+	// Internal methods.
+	//
+
+	//! Validate the construction parameters.
+	void validate() const;
+
+	//! Try and parse a whole record from the buffer.
+	bool parseRecord(Fields& fields, size_t& next);
+
+	//! Read the next chunk from the stream.
+	void readChunk();
+
+	//! Remove the escape characters from a quoted value.
+	void unescape(TextRange& field);
+
+	// NotCopyable.
+	CsvReader(const CsvReader&);
+	CsvReader& operator=(const CsvReader&);
+};
+
+//namespace Core
+}
+
+#endif // CORE_CSVREADER_HPP
@@ -0,0 +1,383 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Decompressor.cpp
+//! \brief  The Decompressor class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "Decompressor.hpp"
+#include "Win32Error.hpp"
+#include "FileSystemException.hpp"
+#include "InvalidArgException.hpp"
+#include "NotImplException.hpp"
+#include "StringUtils.hpp"
+#include "AnsiWide.hpp"
+#include <windows.h>
+#include <limits.h>
+#include <algorithm>
+
+#ifdef CORE_USE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef CORE_USE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The largest number of bytes that can be passed to the libraries at once.
+
+static const size_t MAX_BLOCK_SIZE = INT_MAX;
+
+////////////////////////////////////////////////////////////////////////////////
+//! The magic bytes at the start of a gzip file.
+
+static const byte GZIP_MAGIC[] = { 0x1F, 0x8B };
+
+////////////////////////////////////////////////////////////////////////////////
+//! The magic bytes at the start of a zstd frame.
+
+static const byte ZSTD_MAGIC[] = { 0x28, 0xB5, 0x2F, 0xFD };
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the buffer starts with the magic bytes.
+
+static bool startsWith(const std::vector<char>& buffer, size_t length, const byte* magic, size_t size)
+{
+	return (length >= size) && (memcmp(&buffer.front(), magic, size) == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the display name for a format.
+
+static const tchar* formatName(Decompressor::Format format)
+{
+	return (format == Decompressor::GZIP) ? TXT("gzip") : TXT("zstd");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the file to read and the input block size. The first
+//! block is read straight away to detect the format.
+
+Decompressor::Decompressor(const tstring& filename, size_t inputSize)
+	: m_filename(filename)
+	, m_file(INVALID_HANDLE_VALUE)
+	, m_format(PLAIN)
+	, m_input()
+	, m_next(0)
+	, m_end(0)
+	, m_eof(false)
+	, m_finished(false)
+	, m_stream(nullptr)
+{
+	if (inputSize == 0)
+		throw InvalidArgException(TXT("The input size cannot be zero"));
+
+	m_input.resize(std::max(std::min(inputSize, MAX_BLOCK_SIZE), sizeof(ZSTD_MAGIC)));
+
+	m_file = ::CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+							OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (m_file == INVALID_HANDLE_VALUE)
+		throwLastError(TXT("Failed to open file"), m_filename);
+
+	try
+	{
+		// Ensure there are enough bytes to check the magic number.
+		while ( !m_eof && (m_end < sizeof(ZSTD_MAGIC)) && (m_end != m_input.size()) )
+		{
+			DWORD read = 0;
+
+			if (!::ReadFile(m_file, &m_input[m_end], static_cast<DWORD>(m_input.size() - m_end), &read, nullptr))
+				throwLastError(TXT("Failed to read from file"), m_filename);
+
+			m_end += read;
+			m_eof = (read == 0);
+		}
+
+		if (startsWith(m_input, m_end, GZIP_MAGIC, sizeof(GZIP_MAGIC)))
+			m_format = GZIP;
+		else if (startsWith(m_input, m_end, ZSTD_MAGIC, sizeof(ZSTD_MAGIC)))
+			m_format = ZSTD;
+
+		if (!isSupported(m_format))
+			throw NotImplException(Core::fmt(TXT("Support for %s compressed files is not enabled in this build: '%s'"), formatName(m_format), m_filename.c_str()));
+
+#ifdef CORE_USE_ZLIB
+		if (m_format == GZIP)
+		{
+			z_stream* stream = new z_stream;
+
+			memset(stream, 0, sizeof(z_stream));
+
+			// Allow for a gzip header.
+			if (::inflateInit2(stream, 15+16) != Z_OK)
+			{
+				delete stream;
+				throw FileSystemException(Core::fmt(TXT("Failed to initialise gzip decompression for file '%s'"), m_filename.c_str()));
+			}
+
+			m_stream = stream;
+		}
+#endif
+
+#ifdef CORE_USE_ZSTD
+		if (m_format == ZSTD)
+		{
+			ZSTD_DStream* stream = ::ZSTD_createDStream();
+
+			if ( (stream == nullptr) || ::ZSTD_isError(::ZSTD_initDStream(stream)) )
+			{
+				::ZSTD_freeDStream(stream);
+				throw FileSystemException(Core::fmt(TXT("Failed to initialise zstd decompression for file '%s'"), m_filename.c_str()));
+			}
+
+			m_stream = stream;
+		}
+#endif
+	}
+	catch (...)
+	{
+		close();
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+Decompressor::~Decompressor()
+{
+	close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read up to the given number of decompressed bytes, returning 0 at the end.
+//! Concatenated gzip members and zstd frames are read as one stream.
+
+size_t Decompressor::read(char* buffer, size_t size)
+{
+	switch (m_format)
+	{
+		case GZIP:	return readGzip(buffer, size);
+		case ZSTD:	return readZstd(buffer, size);
+		case PLAIN:	return readPlain(buffer, size);
+		default:	ASSERT_FALSE();	return 0;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if a format is supported by this build.
+
+bool Decompressor::isSupported(Format format)
+{
+	if (format == GZIP)
+	{
+#ifdef CORE_USE_ZLIB
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	if (format == ZSTD)
+	{
+#ifdef CORE_USE_ZSTD
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Refill the input buffer once it has been used.
+
+void Decompressor::readInput()
+{
+	ASSERT(m_next == m_end);
+
+	DWORD read = 0;
+
+	if (!::ReadFile(m_file, &m_input.front(), static_cast<DWORD>(m_input.size()), &read, nullptr))
+		throwLastError(TXT("Failed to read from file"), m_filename);
+
+	m_next = 0;
+	m_end = read;
+	m_eof = (read == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read from an uncompressed file. Any bytes read to detect the format are
+//! returned first.
+
+size_t Decompressor::readPlain(char* buffer, size_t size)
+{
+	if (m_next != m_end)
+	{
+		const size_t count = std::min(size, m_end - m_next);
+
+		memcpy(buffer, &m_input[m_next], count);
+		m_next += count;
+
+		return count;
+	}
+
+	if (m_eof)
+		return 0;
+
+	DWORD read = 0;
+
+	if (!::ReadFile(m_file, buffer, static_cast<DWORD>(std::min(size, MAX_BLOCK_SIZE)), &read, nullptr))
+		throwLastError(TXT("Failed to read from file"), m_filename);
+
+	m_eof = (read == 0);
+
+	return read;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read from a gzip file.
+
+size_t Decompressor::readGzip(char* buffer, size_t size)
+{
+#ifdef CORE_USE_ZLIB
+	z_stream* stream = static_cast<z_stream*>(m_stream);
+
+	while (!m_finished)
+	{
+		if ( (m_next == m_end) && !m_eof )
+			readInput();
+
+		const size_t available = m_end - m_next;
+		const size_t space = std::min(size, MAX_BLOCK_SIZE);
+
+		stream->next_in = reinterpret_cast<Bytef*>((available != 0) ? &m_input[m_next] : &m_input.front());
+		stream->avail_in = static_cast<uInt>(available);
+		stream->next_out = reinterpret_cast<Bytef*>(buffer);
+		stream->avail_out = static_cast<uInt>(space);
+
+		const int result = ::inflate(stream, Z_NO_FLUSH);
+
+		m_next += available - stream->avail_in;
+
+		const size_t produced = space - stream->avail_out;
+
+		if (result == Z_STREAM_END)
+		{
+			if ( (m_next == m_end) && !m_eof )
+				readInput();
+
+			// Another member follows?
+			if (m_next != m_end)
+				::inflateReset(stream);
+			else
+				m_finished = true;
+		}
+		else if ( (result == Z_BUF_ERROR) && (m_next == m_end) && m_eof )
+		{
+			throw FileSystemException(Core::fmt(TXT("Unexpected end of gzip data in file '%s'"), m_filename.c_str()));
+		}
+		else if ( (result != Z_OK) && (result != Z_BUF_ERROR) )
+		{
+			const tstring message = (stream->msg != nullptr) ? A2T(stream->msg) : TXT("unknown error");
+
+			throw FileSystemException(Core::fmt(TXT("Failed to decompress gzip file '%s' [%s]"), m_filename.c_str(), message.c_str()));
+		}
+
+		if (produced != 0)
+			return produced;
+	}
+
+	return 0;
+#else
+	DEBUG_USE_ONLY(buffer);
+	DEBUG_USE_ONLY(size);
+	ASSERT_FALSE();
+	return 0;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read from a zstd file.
+
+size_t Decompressor::readZstd(char* buffer, size_t size)
+{
+#ifdef CORE_USE_ZSTD
+	ZSTD_DStream* stream = static_cast<ZSTD_DStream*>(m_stream);
+
+	for (;;)
+	{
+		if ( (m_next == m_end) && !m_eof )
+			readInput();
+
+		// Ended on a frame boundary?
+		if ( (m_next == m_end) && m_eof && m_finished )
+			return 0;
+
+		ZSTD_inBuffer  input = { &m_input.front() + m_next, m_end - m_next, 0 };
+		ZSTD_outBuffer output = { buffer, size, 0 };
+
+		const size_t result = ::ZSTD_decompressStream(stream, &output, &input);
+
+		m_next += input.pos;
+
+		if (::ZSTD_isError(result))
+			throw FileSystemException(Core::fmt(TXT("Failed to decompress zstd file '%s' [%s]"), m_filename.c_str(), A2T(::ZSTD_getErrorName(result))));
+
+		// A frame is only complete once it has been fully flushed, after which
+		// the result is the size of the next frame's header instead.
+		m_finished = (result == 0);
+
+		if (output.pos != 0)
+			return output.pos;
+
+		if ( (m_next == m_end) && m_eof && !m_finished )
+			throw FileSystemException(Core::fmt(TXT("Unexpected end of zstd data in file '%s'"), m_filename.c_str()));
+	}
+#else
+	DEBUG_USE_ONLY(buffer);
+	DEBUG_USE_ONLY(size);
+	ASSERT_FALSE();
+	return 0;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Release the decompression stream and close the file.
+
+void Decompressor::close()
+{
+	if (m_stream != nullptr)
+	{
+#ifdef CORE_USE_ZLIB
+		if (m_format == GZIP)
+		{
+			z_stream* stream = static_cast<z_stream*>(m_stream);
+
+			::inflateEnd(stream);
+			delete stream;
+		}
+#endif
+
+#ifdef CORE_USE_ZSTD
+		if (m_format == ZSTD)
+			::ZSTD_freeDStream(static_cast<ZSTD_DStream*>(m_stream));
+#endif
+
+		m_stream = nullptr;
+	}
+
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		::CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+	}
+}
+
+//namespace Core
+}
@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Decompressor.hpp
+//! \brief  The Decompressor class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_DECOMPRESSOR_HPP
+#define CORE_DECOMPRESSOR_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include "ByteSource.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A source of bytes which reads a file that may be compressed. The format is
+//! detected from the magic bytes at the start of the file and the contents are
+//! decompressed as they are read, in blocks. An uncompressed file is passed
+//! through as-is. The gzip and zstd formats are only supported when the build
+//! defines CORE_USE_ZLIB and CORE_USE_ZSTD respectively.
+
+class Decompressor : public ByteSource
+{
+public:
+	//! The compression formats.
+	enum Format
+	{
+		PLAIN,	//!< Not compressed.
+		GZIP,	//!< Compressed with gzip.
+		ZSTD,	//!< Compressed with zstd.
+	};
+
+	//! The default number of compressed bytes read at a time.
+	static const size_t DEFAULT_INPUT_SIZE = 1024 * 1024;
+
+public:
+	//! Construction from the file to read and the input block size.
+	explicit Decompressor(const tstring& filename, size_t inputSize = DEFAULT_INPUT_SIZE); // throw(FileSystemException, NotImplException, InvalidArgException)
+
+	//! Destructor.
+	virtual ~Decompressor();
+
+	//
+	// Properties.
+	//
+
+	//! Get the format of the file.
+	Format format() const;
+
+	//
+	// Methods.
+	//
+
+	//! Read up to the given number of decompressed bytes.
+	virtual size_t read(char* buffer, size_t size); // throw(FileSystemException)
+
+	//
+	// Class methods.
+	//
+
+	//! Query if a format is supported by this build.
+	static bool isSupported(Format format);
+
+private:
+	//! A buffer of characters.
+	typedef std::vector<char> CharBuffer;
+
+	//
+	// Members.
+	//
+	tstring		m_filename;	//!< The file being read.
+	void*		m_file;		//!< The file handle.
+	Format		m_format;	//!< The format of the file.
+	CharBuffer	m_input;	//!< The compressed input buffer.
+	size_t		m_next;		//!< The next unused input byte.
+	size_t		m_end;		//!< The end of the input.
+	bool		m_eof;		//!< Has the end of the file been read?
+	bool		m_finished;	//!< Has the end of the compressed data, or zstd frame, been reached?
+	void*		m_stream;	//!< The decompression library's stream state.
+
+	//
+	// Internal methods.
+	//
+
+	//! Refill the input buffer once it has been used.
+	void readInput();
+
+	//! Read from an uncompressed file.
+	size_t readPlain(char* buffer, size_t size);
+
+	//! Read from a gzip file.
+	size_t readGzip(char* buffer, size_t size);
+
+	//! Read from a zstd file.
+	size_t readZstd(char* buffer, size_t size);
+
+	//! Release the decompression stream and close the file.
+	void close();
+
+	// NotCopyable.
+	Decompressor(const Decompressor&);
+	Decompressor& operator=(const Decompressor&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the format of the file.
+
+inline Decompressor::Format Decompressor::format() const
+{
+	return m_format;
+}
+
+//namespace Core
+}
+
+#endif // CORE_DECOMPRESSOR_HPP
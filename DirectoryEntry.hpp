@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   DirectoryEntry.hpp
+//! \brief  The DirectoryEntry class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_DIRECTORYENTRY_HPP
+#define CORE_DIRECTORYENTRY_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A file or folder found when enumerating a folder. The metadata is returned
+//! by the enumeration itself and so is available without querying each entry
+//! separately.
+
+class DirectoryEntry
+{
+public:
+	//! The attribute for a folder.
+	static const ulong FOLDER_ATTRIBUTE = 0x10;
+	//! The attribute for a reparse point, such as a junction or symbolic link.
+	static const ulong REPARSE_POINT_ATTRIBUTE = 0x400;
+
+public:
+	//! Default constructor.
+	DirectoryEntry();
+
+	//! Construction from the name and metadata.
+	DirectoryEntry(const tchar* name, ulong attributes, ulonglong size, ulonglong lastWriteTime);
+
+	//
+	// Properties.
+	//
+
+	//! Get the name of the entry within its folder.
+	const tstring& name() const;
+
+	//! Query if the entry is a folder.
+	bool isFolder() const;
+
+	//! Query if the entry is a reparse point.
+	bool isReparsePoint() const;
+
+	//! Get the WIN32 file attributes.
+	ulong attributes() const;
+
+	//! Get the size of a file in bytes.
+	ulonglong size() const;
+
+	//! Get the time the entry was last written as a FILETIME value.
+	ulonglong lastWriteTime() const;
+
+private:
+	//
+	// Members.
+	//
+	tstring		m_name;				//!< The name of the entry.
+	ulong		m_attributes;		//!< The WIN32 file attributes.
+	ulonglong	m_size;				//!< The size of the file.
+	ulonglong	m_lastWriteTime;	//!< The last write time.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+inline DirectoryEntry::DirectoryEntry()
+	: m_name()
+	, m_attributes(0)
+	, m_size(0)
+	, m_lastWriteTime(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the name and metadata.
+
+inline DirectoryEntry::DirectoryEntry(const tchar* name, ulong attributes, ulonglong size, ulonglong lastWriteTime)
+	: m_name(name)
+	, m_attributes(attributes)
+	, m_size(size)
+	, m_lastWriteTime(lastWriteTime)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the name of the entry within its folder.
+
+inline const tstring& DirectoryEntry::name() const
+{
+	return m_name;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the entry is a folder.
+
+inline bool DirectoryEntry::isFolder() const
+{
+	return ((m_attributes & FOLDER_ATTRIBUTE) != 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the entry is a reparse point.
+
+inline bool DirectoryEntry::isReparsePoint() const
+{
+	return ((m_attributes & REPARSE_POINT_ATTRIBUTE) != 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the WIN32 file attributes.
+
+inline ulong DirectoryEntry::attributes() const
+{
+	return m_attributes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the size of a file in bytes. This is zero for a folder.
+
+inline ulonglong DirectoryEntry::size() const
+{
+	return m_size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the time the entry was last written as a FILETIME value, i.e. the
+//! number of 100ns intervals since 1st January 1601 (UTC).
+
+inline ulonglong DirectoryEntry::lastWriteTime() const
+{
+	return m_lastWriteTime;
+}
+
+//namespace Core
+}
+
+#endif // CORE_DIRECTORYENTRY_HPP
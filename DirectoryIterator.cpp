@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   DirectoryIterator.cpp
+//! \brief  The DirectoryIterator class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "DirectoryIterator.hpp"
+#include "FileSystem.hpp"
+#include "Win32Error.hpp"
+#include "FileSystemException.hpp"
+#include "StringUtils.hpp"
+#include <windows.h>
+
+#ifndef FIND_FIRST_EX_LARGE_FETCH
+#define FIND_FIRST_EX_LARGE_FETCH	2
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The FindExInfoBasic info level, which skips the 8.3 name (Windows 7+).
+
+static const FINDEX_INFO_LEVELS FIND_INFO_BASIC = static_cast<FINDEX_INFO_LEVELS>(1);
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert the find data into an entry.
+
+static DirectoryEntry toEntry(const WIN32_FIND_DATA& data)
+{
+	const ulonglong size = (static_cast<ulonglong>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+	const ulonglong time = (static_cast<ulonglong>(data.ftLastWriteTime.dwHighDateTime) << 32)
+						 | data.ftLastWriteTime.dwLowDateTime;
+
+	return DirectoryEntry(data.cFileName, data.dwFileAttributes, size, time);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the entry is the "." or ".." pseudo-folder.
+
+static bool isDotEntry(const tstring& name)
+{
+	return (name == TXT(".")) || (name == TXT(".."));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the folder to enumerate and the wildcard to match. The
+//! enumeration asks for the basic information only and for the entries to be
+//! fetched in large batches, falling back to a plain search on versions of
+//! Windows that do not support those options. A missing folder is an error,
+//! but no matches is not.
+
+DirectoryIterator::DirectoryIterator(const tstring& folder, const tstring& mask)
+	: m_folder(folder)
+	, m_find(INVALID_HANDLE_VALUE)
+	, m_next()
+	, m_hasNext(false)
+{
+	const tstring   pattern = combinePaths(folder, mask);
+	WIN32_FIND_DATA data;
+
+	m_find = ::FindFirstFileEx(pattern.c_str(), FIND_INFO_BASIC, &data, FindExSearchNameMatch,
+								nullptr, FIND_FIRST_EX_LARGE_FETCH);
+
+	if ( (m_find == INVALID_HANDLE_VALUE) && (::GetLastError() == ERROR_INVALID_PARAMETER) )
+		m_find = ::FindFirstFileEx(pattern.c_str(), FindExInfoStandard, &data, FindExSearchNameMatch, nullptr, 0);
+
+	if (m_find == INVALID_HANDLE_VALUE)
+	{
+		DWORD errorCode = ::GetLastError();
+
+		if (errorCode == ERROR_FILE_NOT_FOUND)
+			return;
+
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw FileSystemException(Core::fmt(TXT("Failed to find files matching '%s' [0x%08lX - %s]"), pattern.c_str(), errorCode, errorText.c_str()));
+	}
+
+	m_next = toEntry(data);
+	m_hasNext = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+DirectoryIterator::~DirectoryIterator()
+{
+	if (m_find != INVALID_HANDLE_VALUE)
+		::FindClose(m_find);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the next entry, if there is one. The entry after it is fetched ahead
+//! so that the end of the enumeration is known.
+
+bool DirectoryIterator::next(DirectoryEntry& entry)
+{
+	while (m_hasNext)
+	{
+		entry = m_next;
+
+		WIN32_FIND_DATA data;
+
+		if (::FindNextFile(m_find, &data))
+		{
+			m_next = toEntry(data);
+		}
+		else
+		{
+			DWORD errorCode = ::GetLastError();
+
+			if (errorCode != ERROR_NO_MORE_FILES)
+			{
+				tstring errorText = formatWin32ErrorMessage(errorCode);
+
+				throw FileSystemException(Core::fmt(TXT("Failed to enumerate folder '%s' [0x%08lX - %s]"), m_folder.c_str(), errorCode, errorText.c_str()));
+			}
+
+			m_hasNext = false;
+		}
+
+		if (!isDotEntry(entry.name()))
+			return true;
+	}
+
+	return false;
+}
+
+//namespace Core
+}
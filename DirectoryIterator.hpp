@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   DirectoryIterator.hpp
+//! \brief  The DirectoryIterator class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_DIRECTORYITERATOR_HPP
+#define CORE_DIRECTORYITERATOR_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "DirectoryEntry.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Enumerates the entries of a single folder which match a wildcard. The "."
+//! and ".." entries are skipped. The entries are returned in the order the
+//! file system provides them, along with their metadata, so that no entry
+//! needs to be queried separately.
+
+class DirectoryIterator /*: private NotCopyable*/
+{
+public:
+	//! Construction from the folder to enumerate and the wildcard to match.
+	explicit DirectoryIterator(const tstring& folder, const tstring& mask = TXT("*")); // throw(FileSystemException)
+
+	//! Destructor.
+	~DirectoryIterator();
+
+	//
+	// Properties.
+	//
+
+	//! Get the folder being enumerated.
+	const tstring& folder() const;
+
+	//
+	// Methods.
+	//
+
+	//! Get the next entry, if there is one.
+	bool next(DirectoryEntry& entry); // throw(FileSystemException)
+
+private:
+	//
+	// Members.
+	//
+	tstring			m_folder;	//!< The folder being enumerated.
+	void*			m_find;		//!< The find handle.
+	DirectoryEntry	m_next;		//!< The next entry to return.
+	bool			m_hasNext;	//!< Is there another entry?
+
+	// NotCopyable.
+	DirectoryIterator(const DirectoryIterator&);
+	DirectoryIterator& operator=(const DirectoryIterator&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the folder being enumerated.
+
+inline const tstring& DirectoryIterator::folder() const
+{
+	return m_folder;
+}
+
+//namespace Core
+}
+
+#endif // CORE_DIRECTORYITERATOR_HPP
@@ -0,0 +1,344 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   DirectoryWalker.cpp
+//! \brief  The DirectoryWalker class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "DirectoryWalker.hpp"
+#include "DirectoryIterator.hpp"
+#include "FileSystem.hpp"
+#include "FileSystemException.hpp"
+#include "CriticalSection.hpp"
+#include "Semaphore.hpp"
+#include "Interlocked.hpp"
+#include "Thread.hpp"
+#include "SharedPtr.hpp"
+#include "CapturedException.hpp"
+#include <windows.h>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <limits.h>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The state shared between the calling thread and the worker threads.
+
+struct WalkerContext
+{
+	//! The queue of folders.
+	typedef std::vector<tstring> Folders;
+
+	WalkerContext()
+		: m_work(0, LONG_MAX)
+	{
+	}
+
+	DirectoryWalker*			m_walker;		//!< The walker.
+	DirectoryWalker::Handler*	m_handler;		//!< The entry handler.
+	size_t						m_threads;		//!< The number of worker threads.
+	CriticalSection				m_lock;			//!< The lock for the queue and failure.
+	Folders						m_folders;		//!< The folders waiting to be walked.
+	size_t						m_outstanding;	//!< The folders queued or being walked.
+	Semaphore					m_work;			//!< Counts the folders in the queue.
+	CapturedException			m_failure;		//!< The first exception thrown by a worker.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Add a folder to the work queue and wake a worker to walk it.
+
+static void queueFolder(WalkerContext& context, const tstring& folder)
+{
+	{
+		AutoLock lock(context.m_lock);
+
+		context.m_folders.push_back(folder);
+		++context.m_outstanding;
+	}
+
+	context.m_work.release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Record that a folder has been walked. Once the last one has been walked the
+//! queue will stay empty and so all the workers are woken to exit.
+
+static void folderCompleted(WalkerContext& context)
+{
+	bool finished = false;
+
+	{
+		AutoLock lock(context.m_lock);
+
+		finished = (--context.m_outstanding == 0);
+	}
+
+	if (finished)
+		context.m_work.release(static_cast<long>(context.m_threads));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Report the entries of a single folder and queue its sub-folders. If the
+//! folder cannot be enumerated the handler can choose to skip the rest of it,
+//! but a failure in the handler itself is always passed on.
+
+static void walkFolder(WalkerContext& context, const tstring& folder)
+{
+	DirectoryWalker&          walker = *context.m_walker;
+	DirectoryWalker::Handler& handler = *context.m_handler;
+	bool                      enumerating = true;
+
+	try
+	{
+		DirectoryIterator it(folder);
+		DirectoryEntry    entry;
+
+		while (!walker.isCancelled() && it.next(entry))
+		{
+			enumerating = false;
+
+			if (entry.isFolder() && !entry.isReparsePoint() && !handler.prune(folder, entry))
+				queueFolder(context, combinePaths(folder, entry.name()));
+
+			if (handler.filter(folder, entry))
+				handler.processEntry(folder, entry);
+
+			enumerating = true;
+		}
+	}
+	catch (const FileSystemException& exception)
+	{
+		if (!enumerating || !handler.skipFolder(folder, exception))
+			throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the root of the tree and the number of threads. If the
+//! number of threads is zero one is used per processor.
+
+DirectoryWalker::DirectoryWalker(const tstring& root, size_t threads)
+	: m_root(root)
+	, m_threads(threads)
+	, m_cancelled(0)
+{
+	if (m_threads == 0)
+		m_threads = Thread::processorCount();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+DirectoryWalker::~DirectoryWalker()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Walk the tree, reporting every entry below the root that passes the filter.
+//! The root is checked on the calling thread so that a missing root is
+//! reported directly. If a folder cannot be enumerated, and the handler does
+//! not skip it, or the handler throws an exception, the walk is cancelled and
+//! the first failure is rethrown with its original type once all the workers
+//! have finished. Returns false if the
+//! walk was cancelled.
+
+bool DirectoryWalker::walk(Handler& handler)
+{
+	typedef SharedPtr<Thread> ThreadPtr;
+	typedef std::vector<ThreadPtr> Threads;
+
+	// Fail fast if the root cannot be enumerated.
+	{
+		DirectoryIterator root(m_root);
+	}
+
+	WalkerContext context;
+
+	context.m_walker = this;
+	context.m_handler = &handler;
+	context.m_threads = m_threads;
+	context.m_outstanding = 0;
+
+	queueFolder(context, m_root);
+
+	{
+		Threads workers;
+
+		try
+		{
+			for (size_t i = 0; i != m_threads; ++i)
+				workers.push_back(ThreadPtr(new Thread(walkFolders, &context)));
+		}
+		catch (...)
+		{
+			cancel();
+			throw;
+		}
+
+		for (Threads::iterator it = workers.begin(); it != workers.end(); ++it)
+			(*it)->join();
+	}
+
+	if (context.m_failure.isCaptured())
+		context.m_failure.rethrow();
+
+	return !isCancelled();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Request that the walk stops as soon as possible. This can be called from
+//! any thread, including from the handler.
+
+void DirectoryWalker::cancel()
+{
+	atomicIncrement(m_cancelled);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The worker thread function. Each worker repeatedly takes the next folder
+//! from the queue until every folder has been walked. Once the walk has been
+//! cancelled the remaining folders are discarded rather than walked. The first
+//! failure is recorded for the calling thread and cancels the walk.
+
+void DirectoryWalker::walkFolders(void* param)
+{
+	WalkerContext&   context = *static_cast<WalkerContext*>(param);
+	DirectoryWalker& walker = *context.m_walker;
+
+	for (;;)
+	{
+		context.m_work.wait();
+
+		tstring folder;
+
+		{
+			AutoLock lock(context.m_lock);
+
+			// Woken to exit?
+			if (context.m_folders.empty())
+				break;
+
+			folder.swap(context.m_folders.back());
+			context.m_folders.pop_back();
+		}
+
+		try
+		{
+			if (!walker.isCancelled())
+				walkFolder(context, folder);
+		}
+		catch (...)
+		{
+			{
+				AutoLock lock(context.m_lock);
+
+				if (!context.m_failure.isCaptured())
+					context.m_failure.capture();
+			}
+
+			walker.cancel();
+		}
+
+		folderCompleted(context);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The handler used to delete the files of a folder tree as it is walked. The
+//! sub-folders are collected so that they can be deleted once empty.
+
+class TreeDeleter : public DirectoryWalker::Handler
+{
+public:
+	//! The collection of folder paths.
+	typedef std::vector<tstring> Folders;
+
+	//! Construction from the error handling behaviour.
+	explicit TreeDeleter(bool ignoreErrors)
+		: m_ignoreErrors(ignoreErrors)
+		, m_lock()
+		, m_folders()
+	{
+	}
+
+	//! Delete a file, or remember a folder for later. A read-only file has its
+	//! attribute cleared first so that it can be deleted.
+	virtual void processEntry(const tstring& folder, const DirectoryEntry& entry)
+	{
+		const tstring path = combinePaths(folder, entry.name());
+
+		if (entry.isFolder())
+		{
+			AutoLock lock(m_lock);
+
+			m_folders.push_back(path);
+			return;
+		}
+
+		if ((entry.attributes() & FILE_ATTRIBUTE_READONLY) != 0)
+			::SetFileAttributes(path.c_str(), entry.attributes() & ~FILE_ATTRIBUTE_READONLY);
+
+		deleteFile(path, m_ignoreErrors);
+	}
+
+	//! Skip a folder which cannot be enumerated when errors are ignored, so
+	//! that the rest of the tree is still deleted.
+	virtual bool skipFolder(const tstring& /*folder*/, const FileSystemException& /*exception*/)
+	{
+		return m_ignoreErrors;
+	}
+
+	//! Get the folders found, with every folder after all of its sub-folders.
+	Folders& folders()
+	{
+		// A folder's path is a prefix of its sub-folders' paths.
+		std::sort(m_folders.begin(), m_folders.end(), std::greater<tstring>());
+
+		return m_folders;
+	}
+
+private:
+	//
+	// Members.
+	//
+	bool			m_ignoreErrors;	//!< Should errors be ignored?
+	CriticalSection	m_lock;			//!< The lock for the folders.
+	Folders			m_folders;		//!< The folders found.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Delete the specified folder along with all its contents. The tree is walked
+//! using multiple threads, which delete the files as they are found, and then
+//! the empty folders are deleted from the bottom up. If the number of threads
+//! is zero one is used per processor. Reparse points, such as junctions, are
+//! deleted without deleting what they refer to. If errors are ignored as much
+//! of the tree as possible is deleted, including skipping any folder which
+//! cannot be enumerated, otherwise the first failure is thrown.
+
+void deleteFolderTree(const tstring& path, bool ignoreErrors, size_t threads)
+{
+	DirectoryWalker walker(path, threads);
+	TreeDeleter     deleter(ignoreErrors);
+
+	try
+	{
+		walker.walk(deleter);
+	}
+	catch (const Exception& /*e*/)
+	{
+		if (!ignoreErrors)
+			throw;
+	}
+
+	TreeDeleter::Folders& folders = deleter.folders();
+
+	for (TreeDeleter::Folders::const_iterator it = folders.begin(); it != folders.end(); ++it)
+		deleteFolder(*it, ignoreErrors);
+
+	deleteFolder(path, ignoreErrors);
+}
+
+//namespace Core
+}
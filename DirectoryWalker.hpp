@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   DirectoryWalker.hpp
+//! \brief  The DirectoryWalker class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_DIRECTORYWALKER_HPP
+#define CORE_DIRECTORYWALKER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "DirectoryEntry.hpp"
+
+namespace Core
+{
+
+// Forward declarations.
+class FileSystemException;
+
+////////////////////////////////////////////////////////////////////////////////
+//! Walks a folder tree using multiple threads. The folders waiting to be
+//! enumerated are held in a shared work queue from which each worker thread
+//! takes the next folder, reports its entries and queues its sub-folders.
+//! Entries are therefore reported in no particular order. Reparse points,
+//! such as junctions, are reported but not followed to avoid cycles.
+
+class DirectoryWalker /*: private NotCopyable*/
+{
+public:
+	////////////////////////////////////////////////////////////////////////////
+	//! The interface used to filter and process the entries. The methods are
+	//! called concurrently on the worker threads.
+
+	class Handler
+	{
+	public:
+		//! Destructor.
+		virtual ~Handler() {}
+
+		//! Query if the entry should be processed.
+		virtual bool filter(const tstring& /*folder*/, const DirectoryEntry& /*entry*/) { return true; }
+
+		//! Query if the sub-folder should be skipped rather than walked.
+		virtual bool prune(const tstring& /*folder*/, const DirectoryEntry& /*entry*/) { return false; }
+
+		//! Query if a folder which cannot be enumerated should be skipped
+		//! rather than failing the walk.
+		virtual bool skipFolder(const tstring& /*folder*/, const FileSystemException& /*exception*/) { return false; }
+
+		//! Process an entry that has passed the filter.
+		virtual void processEntry(const tstring& folder, const DirectoryEntry& entry) = 0;
+	};
+
+public:
+	//! Construction from the root of the tree and the number of threads.
+	explicit DirectoryWalker(const tstring& root, size_t threads = 0);
+
+	//! Destructor.
+	~DirectoryWalker();
+
+	//
+	// Properties.
+	//
+
+	//! Query if the walk has been cancelled.
+	bool isCancelled() const;
+
+	//
+	// Methods.
+	//
+
+	//! Walk the tree, returning false if cancelled.
+	bool walk(Handler& handler); // throw(Exception)
+
+	//! Request that the walk stops as soon as possible.
+	void cancel();
+
+private:
+	//
+	// Members.
+	//
+	tstring		m_root;			//!< The root of the tree.
+	size_t		m_threads;		//!< The number of worker threads.
+	long		m_cancelled;	//!< Has the walk been cancelled?
+
+	//
+	// Internal methods.
+	//
+
+	//! The worker thread function.
+	static void walkFolders(void* param);
+
+	// NotCopyable.
+	DirectoryWalker(const DirectoryWalker&);
+	DirectoryWalker& operator=(const DirectoryWalker&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the walk has been cancelled.
+
+inline bool DirectoryWalker::isCancelled() const
+{
+	return (m_cancelled != 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Delete the specified folder along with all its contents.
+
+void deleteFolderTree(const tstring& path, bool ignoreErrors = false, size_t threads = 0); // throw(FileSystemException)
+
+//namespace Core
+}
+
+#endif // CORE_DIRECTORYWALKER_HPP
@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Event.cpp
+//! \brief  The Event class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "Event.hpp"
+#include "RuntimeException.hpp"
+#include "Win32Error.hpp"
+#include "StringUtils.hpp"
+#include <windows.h>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the reset behaviour and initial state.
+
+Event::Event(ResetMode mode, bool signalled)
+	: m_handle(nullptr)
+{
+	m_handle = ::CreateEvent(nullptr, (mode == MANUAL_RESET), signalled, nullptr);
+
+	if (m_handle == nullptr)
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw RuntimeException(Core::fmt(TXT("Failed to create event [0x%08lX - %s]"), errorCode, errorText.c_str()));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+Event::~Event()
+{
+	::CloseHandle(m_handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Signal the event.
+
+void Event::signal()
+{
+	::SetEvent(m_handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Reset the event to the unsignalled state.
+
+void Event::reset()
+{
+	::ResetEvent(m_handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait for the event to be signalled.
+
+void Event::wait()
+{
+	wait(INFINITE_WAIT);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait for the event to be signalled or the timeout, in milliseconds, to
+//! expire. Returns false if the wait timed out.
+
+bool Event::wait(uint timeout)
+{
+	DWORD result = ::WaitForSingleObject(m_handle, timeout);
+
+	if (result == WAIT_FAILED)
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw RuntimeException(Core::fmt(TXT("Failed to wait for event [0x%08lX - %s]"), errorCode, errorText.c_str()));
+	}
+
+	return (result == WAIT_OBJECT_0);
+}
+
+//namespace Core
+}
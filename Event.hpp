@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Event.hpp
+//! \brief  The Event class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_EVENT_HPP
+#define CORE_EVENT_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! An unnamed event used to signal between threads. An auto-reset event wakes
+//! a single waiting thread and is then reset, whereas a manual-reset event
+//! wakes all waiting threads and remains signalled until it is reset.
+
+class Event /*: private NotCopyable*/
+{
+public:
+	//! The reset behaviour.
+	enum ResetMode
+	{
+		AUTO_RESET,		//!< Reset when a waiting thread is released.
+		MANUAL_RESET,	//!< Remain signalled until explicitly reset.
+	};
+
+	//! The timeout value for an infinite wait.
+	static const uint INFINITE_WAIT = 0xFFFFFFFF;
+
+public:
+	//! Construction with the reset behaviour and initial state.
+	explicit Event(ResetMode mode = AUTO_RESET, bool signalled = false); // throw(RuntimeException)
+
+	//! Destructor.
+	~Event();
+
+	//
+	// Methods.
+	//
+
+	//! Signal the event.
+	void signal();
+
+	//! Reset the event to the unsignalled state.
+	void reset();
+
+	//! Wait for the event to be signalled.
+	void wait(); // throw(RuntimeException)
+
+	//! Wait for the event to be signalled or the timeout to expire.
+	bool wait(uint timeout); // throw(RuntimeException)
+
+private:
+	//
+	// Members.
+	//
+	void*	m_handle;	//!< The event handle.
+
+	// NotCopyable.
+	Event(const Event&);
+	Event& operator=(const Event&);
+};
+
+//namespace Core
+}
+
+#endif // CORE_EVENT_HPP
@@ -0,0 +1,756 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ExternalSorter.cpp
+//! \brief  The ExternalSorter class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "ExternalSorter.hpp"
+#include "FileSystem.hpp"
+#include "Win32Error.hpp"
+#include "InvalidArgException.hpp"
+#include "StringUtils.hpp"
+#include "Thread.hpp"
+#include "FileLineReader.hpp"
+#include "TextFileWriter.hpp"
+#include "CapturedException.hpp"
+#include <windows.h>
+#include <limits.h>
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The largest number of bytes read by a single ReadFile().
+
+static const size_t MAX_IO_SIZE = INT_MAX;
+
+////////////////////////////////////////////////////////////////////////////////
+//! The smallest buffer used to read or write a file when merging.
+
+static const size_t MIN_MERGE_BUFFER_SIZE = 64 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+//! The function type used to compare two lines.
+
+typedef int (*CompareFn)(const char* lhs, size_t lhsLength, const char* rhs, size_t rhsLength);
+
+////////////////////////////////////////////////////////////////////////////////
+//! Open a file for sequential reading.
+
+static HANDLE openForReading(const tstring& filename)
+{
+	HANDLE file = ::CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+								OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+		throwLastError(TXT("Failed to open file"), filename);
+
+	return file;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read up to the given number of bytes, returning 0 at the end of the file.
+
+static size_t readFile(HANDLE file, const tstring& filename, char* buffer, size_t size)
+{
+	DWORD read = 0;
+
+	if (!::ReadFile(file, buffer, static_cast<DWORD>(std::min(size, MAX_IO_SIZE)), &read, nullptr))
+		throwLastError(TXT("Failed to read from file"), filename);
+
+	return read;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a uniquely named temporary file for a run.
+
+static tstring createTempFile()
+{
+	const tstring folder = getTempFolder();
+	tchar         filename[MAX_PATH+1] = { 0 };
+
+	if (::GetTempFileName(folder.c_str(), TXT("srt"), 0, filename) == 0)
+		throwLastError(TXT("Failed to create a temporary file in"), folder);
+
+	return filename;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Delete the temporary files, ignoring any errors.
+
+static void deleteFiles(const std::vector<tstring>& filenames)
+{
+	for (std::vector<tstring>::const_iterator it = filenames.begin(); it != filenames.end(); ++it)
+		deleteFile(*it, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare two lines byte by byte.
+
+static int compareBytes(const char* lhs, size_t lhsLength, const char* rhs, size_t rhsLength)
+{
+	int result = memcmp(lhs, rhs, std::min(lhsLength, rhsLength));
+
+	if (result != 0)
+		return result;
+
+	return (lhsLength < rhsLength) ? -1 : ((lhsLength > rhsLength) ? 1 : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare two lines byte by byte, ignoring the case of ASCII letters.
+
+static int compareIgnoringCase(const char* lhs, size_t lhsLength, const char* rhs, size_t rhsLength)
+{
+	const size_t length = std::min(lhsLength, rhsLength);
+
+	for (size_t i = 0; i != length; ++i)
+	{
+		int lhsChar = static_cast<uchar>(lhs[i]);
+		int rhsChar = static_cast<uchar>(rhs[i]);
+
+		if ( (lhsChar >= 'A') && (lhsChar <= 'Z') )
+			lhsChar += 'a' - 'A';
+
+		if ( (rhsChar >= 'A') && (rhsChar <= 'Z') )
+			rhsChar += 'a' - 'A';
+
+		if (lhsChar != rhsChar)
+			return lhsChar - rhsChar;
+	}
+
+	return (lhsLength < rhsLength) ? -1 : ((lhsLength > rhsLength) ? 1 : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The number at the start of a line, as its sign and runs of digits.
+
+struct NumericKey
+{
+	bool		m_negative;		//!< Is the number negative?
+	const char*	m_integer;		//!< The integer digits, without leading zeroes.
+	size_t		m_integerLength;//!< The number of integer digits.
+	const char*	m_fraction;		//!< The fraction digits, without trailing zeroes.
+	size_t		m_fractionLength;//!< The number of fraction digits.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Parse the number at the start of a line, after any leading whitespace. A
+//! line which does not start with a number has a key of zero.
+
+static NumericKey parseNumber(const char* begin, size_t length)
+{
+	const char* it = begin;
+	const char* end = begin + length;
+	NumericKey  key = { false, it, 0, it, 0 };
+
+	while ( (it != end) && ((*it == ' ') || (*it == '\t')) )
+		++it;
+
+	if ( (it != end) && ((*it == '-') || (*it == '+')) )
+		key.m_negative = (*it++ == '-');
+
+	while ( (it != end) && (*it == '0') )
+		++it;
+
+	key.m_integer = it;
+
+	while ( (it != end) && (*it >= '0') && (*it <= '9') )
+		++it;
+
+	key.m_integerLength = it - key.m_integer;
+
+	if ( (it != end) && (*it == '.') )
+	{
+		key.m_fraction = ++it;
+
+		while ( (it != end) && (*it >= '0') && (*it <= '9') )
+			++it;
+
+		key.m_fractionLength = it - key.m_fraction;
+
+		while ( (key.m_fractionLength != 0) && (key.m_fraction[key.m_fractionLength-1] == '0') )
+			--key.m_fractionLength;
+	}
+
+	// Treat -0 as 0.
+	if ( (key.m_integerLength == 0) && (key.m_fractionLength == 0) )
+		key.m_negative = false;
+
+	return key;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare two lines by the number at the start of each. The digits are
+//! compared directly so that there is no limit on the size or precision.
+
+static int compareNumbers(const char* lhs, size_t lhsLength, const char* rhs, size_t rhsLength)
+{
+	const NumericKey lhsKey = parseNumber(lhs, lhsLength);
+	const NumericKey rhsKey = parseNumber(rhs, rhsLength);
+
+	if (lhsKey.m_negative != rhsKey.m_negative)
+		return lhsKey.m_negative ? -1 : 1;
+
+	int result = 0;
+
+	if (lhsKey.m_integerLength != rhsKey.m_integerLength)
+		result = (lhsKey.m_integerLength < rhsKey.m_integerLength) ? -1 : 1;
+	else
+		result = compareBytes(lhsKey.m_integer, lhsKey.m_integerLength, rhsKey.m_integer, rhsKey.m_integerLength);
+
+	if (result == 0)
+		result = compareBytes(lhsKey.m_fraction, lhsKey.m_fractionLength, rhsKey.m_fraction, rhsKey.m_fractionLength);
+
+	return lhsKey.m_negative ? -result : result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the function used to compare lines.
+
+static CompareFn compareFunction(ExternalSorter::Comparison comparison)
+{
+	switch (comparison)
+	{
+		case ExternalSorter::CASE_INSENSITIVE:	return compareIgnoringCase;
+		case ExternalSorter::NUMERIC:			return compareNumbers;
+		case ExternalSorter::BYTEWISE:
+		default:								return compareBytes;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! A line within a run buffer.
+
+struct LineRef
+{
+	const char*	m_begin;	//!< The first character.
+	size_t		m_length;	//!< The number of characters.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! The predicate used to order lines.
+
+class LineLess
+{
+public:
+	//! Construction from the comparison function.
+	explicit LineLess(CompareFn compare)
+		: m_compare(compare)
+	{
+	}
+
+	//! Compare two lines.
+	bool operator()(const LineRef& lhs, const LineRef& rhs) const
+	{
+		return (m_compare(lhs.m_begin, lhs.m_length, rhs.m_begin, rhs.m_length) < 0);
+	}
+
+private:
+	CompareFn	m_compare;	//!< The comparison function.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! The predicate used to find duplicate lines.
+
+class LineEqual
+{
+public:
+	//! Construction from the comparison function.
+	explicit LineEqual(CompareFn compare)
+		: m_compare(compare)
+	{
+	}
+
+	//! Compare two lines.
+	bool operator()(const LineRef& lhs, const LineRef& rhs) const
+	{
+		return (m_compare(lhs.m_begin, lhs.m_length, rhs.m_begin, rhs.m_length) == 0);
+	}
+
+private:
+	CompareFn	m_compare;	//!< The comparison function.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! A run being merged, positioned on its current line. The line remains valid
+//! until the next one is read.
+
+class RunReader /*: private NotCopyable*/
+{
+public:
+	//! Construction from the run and the buffer size.
+	RunReader(const tstring& filename, size_t bufferSize)
+		: m_reader(filename, bufferSize)
+		, m_line(nullptr)
+		, m_end(nullptr)
+		, m_valid(false)
+	{
+	}
+
+	//! Is there a current line?
+	bool hasLine() const
+	{
+		return m_valid;
+	}
+
+	//! Get the current line.
+	const char* line() const
+	{
+		return m_line;
+	}
+
+	//! Get the length of the current line.
+	size_t length() const
+	{
+		return m_end - m_line;
+	}
+
+	//! Move to the next line, if there is one.
+	void next()
+	{
+		m_valid = m_reader.readAnsiLine(m_line, m_end);
+	}
+
+private:
+	//
+	// Members.
+	//
+	FileLineReader	m_reader;	//!< The run being read.
+	const char*		m_line;		//!< The current line.
+	const char*		m_end;		//!< The end of the current line.
+	bool			m_valid;	//!< Is there a current line?
+
+	// NotCopyable.
+	RunReader(const RunReader&);
+	RunReader& operator=(const RunReader&);
+};
+
+//! The smart pointer type for a run reader.
+typedef SharedPtr<RunReader> RunReaderPtr;
+//! The collection of run readers.
+typedef std::vector<RunReaderPtr> RunReaders;
+
+////////////////////////////////////////////////////////////////////////////////
+//! A tournament tree of losers used to merge runs. Each internal node holds
+//! the run which lost the match played there and the root holds the overall
+//! winner. After the winner's line is consumed only the matches on the path
+//! from its leaf to the root are replayed, which is log2(k) comparisons for k
+//! runs. Equal lines are won by the earlier run so that the merge is stable.
+
+class LoserTree
+{
+public:
+	//! Construction from the runs, each positioned on its first line.
+	LoserTree(const RunReaders& runs, CompareFn compare)
+		: m_runs(runs)
+		, m_compare(compare)
+		, m_nodes(runs.size())
+	{
+		if (!m_nodes.empty())
+			m_nodes[0] = (m_nodes.size() == 1) ? 0 : play(1);
+	}
+
+	//! Get the run with the lowest line.
+	size_t winner() const
+	{
+		return m_nodes[0];
+	}
+
+	//! Replay the matches after the run's line has changed.
+	void replay(size_t run)
+	{
+		size_t winner = run;
+
+		for (size_t node = (run + m_nodes.size()) / 2; node != 0; node /= 2)
+		{
+			if (beats(m_nodes[node], winner))
+				std::swap(m_nodes[node], winner);
+		}
+
+		m_nodes[0] = winner;
+	}
+
+private:
+	//
+	// Members.
+	//
+	const RunReaders&	m_runs;		//!< The runs being merged.
+	CompareFn			m_compare;	//!< The comparison function.
+	std::vector<size_t>	m_nodes;	//!< The loser of each match and the winner.
+
+	//! Play the matches below the node, returning the winner. The leaves are
+	//! the nodes after the internal ones.
+	size_t play(size_t node)
+	{
+		const size_t count = m_nodes.size();
+
+		if (node >= count)
+			return node - count;
+
+		const size_t left = play(node * 2);
+		const size_t right = play(node * 2 + 1);
+
+		if (beats(right, left))
+		{
+			m_nodes[node] = left;
+			return right;
+		}
+
+		m_nodes[node] = right;
+		return left;
+	}
+
+	//! Query if one run's line comes before another's. An exhausted run
+	//! always loses.
+	bool beats(size_t lhs, size_t rhs) const
+	{
+		const RunReader& lhsRun = *m_runs[lhs];
+		const RunReader& rhsRun = *m_runs[rhs];
+
+		if (!lhsRun.hasLine())
+			return false;
+
+		if (!rhsRun.hasLine())
+			return true;
+
+		const int result = m_compare(lhsRun.line(), lhsRun.length(), rhsRun.line(), rhsRun.length());
+
+		return (result < 0) || ((result == 0) && (lhs < rhs));
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Merge the runs into a single file, optionally dropping duplicates.
+
+static void mergeFiles(const std::vector<tstring>& runs, const tstring& output, size_t bufferSize, CompareFn compare, bool unique)
+{
+	RunReaders readers;
+
+	for (std::vector<tstring>::const_iterator it = runs.begin(); it != runs.end(); ++it)
+	{
+		readers.push_back(RunReaderPtr(new RunReader(*it, bufferSize)));
+		readers.back()->next();
+	}
+
+	TextFileWriter writer(output, UnicodeLineReader::ANSI, TextFileWriter::FOREGROUND, bufferSize);
+	LoserTree      tree(readers, compare);
+	std::string    last;
+	bool           written = false;
+
+	while (!readers.empty() && readers[tree.winner()]->hasLine())
+	{
+		const size_t winner = tree.winner();
+		RunReader&   run = *readers[winner];
+
+		if (!unique || !written || (compare(last.data(), last.size(), run.line(), run.length()) != 0))
+		{
+			writer.writeAnsi(run.line(), run.length());
+			writer.writeAnsi("\n", 1);
+
+			if (unique)
+				last.assign(run.line(), run.length());
+
+			written = true;
+		}
+
+		run.next();
+		tree.replay(winner);
+	}
+
+	writer.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! A chunk of the input file which is sorted into a run by a worker thread.
+
+struct RunTask
+{
+	std::vector<char>	m_buffer;	//!< The chunk of the input file.
+	size_t				m_length;	//!< The length of the complete lines.
+	tstring				m_filename;	//!< The file to write the run to.
+	size_t				m_run;		//!< The position of the run.
+	CompareFn			m_compare;	//!< The comparison function.
+	bool				m_unique;	//!< Should duplicate lines be removed?
+	CapturedException	m_failure;	//!< The exception thrown by the worker.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Sort a chunk and write it as a run. The lines are sorted in place as
+//! references into the chunk, with a trailing CR excluded.
+
+static void writeRun(RunTask& task)
+{
+	typedef std::vector<LineRef> LineRefs;
+
+	const char* it = &task.m_buffer.front();
+	const char* end = it + task.m_length;
+	LineRefs    lines;
+
+	while (it != end)
+	{
+		const char* newline = static_cast<const char*>(memchr(it, '\n', end - it));
+		const char* next = (newline != nullptr) ? newline + 1 : end;
+		const char* last = (newline != nullptr) ? newline : end;
+
+		if ( (last != it) && (*(last-1) == '\r') )
+			--last;
+
+		LineRef line = { it, static_cast<size_t>(last - it) };
+
+		lines.push_back(line);
+
+		it = next;
+	}
+
+	std::stable_sort(lines.begin(), lines.end(), LineLess(task.m_compare));
+
+	if (task.m_unique)
+		lines.erase(std::unique(lines.begin(), lines.end(), LineEqual(task.m_compare)), lines.end());
+
+	TextFileWriter writer(task.m_filename, UnicodeLineReader::ANSI, TextFileWriter::FOREGROUND, MIN_MERGE_BUFFER_SIZE);
+
+	for (LineRefs::const_iterator line = lines.begin(); line != lines.end(); ++line)
+	{
+		writer.writeAnsi(line->m_begin, line->m_length);
+		writer.writeAnsi("\n", 1);
+	}
+
+	writer.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The worker thread function which sorts a chunk and writes it as a run. Any
+//! failure is kept in the task for the calling thread.
+
+static void sortRun(void* param)
+{
+	RunTask& task = *static_cast<RunTask*>(param);
+
+	try
+	{
+		writeRun(task);
+	}
+	catch (...)
+	{
+		task.m_failure.capture();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the method used to compare lines, whether to remove
+//! duplicates, the memory budget for the chunks being sorted and the number
+//! of worker threads. If the number of threads is zero one is used per
+//! processor. The budget is shared between the threads.
+
+ExternalSorter::ExternalSorter(Comparison comparison, bool unique, size_t memoryBudget, size_t threads)
+	: m_comparison(comparison)
+	, m_unique(unique)
+	, m_budget(memoryBudget)
+	, m_threads(threads)
+	, m_runCount(0)
+{
+	if (memoryBudget == 0)
+		throw InvalidArgException(TXT("The memory budget cannot be zero"));
+
+	if (m_threads == 0)
+		m_threads = Thread::processorCount();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+ExternalSorter::~ExternalSorter()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Sort the lines of the input file into the output file. Lines may end with
+//! either "\n" or "\r\n" and are written with "\n". As the input has been read
+//! in full before the output is created, the output can be the input file.
+//! The temporary files are created in the temp folder and are deleted
+//! whether or not the sort succeeds.
+
+void ExternalSorter::sort(const tstring& input, const tstring& output)
+{
+	Filenames temporaries;
+
+	m_runCount = 0;
+
+	try
+	{
+		createRuns(input, temporaries);
+
+		const Filenames runs(temporaries);
+
+		m_runCount = runs.size();
+
+		mergeRuns(runs, output, temporaries);
+	}
+	catch (...)
+	{
+		deleteFiles(temporaries);
+		throw;
+	}
+
+	deleteFiles(temporaries);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Split the input file into sorted runs. The file is read in chunks on the
+//! calling thread, each cut back to the end of its last complete line, and
+//! each chunk is sorted and written out on a worker thread. Once every worker
+//! is busy the next chunk reuses the buffer of the oldest one, after waiting
+//! for it to finish. A line longer than a chunk grows the buffer. If a worker
+//! fails no more chunks are read and, once the other workers have finished,
+//! the failure of the earliest run is rethrown with its original type.
+
+void ExternalSorter::createRuns(const tstring& input, Filenames& runs)
+{
+	typedef SharedPtr<RunTask> RunTaskPtr;
+	typedef SharedPtr<Thread> ThreadPtr;
+
+	const size_t chunkSize = std::max<size_t>(m_budget / m_threads, 1);
+
+	HANDLE file = openForReading(input);
+
+	try
+	{
+		std::vector<RunTaskPtr> tasks;
+		std::vector<ThreadPtr>  workers(m_threads);
+		std::vector<char>       carried;
+		bool                    eof = false;
+
+		for (size_t slot = 0; !eof; slot = (slot + 1) % m_threads)
+		{
+			if (tasks.size() == slot)
+				tasks.push_back(RunTaskPtr(new RunTask));
+
+			if (workers[slot].get() != nullptr)
+			{
+				workers[slot]->join();
+				workers[slot].reset();
+
+				if (tasks[slot]->m_failure.isCaptured())
+					break;
+			}
+
+			RunTask&           task = *tasks[slot];
+			std::vector<char>& buffer = task.m_buffer;
+
+			buffer.resize(std::max(chunkSize, carried.size() * 2));
+			std::copy(carried.begin(), carried.end(), buffer.begin());
+
+			size_t filled = carried.size();
+			size_t length = 0;
+
+			for (;;)
+			{
+				while ( !eof && (filled != buffer.size()) )
+				{
+					const size_t read = readFile(file, input, &buffer[filled], buffer.size() - filled);
+
+					if (read == 0)
+						eof = true;
+
+					filled += read;
+				}
+
+				if (eof)
+				{
+					length = filled;
+					break;
+				}
+
+				length = filled;
+
+				while ( (length != 0) && (buffer[length-1] != '\n') )
+					--length;
+
+				if (length != 0)
+					break;
+
+				buffer.resize(buffer.size() * 2);
+			}
+
+			carried.assign(buffer.begin() + length, buffer.begin() + filled);
+
+			if (length == 0)
+				break;
+
+			task.m_length = length;
+			task.m_filename = createTempFile();
+			task.m_run = runs.size();
+			task.m_compare = compareFunction(m_comparison);
+			task.m_unique = m_unique;
+
+			runs.push_back(task.m_filename);
+
+			workers[slot] = ThreadPtr(new Thread(sortRun, &task));
+		}
+
+		for (std::vector<ThreadPtr>::iterator it = workers.begin(); it != workers.end(); ++it)
+		{
+			if (it->get() != nullptr)
+				(*it)->join();
+		}
+
+		const RunTask* failed = nullptr;
+
+		for (std::vector<RunTaskPtr>::const_iterator it = tasks.begin(); it != tasks.end(); ++it)
+		{
+			if ( (*it)->m_failure.isCaptured() && ((failed == nullptr) || ((*it)->m_run < failed->m_run)) )
+				failed = it->get();
+		}
+
+		if (failed != nullptr)
+			failed->m_failure.rethrow();
+	}
+	catch (...)
+	{
+		::CloseHandle(file);
+		throw;
+	}
+
+	::CloseHandle(file);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Merge the runs into the output file. When there are too many runs to merge
+//! at once they are merged in groups into intermediate runs first, which are
+//! added to the temporary files. The groups are of consecutive runs so that
+//! the merge remains stable.
+
+void ExternalSorter::mergeRuns(const Filenames& runs, const tstring& output, Filenames& temporaries)
+{
+	const CompareFn compare = compareFunction(m_comparison);
+	const size_t    width = MAX_MERGE_WIDTH;
+	Filenames       pending(runs);
+
+	while (pending.size() > width)
+	{
+		Filenames merged;
+
+		for (Filenames::const_iterator it = pending.begin(); it != pending.end(); )
+		{
+			const size_t    count = std::min<size_t>(pending.end() - it, width);
+			const Filenames group(it, it + count);
+			const tstring   filename = createTempFile();
+
+			temporaries.push_back(filename);
+
+			mergeFiles(group, filename, std::max(m_budget / (count + 1), MIN_MERGE_BUFFER_SIZE), compare, m_unique);
+
+			merged.push_back(filename);
+			it += count;
+		}
+
+		pending.swap(merged);
+	}
+
+	mergeFiles(pending, output, std::max(m_budget / (pending.size() + 1), MIN_MERGE_BUFFER_SIZE), compare, m_unique);
+}
+
+//namespace Core
+}
@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ExternalSorter.hpp
+//! \brief  The ExternalSorter class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_EXTERNALSORTER_HPP
+#define CORE_EXTERNALSORTER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Sorts the lines of a text file which may be much larger than memory. The
+//! file is read in chunks that fit within the memory budget and each chunk is
+//! sorted on a worker thread and written to a temporary file, or run. The runs
+//! are then merged into the output file. The sort is stable, so lines which
+//! compare equal keep their original order, and in unique mode only the first
+//! of them is kept.
+
+class ExternalSorter /*: private NotCopyable*/
+{
+public:
+	//! The method used to compare lines.
+	enum Comparison
+	{
+		BYTEWISE,			//!< Compare the bytes of each line.
+		CASE_INSENSITIVE,	//!< Compare the bytes ignoring the case of ASCII letters.
+		NUMERIC,			//!< Compare the number at the start of each line.
+	};
+
+	//! The default number of bytes used for the lines of the runs being sorted.
+	static const size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
+
+	//! The most runs merged at once.
+	static const size_t MAX_MERGE_WIDTH = 128;
+
+public:
+	//! Construction from the comparison, unique mode, memory budget and threads.
+	ExternalSorter(Comparison comparison = BYTEWISE, bool unique = false, size_t memoryBudget = DEFAULT_MEMORY_BUDGET, size_t threads = 0); // throw(InvalidArgException)
+
+	//! Destructor.
+	~ExternalSorter();
+
+	//
+	// Properties.
+	//
+
+	//! Get the number of runs created by the last sort.
+	size_t runCount() const;
+
+	//
+	// Methods.
+	//
+
+	//! Sort the lines of the input file into the output file.
+	void sort(const tstring& input, const tstring& output); // throw(FileSystemException, RuntimeException)
+
+private:
+	//! The collection of temporary files.
+	typedef std::vector<tstring> Filenames;
+
+	//
+	// Members.
+	//
+	Comparison	m_comparison;	//!< The method used to compare lines.
+	bool		m_unique;		//!< Should duplicate lines be removed?
+	size_t		m_budget;		//!< The memory budget for the runs.
+	size_t		m_threads;		//!< The number of worker threads.
+	size_t		m_runCount;		//!< The number of runs created by the last sort.
+
+	//
+	// Internal methods.
+	//
+
+	//! Split the input file into sorted runs.
+	void createRuns(const tstring& input, Filenames& runs);
+
+	//! Merge the runs into the output file.
+	void mergeRuns(const Filenames& runs, const tstring& output, Filenames& temporaries);
+
+	// NotCopyable.
+	ExternalSorter(const ExternalSorter&);
+	ExternalSorter& operator=(const ExternalSorter&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of runs created by the last sort.
+
+inline size_t ExternalSorter::runCount() const
+{
+	return m_runCount;
+}
+
+//namespace Core
+}
+
+#endif // CORE_EXTERNALSORTER_HPP
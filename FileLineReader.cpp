@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   FileLineReader.cpp
+//! \brief  The FileLineReader class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "FileLineReader.hpp"
+#include "LineIndex.hpp"
+#include "Win32Error.hpp"
+#include "FileSystemException.hpp"
+#include "InvalidArgException.hpp"
+#include "StringUtils.hpp"
+#include <windows.h>
+#include <limits.h>
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The largest number of bytes that can be requested by a single ReadFile().
+
+static const size_t MAX_BLOCK_SIZE = INT_MAX;
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the file to read and the block size.
+
+FileLineReader::FileLineReader(const tstring& filename, size_t blockSize)
+	: m_file(INVALID_HANDLE_VALUE)
+	, m_filename(filename)
+	, m_offset(0)
+	, m_buffer()
+{
+	if (blockSize == 0)
+		throw InvalidArgException(TXT("The block size cannot be zero"));
+
+	m_buffer.resize(std::min(blockSize, MAX_BLOCK_SIZE));
+
+	m_file = ::CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+							OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (m_file == INVALID_HANDLE_VALUE)
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw FileSystemException(Core::fmt(TXT("Failed to open file '%s' [0x%08lX - %s]"), filename.c_str(), errorCode, errorText.c_str()));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+FileLineReader::~FileLineReader()
+{
+	::CloseHandle(m_file);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Continue reading from the start of the line at the byte offset. Any line
+//! already partially read is discarded.
+
+void FileLineReader::seek(ulonglong offset)
+{
+	reset();
+
+	m_offset = offset;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Continue reading from the line, using the index to find it. The index
+//! must have been built from the same file. Returns false, leaving the reader
+//! at the end of the indexed lines, if the file has fewer lines.
+
+bool FileLineReader::seekLine(const LineIndex& index, ulonglong line)
+{
+	if (line >= index.lineCount())
+	{
+		seek(index.fileSize());
+		return false;
+	}
+
+	ulonglong offset = 0;
+	ulonglong current = index.findLine(line, offset);
+
+	seek(offset);
+
+	TextRange skipped;
+
+	for (; current != line; ++current)
+	{
+		if (!readLine(skipped))
+			throw FileSystemException(Core::fmt(TXT("The file '%s' has changed since it was indexed"), m_filename.c_str()));
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the next block of characters, if there is one. The block is read from
+//! the current offset, which allows the reader to be repositioned.
+
+bool FileLineReader::nextBlock(const char*& begin, const char*& end)
+{
+	const size_t read = readAt(m_file, m_filename, m_offset, &m_buffer.front(), m_buffer.size());
+
+	if (read == 0)
+		return false;
+
+	m_offset += read;
+
+	begin = &m_buffer.front();
+	end = begin + read;
+
+	return true;
+}
+
+//namespace Core
+}
@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   FileLineReader.hpp
+//! \brief  The FileLineReader class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_FILELINEREADER_HPP
+#define CORE_FILELINEREADER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include "LineReader.hpp"
+
+namespace Core
+{
+
+// Forward declarations.
+class LineIndex;
+
+////////////////////////////////////////////////////////////////////////////////
+//! A LineReader that reads a file in large blocks and which can be positioned
+//! at any line. Unlike a MappedLineReader it does not need the whole file to
+//! fit in the address space. A LineIndex is used to jump close to a line so
+//! that only the lines since the nearest sampled line have to be skipped.
+
+class FileLineReader : public LineReader
+{
+public:
+	//! The default number of bytes read at a time.
+	static const size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+public:
+	//! Construction from the file to read and the block size.
+	explicit FileLineReader(const tstring& filename, size_t blockSize = DEFAULT_BLOCK_SIZE); // throw(FileSystemException, InvalidArgException)
+
+	//! Destructor.
+	virtual ~FileLineReader();
+
+	//
+	// Methods.
+	//
+
+	//! Continue reading from the start of the line at the byte offset.
+	void seek(ulonglong offset);
+
+	//! Continue reading from the line, using the index to find it.
+	bool seekLine(const LineIndex& index, ulonglong line); // throw(FileSystemException)
+
+private:
+	//
+	// Members.
+	//
+	void*				m_file;		//!< The file handle.
+	tstring				m_filename;	//!< The file being read.
+	ulonglong			m_offset;	//!< The offset of the next block.
+	std::vector<char>	m_buffer;	//!< The block buffer.
+
+	//
+	// LineReader methods.
+	//
+
+	//! Get the next block of characters, if there is one.
+	virtual bool nextBlock(const char*& begin, const char*& end); // throw(FileSystemException)
+
+	// NotCopyable.
+	FileLineReader(const FileLineReader&);
+	FileLineReader& operator=(const FileLineReader&);
+};
+
+//namespace Core
+}
+
+#endif // CORE_FILELINEREADER_HPP
@@ -0,0 +1,267 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   FileReplaceBatch.cpp
+//! \brief  The FileReplaceBatch class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "FileReplaceBatch.hpp"
+#include "FileSystem.hpp"
+#include "Win32Error.hpp"
+#include "StringUtils.hpp"
+#include <windows.h>
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The largest number of bytes written by a single WriteFile().
+
+static const size_t MAX_WRITE_SIZE = 64 * 1024 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the device path used to open the volume containing the folder, e.g.
+//! "\\?\Volume{GUID}". Returns an empty path if the volume cannot be opened
+//! that way, such as for a network share.
+
+static tstring getVolumeDevice(const tstring& folder)
+{
+	tchar mountPoint[MAX_PATH+1] = { 0 };
+	tchar volume[MAX_PATH+1] = { 0 };
+
+	if (!::GetVolumePathName(folder.c_str(), mountPoint, MAX_PATH))
+		return tstring();
+
+	if (!::GetVolumeNameForVolumeMountPoint(mountPoint, volume, MAX_PATH))
+		return tstring();
+
+	tstring device = volume;
+
+	// Opening the volume requires the path without the trailing separator.
+	if (!device.empty() && (device[device.length()-1] == TXT('\\')))
+		device.erase(device.length()-1);
+
+	return device;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the folder containing the files and an optional handler
+//! to be told when each file has been replaced.
+
+FileReplaceBatch::FileReplaceBatch(const tstring& folder, Handler* handler)
+	: m_folder(folder)
+	, m_handler(handler)
+	, m_volume(getVolumeDevice(folder))
+	, m_pending()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. Any files that have not been committed are left unchanged.
+
+FileReplaceBatch::~FileReplaceBatch()
+{
+	discard();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write the new contents of a file, ready to replace it when the batch is
+//! committed. The contents are written to a uniquely named temporary file in
+//! the same folder, so that the rename is within the volume, but not flushed.
+//! A file can be added more than once, in which case the last contents win.
+
+void FileReplaceBatch::add(const tstring& filename, const void* data, size_t size)
+{
+	tchar tempPath[MAX_PATH+1] = { 0 };
+
+	if (::GetTempFileName(m_folder.c_str(), TXT("~rp"), 0, tempPath) == 0)
+		throwLastError(TXT("Failed to create a temporary file in"), m_folder);
+
+	HANDLE file = ::CreateFile(tempPath, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		DWORD errorCode = ::GetLastError();
+
+		deleteFile(tempPath, true);
+
+		::SetLastError(errorCode);
+		throwLastError(TXT("Failed to open file"), tempPath);
+	}
+
+	const byte* next = static_cast<const byte*>(data);
+	size_t      remaining = size;
+
+	while (remaining != 0)
+	{
+		DWORD written = 0;
+
+		if (!::WriteFile(file, next, static_cast<DWORD>(std::min(remaining, MAX_WRITE_SIZE)), &written, nullptr))
+		{
+			DWORD errorCode = ::GetLastError();
+
+			::CloseHandle(file);
+			deleteFile(tempPath, true);
+
+			::SetLastError(errorCode);
+			throwLastError(TXT("Failed to write to file"), tempPath);
+		}
+
+		next += written;
+		remaining -= written;
+	}
+
+	PendingFile pending;
+
+	pending.m_path = combinePaths(m_folder, filename);
+	pending.m_tempPath = tempPath;
+	pending.m_handle = file;
+
+	m_pending.push_back(pending);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Make the new contents durable and replace the files. The temporary files
+//! are flushed before being renamed over the originals so that a crash cannot
+//! expose a partially written file. Where the volume can be opened, which
+//! requires administrator rights, a single flush of the volume before and
+//! after the renames covers the whole batch. Otherwise each file is flushed
+//! and renamed with write-through. The handler, if any, is told about each
+//! file once the batch is durable. If anything fails the remaining files are
+//! discarded and the error is thrown; files already replaced stay replaced.
+
+void FileReplaceBatch::commit()
+{
+	if (m_pending.empty())
+		return;
+
+	try
+	{
+		const bool volumeFlushed = flushVolume();
+
+		if (!volumeFlushed)
+		{
+			for (PendingFiles::const_iterator it = m_pending.begin(); it != m_pending.end(); ++it)
+			{
+				if (!::FlushFileBuffers(it->m_handle))
+					throwLastError(TXT("Failed to flush file"), it->m_tempPath);
+			}
+		}
+
+		closeFiles();
+
+		const DWORD flags = MOVEFILE_REPLACE_EXISTING | (volumeFlushed ? 0 : MOVEFILE_WRITE_THROUGH);
+
+		for (PendingFiles::const_iterator it = m_pending.begin(); it != m_pending.end(); ++it)
+		{
+			if (!::MoveFileEx(it->m_tempPath.c_str(), it->m_path.c_str(), flags))
+				throwLastError(TXT("Failed to replace file"), it->m_path);
+		}
+
+		if (volumeFlushed)
+			flushVolume();
+	}
+	catch (...)
+	{
+		discard();
+		throw;
+	}
+
+	PendingFiles replaced;
+
+	replaced.swap(m_pending);
+
+	if (m_handler != nullptr)
+	{
+		for (PendingFiles::const_iterator it = replaced.begin(); it != replaced.end(); ++it)
+			m_handler->fileReplaced(it->m_path);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Abandon the files waiting to be replaced, deleting their temporary files.
+//! The original files are left unchanged.
+
+void FileReplaceBatch::discard()
+{
+	closeFiles();
+
+	for (PendingFiles::const_iterator it = m_pending.begin(); it != m_pending.end(); ++it)
+		deleteFile(it->m_tempPath, true);
+
+	m_pending.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Flush everything written to the folder's volume, which includes both file
+//! contents and metadata such as renames. Returns false if the volume cannot
+//! be opened, typically because of insufficient rights.
+
+bool FileReplaceBatch::flushVolume()
+{
+	if (m_volume.empty())
+		return false;
+
+	HANDLE volume = ::CreateFile(m_volume.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+									nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (volume == INVALID_HANDLE_VALUE)
+		return false;
+
+	const BOOL flushed = ::FlushFileBuffers(volume);
+	const DWORD errorCode = ::GetLastError();
+
+	::CloseHandle(volume);
+
+	if (!flushed)
+	{
+		::SetLastError(errorCode);
+		throwLastError(TXT("Failed to flush volume"), m_volume);
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Close the handles of the temporary files.
+
+void FileReplaceBatch::closeFiles()
+{
+	for (PendingFiles::iterator it = m_pending.begin(); it != m_pending.end(); ++it)
+	{
+		if (it->m_handle != INVALID_HANDLE_VALUE)
+		{
+			::CloseHandle(it->m_handle);
+			it->m_handle = INVALID_HANDLE_VALUE;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically replace the contents of the specified file, creating it if it
+//! does not exist. Readers see either the old or the new contents, and the new
+//! contents are durable when this returns. A path without a folder refers to
+//! the current folder. Use a FileReplaceBatch to replace many files in the
+//! same folder more cheaply.
+
+void replaceFile(const tstring& path, const void* data, size_t size)
+{
+	const size_t separator = path.find_last_of(TXT("\\/"));
+
+	tstring folder = TXT(".");
+	tstring filename = path;
+
+	if (separator != tstring::npos)
+	{
+		folder = path.substr(0, separator+1);
+		filename = path.substr(separator+1);
+	}
+
+	FileReplaceBatch batch(folder);
+
+	batch.add(filename, data, size);
+	batch.commit();
+}
+
+//namespace Core
+}
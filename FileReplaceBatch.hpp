@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   FileReplaceBatch.hpp
+//! \brief  The FileReplaceBatch class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_FILEREPLACEBATCH_HPP
+#define CORE_FILEREPLACEBATCH_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically replaces the contents of a batch of files in a single folder.
+//! The new contents of each file are written to a temporary file alongside it,
+//! and when the batch is committed the temporary files are made durable and
+//! then renamed over the originals. Readers therefore see either the old or
+//! the new contents of a file, never a mixture. The cost of flushing to disk
+//! is shared by the whole batch where the volume allows it.
+
+class FileReplaceBatch /*: private NotCopyable*/
+{
+public:
+	////////////////////////////////////////////////////////////////////////////
+	//! The interface used to report when the files have been replaced.
+
+	class Handler
+	{
+	public:
+		//! Destructor.
+		virtual ~Handler() {}
+
+		//! Called once the new contents of the file are durable.
+		virtual void fileReplaced(const tstring& path) = 0;
+	};
+
+public:
+	//! Construction from the folder containing the files and an optional handler.
+	explicit FileReplaceBatch(const tstring& folder, Handler* handler = nullptr);
+
+	//! Destructor.
+	~FileReplaceBatch();
+
+	//
+	// Properties.
+	//
+
+	//! Get the folder containing the files.
+	const tstring& folder() const;
+
+	//! Get the number of files waiting to be replaced.
+	size_t pendingCount() const;
+
+	//
+	// Methods.
+	//
+
+	//! Write the new contents of a file, ready to replace it.
+	void add(const tstring& filename, const void* data, size_t size); // throw(FileSystemException)
+
+	//! Make the new contents durable and replace the files.
+	void commit(); // throw(FileSystemException)
+
+	//! Abandon the files waiting to be replaced.
+	void discard();
+
+private:
+	//! A file waiting to be replaced.
+	struct PendingFile
+	{
+		tstring	m_path;		//!< The file to replace.
+		tstring	m_tempPath;	//!< The file containing the new contents.
+		void*	m_handle;	//!< The handle of the temporary file.
+	};
+
+	//! The collection of files waiting to be replaced.
+	typedef std::vector<PendingFile> PendingFiles;
+
+	//
+	// Members.
+	//
+	tstring			m_folder;	//!< The folder containing the files.
+	Handler*		m_handler;	//!< The optional handler.
+	tstring			m_volume;	//!< The device path of the folder's volume.
+	PendingFiles	m_pending;	//!< The files waiting to be replaced.
+
+	//
+	// Internal methods.
+	//
+
+	//! Flush everything written to the folder's volume, if possible.
+	bool flushVolume();
+
+	//! Close the handles of the temporary files.
+	void closeFiles();
+
+	// NotCopyable.
+	FileReplaceBatch(const FileReplaceBatch&);
+	FileReplaceBatch& operator=(const FileReplaceBatch&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the folder containing the files.
+
+inline const tstring& FileReplaceBatch::folder() const
+{
+	return m_folder;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of files waiting to be replaced.
+
+inline size_t FileReplaceBatch::pendingCount() const
+{
+	return m_pending.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Atomically replace the contents of the specified file.
+
+void replaceFile(const tstring& path, const void* data, size_t size); // throw(FileSystemException)
+
+//namespace Core
+}
+
+#endif // CORE_FILEREPLACEBATCH_HPP
@@ -5,10 +5,10 @@
 
 #include "Common.hpp"
 #include "FileSystem.hpp"
+#include "Win32Error.hpp"
 #include "BadLogicException.hpp"
 #include "StringUtils.hpp"
 #include "FileSystemException.hpp"
-#include "Scoped.hpp"
 #include <windows.h>
 #include <malloc.h>
 #include <io.h>
@@ -74,43 +74,6 @@ bool pathExists(const tstring& path)
 	return (_taccess(path.c_str(), 0) == 0);
 }
 
-////////////////////////////////////////////////////////////////////////////////
-//! Wrapper to invoke LocalFree on the buffer pointer.
-
-static void localFree(tchar* buffer)
-{
-	HLOCAL handle = ::LocalFree(buffer);
-
-	ASSERT(handle == NULL);
-	DEBUG_USE_ONLY(handle);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-//! Convert the WIN32 error code into a text message.
-
-static tstring formatWin32ErrorMessage(DWORD errorCode)
-{
-	typedef Core::Scoped<tchar*> BufferPtr;
-
-	tchar* buffer;
-
-	DWORD result = ::FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
-									nullptr, errorCode, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
-									reinterpret_cast<tchar*>(&buffer), 0, nullptr);
-
-	if (result == 0)
-		return TXT("Failed to format message with::FormatMessage()");
-
-	ASSERT(buffer != nullptr);
-
-	BufferPtr managedBuffer(buffer, localFree);
-	tstring   message(buffer);
-
-	trim(message);
-
-	return message;
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 //! Create the specified folder.
 
@@ -168,5 +131,164 @@ void deleteFile(const tstring& path, bool ignoreErrors)
 	}
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! Throw an exception for the last WIN32 error when copying or moving a file.
+
+static void throwCopyError(const tchar* operation, const tstring& source, const tstring& destination)
+{
+	DWORD   errorCode = ::GetLastError();
+	tstring errorText = formatWin32ErrorMessage(errorCode);
+
+	tstring message = Core::fmt(TXT("Failed to %s file '%s' to '%s' [0x%08lX - %s]"), operation, source.c_str(), destination.c_str(), errorCode, errorText.c_str());
+
+	throw FileSystemException(message);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The timestamps of a file.
+
+struct FileTimes
+{
+	FILETIME	m_created;	//!< The creation time.
+	FILETIME	m_accessed;	//!< The last access time.
+	FILETIME	m_written;	//!< The last write time.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Open a file to read or write its attributes only.
+
+static HANDLE openAttributes(const tstring& path, DWORD access)
+{
+	HANDLE file = ::CreateFile(path.c_str(), access, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+								nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw FileSystemException(Core::fmt(TXT("Failed to open file '%s' [0x%08lX - %s]"), path.c_str(), errorCode, errorText.c_str()));
+	}
+
+	return file;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the timestamps of a file.
+
+static void getFileTimes(const tstring& path, FileTimes& times)
+{
+	HandlePtr file(openAttributes(path, FILE_READ_ATTRIBUTES), closeHandle);
+
+	if (!::GetFileTime(file.get(), &times.m_created, &times.m_accessed, &times.m_written))
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw FileSystemException(Core::fmt(TXT("Failed to read the timestamps of file '%s' [0x%08lX - %s]"), path.c_str(), errorCode, errorText.c_str()));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Set the timestamps of a file.
+
+static void setFileTimes(const tstring& path, const FileTimes& times)
+{
+	HandlePtr file(openAttributes(path, FILE_WRITE_ATTRIBUTES), closeHandle);
+
+	if (!::SetFileTime(file.get(), &times.m_created, &times.m_accessed, &times.m_written))
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw FileSystemException(Core::fmt(TXT("Failed to set the timestamps of file '%s' [0x%08lX - %s]"), path.c_str(), errorCode, errorText.c_str()));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The routine invoked by the system as each block of a file is copied.
+
+static DWORD CALLBACK copyProgressRoutine(LARGE_INTEGER totalSize, LARGE_INTEGER transferred,
+											LARGE_INTEGER /*streamSize*/, LARGE_INTEGER /*streamTransferred*/,
+											DWORD /*stream*/, DWORD /*reason*/, HANDLE /*source*/,
+											HANDLE /*destination*/, LPVOID data)
+{
+	CopyProgress* progress = static_cast<CopyProgress*>(data);
+
+	if (!progress->progress(transferred.QuadPart, totalSize.QuadPart))
+		return PROGRESS_CANCEL;
+
+	return PROGRESS_CONTINUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Copy a file. The copy is done by the system with CopyFileEx(), which avoids
+//! copying the contents through a user-space buffer and can use the file
+//! system's own copy mechanism, such as block cloning or a server-side copy.
+//! The file's attributes and last write time are always copied; the other
+//! timestamps are copied on request. If a progress handler is provided it can
+//! cancel the copy, in which case the partial destination file is deleted and
+//! false is returned.
+
+bool copyFile(const tstring& source, const tstring& destination, uint flags, CopyProgress* progress)
+{
+	const DWORD copyFlags = ((flags & OVERWRITE_EXISTING) != 0) ? 0 : COPY_FILE_FAIL_IF_EXISTS;
+
+	LPPROGRESS_ROUTINE routine = (progress != nullptr) ? copyProgressRoutine : nullptr;
+
+	if (!::CopyFileEx(source.c_str(), destination.c_str(), routine, progress, nullptr, copyFlags))
+	{
+		if (::GetLastError() == ERROR_REQUEST_ABORTED)
+			return false;
+
+		throwCopyError(TXT("copy"), source, destination);
+	}
+
+	if ((flags & PRESERVE_TIMESTAMPS) != 0)
+	{
+		FileTimes times;
+
+		getFileTimes(source, times);
+		setFileTimes(destination, times);
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move a file. Within a volume the file is just renamed. Across volumes the
+//! system copies the file and then deletes the source, in which case the
+//! progress handler, if provided, is invoked and can cancel the move, leaving
+//! the source intact and returning false. The timestamps are restored on
+//! request, which only matters when the file had to be copied.
+
+bool moveFile(const tstring& source, const tstring& destination, uint flags, CopyProgress* progress)
+{
+	DWORD moveFlags = MOVEFILE_COPY_ALLOWED;
+
+	if ((flags & OVERWRITE_EXISTING) != 0)
+		moveFlags |= MOVEFILE_REPLACE_EXISTING;
+
+	FileTimes times;
+
+	if ((flags & PRESERVE_TIMESTAMPS) != 0)
+		getFileTimes(source, times);
+
+	LPPROGRESS_ROUTINE routine = (progress != nullptr) ? copyProgressRoutine : nullptr;
+
+	if (!::MoveFileWithProgress(source.c_str(), destination.c_str(), routine, progress, moveFlags))
+	{
+		if (::GetLastError() == ERROR_REQUEST_ABORTED)
+			return false;
+
+		throwCopyError(TXT("move"), source, destination);
+	}
+
+	if ((flags & PRESERVE_TIMESTAMPS) != 0)
+		setFileTimes(destination, times);
+
+	return true;
+}
+
 //namespace Core
 }
@@ -44,6 +44,39 @@ void deleteFolder(const tstring& path, bool ignoreErrors = false); // throw(File
 
 void deleteFile(const tstring& path, bool ignoreErrors = false); // throw(FileSystemExceptionException)
 
+////////////////////////////////////////////////////////////////////////////////
+// The options for copying or moving a file.
+
+enum CopyFlags
+{
+	COPY_DEFAULT		= 0x0000,	// Fail if the destination exists.
+	OVERWRITE_EXISTING	= 0x0001,	// Replace an existing destination file.
+	PRESERVE_TIMESTAMPS	= 0x0002,	// Copy the creation and last access times too.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// The interface used to report the progress of copying or moving a file.
+
+class CopyProgress
+{
+public:
+	// Destructor.
+	virtual ~CopyProgress() {}
+
+	// Called as each block is copied. Return false to cancel the copy.
+	virtual bool progress(ulonglong copied, ulonglong total) = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Copy a file, returning false if cancelled.
+
+bool copyFile(const tstring& source, const tstring& destination, uint flags = COPY_DEFAULT, CopyProgress* progress = nullptr); // throw(FileSystemExceptionException)
+
+////////////////////////////////////////////////////////////////////////////////
+// Move a file, returning false if cancelled.
+
+bool moveFile(const tstring& source, const tstring& destination, uint flags = COPY_DEFAULT, CopyProgress* progress = nullptr); // throw(FileSystemExceptionException)
+
 //namespace Core
 }
 
@@ -0,0 +1,467 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   FileSystemWatcher.cpp
+//! \brief  The FileSystemWatcher class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "FileSystemWatcher.hpp"
+#include "FileSystem.hpp"
+#include "Win32Error.hpp"
+#include "RuntimeException.hpp"
+#include "StringUtils.hpp"
+#include "AnsiWide.hpp"
+#include "Interlocked.hpp"
+#include <windows.h>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The size of the buffer for the changes returned by each read. Notifications
+//! for a folder on a network share fail if the buffer is larger than 64 KB.
+
+static const size_t READ_BUFFER_SIZE = 64 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+//! The types of change that are watched for.
+
+static const DWORD CHANGE_FILTER = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME
+								 | FILE_NOTIFY_CHANGE_ATTRIBUTES | FILE_NOTIFY_CHANGE_SIZE
+								 | FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create an unnamed manual-reset event.
+
+static HANDLE createEvent()
+{
+	HANDLE event = ::CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+	if (event == nullptr)
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw RuntimeException(Core::fmt(TXT("Failed to create event [0x%08lX - %s]"), errorCode, errorText.c_str()));
+	}
+
+	return event;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Map the action of a change notification onto the type of change. A rename
+//! is reported as the old path being removed and the new one being added.
+
+static FileSystemWatcher::Action mapAction(DWORD action)
+{
+	if ( (action == FILE_ACTION_ADDED) || (action == FILE_ACTION_RENAMED_NEW_NAME) )
+		return FileSystemWatcher::ADDED;
+
+	if ( (action == FILE_ACTION_REMOVED) || (action == FILE_ACTION_RENAMED_OLD_NAME) )
+		return FileSystemWatcher::REMOVED;
+
+	return FileSystemWatcher::MODIFIED;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Cancel the outstanding read for changes and wait for it to complete, as it
+//! uses the buffer.
+
+static void cancelRead(HANDLE folder, OVERLAPPED& overlapped)
+{
+	DWORD read = 0;
+
+	::CancelIo(folder);
+	::GetOverlappedResult(folder, &overlapped, &read, TRUE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the folder to watch and how to report the changes. If a
+//! handler is provided each batch of changes is passed to it on the background
+//! thread, otherwise they are queued to be read. A batch is reported once the
+//! coalesce window has passed since its first change. Construction only
+//! completes once the first read has been issued, as changes made before then
+//! are not recorded.
+
+FileSystemWatcher::FileSystemWatcher(const tstring& folder, bool recursive, Handler* handler, uint coalesceWindow)
+	: m_folder(folder)
+	, m_recursive(recursive)
+	, m_handler(handler)
+	, m_coalesceWindow(coalesceWindow)
+	, m_folderHandle(INVALID_HANDLE_VALUE)
+	, m_readEvent(nullptr)
+	, m_stopEvent(nullptr)
+	, m_readyEvent(nullptr)
+	, m_started(Event::MANUAL_RESET)
+	, m_watching(false)
+	, m_ended(0)
+	, m_failure()
+	, m_lock()
+	, m_queued()
+	, m_watcher()
+{
+	m_folderHandle = ::CreateFile(m_folder.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+									nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+
+	if (m_folderHandle == INVALID_HANDLE_VALUE)
+		throwLastError(TXT("Failed to open folder"), m_folder);
+
+	try
+	{
+		m_readEvent = createEvent();
+		m_stopEvent = createEvent();
+		m_readyEvent = createEvent();
+
+		m_watcher.reset(new Thread(watchThread, this));
+
+		m_started.wait();
+
+		// Rethrow the reason for failing to start.
+		if (!m_watching)
+			stop();
+	}
+	catch (...)
+	{
+		close();
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+FileSystemWatcher::~FileSystemWatcher()
+{
+	try
+	{
+		stop();
+	}
+	catch (...)
+	{
+	}
+
+	close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Take the queued changes, if there are any, without waiting. Any existing
+//! contents of the collection are replaced.
+
+bool FileSystemWatcher::readChanges(Changes& changes)
+{
+	AutoLock lock(m_lock);
+
+	changes.clear();
+
+	if (m_queued.empty())
+		return false;
+
+	changes.swap(m_queued);
+
+	::ResetEvent(m_readyEvent);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait for changes to be queued and then take them. Returns false if the
+//! timeout expires first. If watching has failed, once the queued changes have
+//! been taken the failure is rethrown with its original type.
+
+bool FileSystemWatcher::waitForChanges(Changes& changes, uint timeout)
+{
+	DWORD result = ::WaitForSingleObject(m_readyEvent, timeout);
+
+	if (result == WAIT_FAILED)
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw RuntimeException(Core::fmt(TXT("Failed to wait for changes [0x%08lX - %s]"), errorCode, errorText.c_str()));
+	}
+
+	if (readChanges(changes))
+		return true;
+
+	if (hasEnded() && m_failure.isCaptured())
+		m_failure.rethrow();
+
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Stop watching the folder. Any changes still being combined are reported
+//! first. An error on the background thread, including one thrown by the
+//! handler, is rethrown here with its original type. Queued changes can still
+//! be read afterwards.
+
+void FileSystemWatcher::stop()
+{
+	if (m_watcher.get() == nullptr)
+		return;
+
+	::SetEvent(m_stopEvent);
+
+	try
+	{
+		m_watcher->join();
+	}
+	catch (...)
+	{
+		m_watcher.reset();
+		throw;
+	}
+
+	m_watcher.reset();
+
+	if (m_failure.isCaptured())
+		m_failure.rethrow();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Add a change to a batch, combining it with any earlier change to the same
+//! path. A path that is added and then removed within the batch is dropped
+//! whereas one that is removed and then added is reported as modified.
+
+void FileSystemWatcher::addChange(Changes& changes, ChangeIndex& index, Action action, const tstring& path)
+{
+	ChangeIndex::iterator it = index.find(path);
+
+	if (it == index.end())
+	{
+		Change change = { action, path };
+
+		index[path] = changes.size();
+		changes.push_back(change);
+		return;
+	}
+
+	const size_t position = it->second;
+	Action&      previous = changes[position].m_action;
+
+	if ( (previous == ADDED) && (action == REMOVED) )
+	{
+		changes.erase(changes.begin() + position);
+		index.erase(it);
+
+		for (ChangeIndex::iterator later = index.begin(); later != index.end(); ++later)
+		{
+			if (later->second > position)
+				--later->second;
+		}
+	}
+	else if ( (previous == REMOVED) && (action == ADDED) )
+	{
+		previous = MODIFIED;
+	}
+	else if ( (previous == MODIFIED) && (action == REMOVED) )
+	{
+		previous = REMOVED;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Hand a batch of changes to the handler, or add them to the queue and signal
+//! the wait handle.
+
+void FileSystemWatcher::deliverChanges(const Changes& changes)
+{
+	if (changes.empty())
+		return;
+
+	if (m_handler != nullptr)
+	{
+		m_handler->changesDetected(changes);
+		return;
+	}
+
+	AutoLock lock(m_lock);
+
+	m_queued.insert(m_queued.end(), changes.begin(), changes.end());
+
+	::SetEvent(m_readyEvent);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Watch the folder until stopped. A read for changes is always outstanding so
+//! that none are missed whilst a batch is being combined. If the system runs
+//! out of space to record the changes it reports none, and so a single change
+//! for the folder is reported which tells the owner to rescan it. The read is
+//! cancelled before any failure is passed on.
+
+void FileSystemWatcher::watchFolder()
+{
+	std::vector<DWORD> buffer(READ_BUFFER_SIZE / sizeof(DWORD));
+	OVERLAPPED         overlapped;
+	Changes            changes;
+	ChangeIndex        index;
+	DWORD              firstChange = 0;
+
+	memset(&overlapped, 0, sizeof(overlapped));
+
+	overlapped.hEvent = m_readEvent;
+
+	for (;;)
+	{
+		::ResetEvent(m_readEvent);
+
+		if (!::ReadDirectoryChangesW(m_folderHandle, &buffer.front(), static_cast<DWORD>(READ_BUFFER_SIZE),
+										m_recursive, CHANGE_FILTER, nullptr, &overlapped, nullptr))
+		{
+			throwLastError(TXT("Failed to read the changes to folder"), m_folder);
+		}
+
+		if (!m_watching)
+		{
+			m_watching = true;
+			m_started.signal();
+		}
+
+		try
+		{
+			for (;;)
+			{
+				DWORD timeout = INFINITE;
+
+				// Waiting for the batch to be complete?
+				if (!changes.empty())
+				{
+					const DWORD elapsed = ::GetTickCount() - firstChange;
+
+					timeout = (elapsed < m_coalesceWindow) ? (m_coalesceWindow - elapsed) : 0;
+				}
+
+				HANDLE handles[] = { m_stopEvent, m_readEvent };
+
+				DWORD result = ::WaitForMultipleObjects(2, handles, FALSE, timeout);
+
+				if (result == WAIT_FAILED)
+					throwLastError(TXT("Failed to wait for changes to folder"), m_folder);
+
+				if (result == WAIT_OBJECT_0)
+				{
+					cancelRead(m_folderHandle, overlapped);
+
+					deliverChanges(changes);
+					return;
+				}
+
+				if (result == WAIT_TIMEOUT)
+				{
+					deliverChanges(changes);
+
+					changes.clear();
+					index.clear();
+					continue;
+				}
+
+				break;
+			}
+		}
+		catch (...)
+		{
+			cancelRead(m_folderHandle, overlapped);
+			throw;
+		}
+
+		DWORD read = 0;
+
+		if (changes.empty())
+			firstChange = ::GetTickCount();
+
+		if (!::GetOverlappedResult(m_folderHandle, &overlapped, &read, FALSE))
+		{
+			if (::GetLastError() != ERROR_NOTIFY_ENUM_DIR)
+				throwLastError(TXT("Failed to read the changes to folder"), m_folder);
+
+			read = 0;
+		}
+
+		if (read == 0)
+		{
+			addChange(changes, index, OVERFLOWED, m_folder);
+			continue;
+		}
+
+		const byte* next = reinterpret_cast<const byte*>(&buffer.front());
+
+		for (;;)
+		{
+			const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(next);
+			const wchar_t*                 begin = info->FileName;
+			const wchar_t*                 end = begin + (info->FileNameLength / sizeof(wchar_t));
+
+#ifdef ANSI_BUILD
+			const tstring name = wideToAnsi(begin, end);
+#else
+			const tstring name(begin, end);
+#endif
+
+			addChange(changes, index, mapAction(info->Action), combinePaths(m_folder, name));
+
+			if (info->NextEntryOffset == 0)
+				break;
+
+			next += info->NextEntryOffset;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The watcher thread function. A failure is kept for the owner, rather than
+//! being thrown through Thread::join(), and the wait handle is signalled so
+//! that an owner waiting for changes finds out. The constructor is released if
+//! watching fails to start.
+
+void FileSystemWatcher::watchThread(void* param)
+{
+	FileSystemWatcher* watcher = static_cast<FileSystemWatcher*>(param);
+
+	try
+	{
+		watcher->watchFolder();
+
+		atomicIncrement(watcher->m_ended);
+	}
+	catch (...)
+	{
+		watcher->m_failure.capture();
+
+		atomicIncrement(watcher->m_ended);
+
+		::SetEvent(watcher->m_readyEvent);
+		watcher->m_started.signal();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Close the handles.
+
+void FileSystemWatcher::close()
+{
+	if (m_readyEvent != nullptr)
+	{
+		::CloseHandle(m_readyEvent);
+		m_readyEvent = nullptr;
+	}
+
+	if (m_stopEvent != nullptr)
+	{
+		::CloseHandle(m_stopEvent);
+		m_stopEvent = nullptr;
+	}
+
+	if (m_readEvent != nullptr)
+	{
+		::CloseHandle(m_readEvent);
+		m_readEvent = nullptr;
+	}
+
+	if (m_folderHandle != INVALID_HANDLE_VALUE)
+	{
+		::CloseHandle(m_folderHandle);
+		m_folderHandle = INVALID_HANDLE_VALUE;
+	}
+}
+
+//namespace Core
+}
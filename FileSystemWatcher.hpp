@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   FileSystemWatcher.hpp
+//! \brief  The FileSystemWatcher class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_FILESYSTEMWATCHER_HPP
+#define CORE_FILESYSTEMWATCHER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include <map>
+#include "CriticalSection.hpp"
+#include "Event.hpp"
+#include "Thread.hpp"
+#include "UniquePtr.hpp"
+#include "CapturedException.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Watches a folder, and optionally its subfolders, for files and folders
+//! being added, removed or modified. The changes are gathered on a background
+//! thread and those that occur to the same path within a short window are
+//! combined, so that a burst of writes is reported as a single change. Each
+//! batch of changes is either passed to a handler on the background thread or
+//! queued for the owner to read, either by waiting or by including the wait
+//! handle in its own call to WaitForMultipleObjects().
+
+class FileSystemWatcher /*: private NotCopyable*/
+{
+public:
+	//! The type of change.
+	enum Action
+	{
+		ADDED,		//!< The path was created or renamed to.
+		REMOVED,	//!< The path was deleted or renamed from.
+		MODIFIED,	//!< The contents or attributes of the path changed.
+		OVERFLOWED,	//!< Changes were lost and the folder should be rescanned.
+	};
+
+	//! A change to a path.
+	struct Change
+	{
+		Action	m_action;	//!< The type of change.
+		tstring	m_path;		//!< The full path of the file or folder.
+	};
+
+	//! A batch of changes.
+	typedef std::vector<Change> Changes;
+
+	//! The default time in milliseconds over which changes are combined.
+	static const uint DEFAULT_COALESCE_WINDOW = 100;
+
+	//! The timeout value for an infinite wait.
+	static const uint INFINITE_WAIT = 0xFFFFFFFF;
+
+	////////////////////////////////////////////////////////////////////////////
+	//! The interface used to receive each batch of changes.
+
+	class Handler
+	{
+	public:
+		//! Destructor.
+		virtual ~Handler() {}
+
+		//! Called on the background thread with a batch of changes. An
+		//! exception ends the watch and is rethrown to the owner.
+		virtual void changesDetected(const Changes& changes) = 0;
+	};
+
+public:
+	//! Construction from the folder to watch and how to report the changes.
+	explicit FileSystemWatcher(const tstring& folder, bool recursive = false, Handler* handler = nullptr, uint coalesceWindow = DEFAULT_COALESCE_WINDOW); // throw(FileSystemException, RuntimeException)
+
+	//! Destructor.
+	~FileSystemWatcher();
+
+	//
+	// Properties.
+	//
+
+	//! Get the folder being watched.
+	const tstring& folder() const;
+
+	//! Get the handle which is signalled whilst changes are queued.
+	void* waitHandle() const;
+
+	//! Query if watching has ended, either by being stopped or by failing.
+	bool hasEnded() const;
+
+	//
+	// Methods.
+	//
+
+	//! Take the queued changes, if there are any, without waiting.
+	bool readChanges(Changes& changes);
+
+	//! Wait for changes to be queued and then take them.
+	bool waitForChanges(Changes& changes, uint timeout = INFINITE_WAIT); // throw(Exception)
+
+	//! Stop watching the folder.
+	void stop(); // throw(Exception)
+
+private:
+	//! The map of path to the index of its change in a batch.
+	typedef std::map<tstring, size_t> ChangeIndex;
+
+	//
+	// Members.
+	//
+	tstring				m_folder;			//!< The folder being watched.
+	bool				m_recursive;		//!< Are subfolders watched too?
+	Handler*			m_handler;			//!< The handler, if any.
+	uint				m_coalesceWindow;	//!< The time over which changes are combined.
+	void*				m_folderHandle;		//!< The folder handle.
+	void*				m_readEvent;		//!< Signalled when a read completes.
+	void*				m_stopEvent;		//!< Signalled when watching is stopped.
+	void*				m_readyEvent;		//!< Signalled whilst changes are queued.
+	Event				m_started;			//!< Signalled once watching starts or fails.
+	bool				m_watching;			//!< Was the first read issued?
+	long				m_ended;			//!< Has watching ended?
+	CapturedException	m_failure;			//!< The exception which ended watching.
+	CriticalSection		m_lock;				//!< The lock for the queued changes.
+	Changes				m_queued;			//!< The changes waiting to be read.
+	UniquePtr<Thread>	m_watcher;			//!< The thread watching the folder.
+
+	//
+	// Internal methods.
+	//
+
+	//! Add a change to a batch, combining it with any earlier one.
+	static void addChange(Changes& changes, ChangeIndex& index, Action action, const tstring& path);
+
+	//! Hand a batch of changes to the handler or the queue.
+	void deliverChanges(const Changes& changes);
+
+	//! Watch the folder until stopped.
+	void watchFolder();
+
+	//! The watcher thread function.
+	static void watchThread(void* param);
+
+	//! Close the handles.
+	void close();
+
+	// NotCopyable.
+	FileSystemWatcher(const FileSystemWatcher&);
+	FileSystemWatcher& operator=(const FileSystemWatcher&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the folder being watched.
+
+inline const tstring& FileSystemWatcher::folder() const
+{
+	return m_folder;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the handle which is signalled whilst changes are queued. This allows
+//! the owner to wait for changes alongside its own handles. The changes are
+//! only queued when there is no handler. The handle is also signalled if
+//! watching fails, with or without a handler.
+
+inline void* FileSystemWatcher::waitHandle() const
+{
+	return m_readyEvent;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if watching has ended, either by being stopped or by failing. Once it
+//! has failed stop() rethrows the reason.
+
+inline bool FileSystemWatcher::hasEnded() const
+{
+	return (m_ended != 0);
+}
+
+//namespace Core
+}
+
+#endif // CORE_FILESYSTEMWATCHER_HPP
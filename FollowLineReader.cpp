@@ -0,0 +1,279 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   FollowLineReader.cpp
+//! \brief  The FollowLineReader class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "FollowLineReader.hpp"
+#include "Win32Error.hpp"
+#include "InvalidArgException.hpp"
+#include "RuntimeException.hpp"
+#include "StringUtils.hpp"
+#include "Interlocked.hpp"
+#include <windows.h>
+#include <limits.h>
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The largest number of bytes that can be requested by a single ReadFile().
+
+static const size_t MAX_BLOCK_SIZE = INT_MAX;
+
+////////////////////////////////////////////////////////////////////////////////
+//! Open the file for reading whilst allowing the writer to continue writing
+//! to it and to rename or delete it. Returns INVALID_HANDLE_VALUE on failure.
+
+static HANDLE openShared(const tstring& filename)
+{
+	return ::CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+						nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the folder containing the file, including the trailing separator.
+
+static tstring parentFolder(const tstring& path)
+{
+	const size_t separator = path.find_last_of(TXT("\\/"));
+
+	if (separator == tstring::npos)
+		return TXT(".");
+
+	return path.substr(0, separator+1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the file to follow and where to start reading it. When
+//! starting from the end, any incomplete final line is included so that only
+//! whole lines are returned. The folder is watched for changes so that new
+//! data is noticed straight away. Not every file system supports change
+//! notifications, and a writer's appends may not be reported until it
+//! flushes, so the file is also checked at least every poll interval.
+
+FollowLineReader::FollowLineReader(const tstring& filename, StartPosition start, uint pollInterval, size_t blockSize)
+	: m_filename(filename)
+	, m_pollInterval(pollInterval)
+	, m_file(INVALID_HANDLE_VALUE)
+	, m_fileId()
+	, m_offset(0)
+	, m_buffer()
+	, m_notification(INVALID_HANDLE_VALUE)
+	, m_stopEvent(nullptr)
+	, m_stopped(0)
+{
+	if (blockSize == 0)
+		throw InvalidArgException(TXT("The block size cannot be zero"));
+
+	m_buffer.resize(std::min(blockSize, MAX_BLOCK_SIZE));
+
+	m_file = openShared(m_filename);
+
+	if (m_file == INVALID_HANDLE_VALUE)
+		throwLastError(TXT("Failed to open file"), m_filename);
+
+	try
+	{
+		BY_HANDLE_FILE_INFORMATION info;
+
+		if (!::GetFileInformationByHandle(m_file, &info))
+			throwLastError(TXT("Failed to query the details of file"), m_filename);
+
+		m_fileId.m_volume = info.dwVolumeSerialNumber;
+		m_fileId.m_indexHigh = info.nFileIndexHigh;
+		m_fileId.m_indexLow = info.nFileIndexLow;
+
+		if (start == FROM_END)
+		{
+			m_offset = (static_cast<ulonglong>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+
+			// Move back to the start of an incomplete final line.
+			while (m_offset != 0)
+			{
+				const size_t size = static_cast<size_t>(std::min<ulonglong>(m_offset, m_buffer.size()));
+				const size_t read = readAt(m_file, m_filename, m_offset - size, &m_buffer.front(), size);
+				const char*  last = &m_buffer.front() + read;
+
+				while ( (last != &m_buffer.front()) && (*(last-1) != '\n') )
+					--last;
+
+				if (last != &m_buffer.front())
+				{
+					m_offset -= size - (last - &m_buffer.front());
+					break;
+				}
+
+				m_offset -= size;
+			}
+		}
+
+		m_stopEvent = ::CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+		if (m_stopEvent == nullptr)
+		{
+			DWORD   errorCode = ::GetLastError();
+			tstring errorText = formatWin32ErrorMessage(errorCode);
+
+			throw RuntimeException(Core::fmt(TXT("Failed to create event [0x%08lX - %s]"), errorCode, errorText.c_str()));
+		}
+
+		// Fall back to polling if notifications are unavailable.
+		m_notification = ::FindFirstChangeNotification(parentFolder(m_filename).c_str(), FALSE,
+														FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+	}
+	catch (...)
+	{
+		close();
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+FollowLineReader::~FollowLineReader()
+{
+	close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Stop reading, waking the reader if it is waiting for more data. This can be
+//! called from any thread. Any incomplete final line is not returned.
+
+void FollowLineReader::stop()
+{
+	atomicIncrement(m_stopped);
+
+	::SetEvent(m_stopEvent);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the next block of characters, waiting for one if necessary. When the
+//! end of the file is reached it is checked to see if it has been truncated
+//! or replaced before waiting for it to change. An incomplete line is only
+//! discarded when switching files or stopping.
+
+bool FollowLineReader::nextBlock(const char*& begin, const char*& end)
+{
+	for (;;)
+	{
+		if (isStopped())
+		{
+			reset();
+			return false;
+		}
+
+		const size_t read = readAt(m_file, m_filename, m_offset, &m_buffer.front(), m_buffer.size());
+
+		if (read != 0)
+		{
+			m_offset += read;
+
+			begin = &m_buffer.front();
+			end = begin + read;
+
+			return true;
+		}
+
+		if (checkReplaced())
+			reset();
+		else
+			waitForChange();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Switch to the start of the file if it has been replaced with a different
+//! one or truncated. The file is identified by its volume and file index, as
+//! the path may now refer to a new file. Returns false if neither has
+//! happened, or if the file has been removed but not yet replaced.
+
+bool FollowLineReader::checkReplaced()
+{
+	HANDLE file = openShared(m_filename);
+
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	BY_HANDLE_FILE_INFORMATION info;
+
+	if (!::GetFileInformationByHandle(file, &info))
+	{
+		::CloseHandle(file);
+		return false;
+	}
+
+	const bool sameFile = (info.dwVolumeSerialNumber == m_fileId.m_volume)
+					   && (info.nFileIndexHigh == m_fileId.m_indexHigh)
+					   && (info.nFileIndexLow == m_fileId.m_indexLow);
+
+	if (sameFile)
+	{
+		::CloseHandle(file);
+
+		const ulonglong size = (static_cast<ulonglong>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+
+		if (size >= m_offset)
+			return false;
+	}
+	else
+	{
+		::CloseHandle(m_file);
+
+		m_file = file;
+		m_fileId.m_volume = info.dwVolumeSerialNumber;
+		m_fileId.m_indexHigh = info.nFileIndexHigh;
+		m_fileId.m_indexLow = info.nFileIndexLow;
+	}
+
+	m_offset = 0;
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait for the folder to change, the poll interval to expire or a stop.
+
+void FollowLineReader::waitForChange()
+{
+	HANDLE handles[] = { m_stopEvent, m_notification };
+	DWORD  count = (m_notification != INVALID_HANDLE_VALUE) ? 2 : 1;
+
+	DWORD result = ::WaitForMultipleObjects(count, handles, FALSE, m_pollInterval);
+
+	if (result == WAIT_FAILED)
+		throwLastError(TXT("Failed to wait for changes to file"), m_filename);
+
+	// Rearm the notification.
+	if (result == WAIT_OBJECT_0+1)
+		::FindNextChangeNotification(m_notification);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Close the handles.
+
+void FollowLineReader::close()
+{
+	if (m_notification != INVALID_HANDLE_VALUE)
+	{
+		::FindCloseChangeNotification(m_notification);
+		m_notification = INVALID_HANDLE_VALUE;
+	}
+
+	if (m_stopEvent != nullptr)
+	{
+		::CloseHandle(m_stopEvent);
+		m_stopEvent = nullptr;
+	}
+
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		::CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+	}
+}
+
+//namespace Core
+}
@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   FollowLineReader.hpp
+//! \brief  The FollowLineReader class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_FOLLOWLINEREADER_HPP
+#define CORE_FOLLOWLINEREADER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include "LineReader.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A LineReader that follows a growing file, such as a log file, in the manner
+//! of "tail -F". When the end of the file is reached it waits for more data to
+//! be written rather than finishing, and only complete lines are returned. If
+//! the file is truncated it is read again from the start, and if it is
+//! replaced, e.g. by log rotation, the new file is read instead. Reading only
+//! finishes once stop() has been called.
+
+class FollowLineReader : public LineReader
+{
+public:
+	//! Where to start reading the file.
+	enum StartPosition
+	{
+		FROM_START,		//!< Read the existing lines first.
+		FROM_END,		//!< Only read lines written after opening.
+	};
+
+	//! The default number of milliseconds between checks for changes.
+	static const uint DEFAULT_POLL_INTERVAL = 1000;
+
+	//! The default number of bytes read at a time.
+	static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+public:
+	//! Construction from the file to follow and where to start reading it.
+	explicit FollowLineReader(const tstring& filename, StartPosition start = FROM_END, uint pollInterval = DEFAULT_POLL_INTERVAL, size_t blockSize = DEFAULT_BLOCK_SIZE); // throw(FileSystemException, InvalidArgException)
+
+	//! Destructor.
+	virtual ~FollowLineReader();
+
+	//
+	// Properties.
+	//
+
+	//! Query if reading has been stopped.
+	bool isStopped() const;
+
+	//
+	// Methods.
+	//
+
+	//! Stop reading, waking the reader if it is waiting for more data.
+	void stop();
+
+private:
+	//! The identity of a file on a volume.
+	struct FileId
+	{
+		ulong	m_volume;		//!< The volume serial number.
+		ulong	m_indexHigh;	//!< The high part of the file index.
+		ulong	m_indexLow;		//!< The low part of the file index.
+	};
+
+	//
+	// Members.
+	//
+	tstring				m_filename;		//!< The file being followed.
+	uint				m_pollInterval;	//!< The maximum time between checks.
+	void*				m_file;			//!< The file handle.
+	FileId				m_fileId;		//!< The identity of the open file.
+	ulonglong			m_offset;		//!< The offset of the next block.
+	std::vector<char>	m_buffer;		//!< The block buffer.
+	void*				m_notification;	//!< The folder change notification handle.
+	void*				m_stopEvent;	//!< Signalled when reading is stopped.
+	long				m_stopped;		//!< Has reading been stopped?
+
+	//
+	// LineReader methods.
+	//
+
+	//! Get the next block of characters, waiting for one if necessary.
+	virtual bool nextBlock(const char*& begin, const char*& end); // throw(FileSystemException)
+
+	//
+	// Internal methods.
+	//
+
+	//! Switch to the start of a new or truncated file.
+	bool checkReplaced();
+
+	//! Wait for the folder to change, the poll interval to expire or a stop.
+	void waitForChange();
+
+	//! Close the handles.
+	void close();
+
+	// NotCopyable.
+	FollowLineReader(const FollowLineReader&);
+	FollowLineReader& operator=(const FollowLineReader&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if reading has been stopped.
+
+inline bool FollowLineReader::isStopped() const
+{
+	return (m_stopped != 0);
+}
+
+//namespace Core
+}
+
+#endif // CORE_FOLLOWLINEREADER_HPP
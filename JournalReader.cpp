@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   JournalReader.cpp
+//! \brief  The JournalReader class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "JournalReader.hpp"
+#include "Win32Error.hpp"
+#include "FileSystemException.hpp"
+#include "InvalidArgException.hpp"
+#include "StringUtils.hpp"
+#include "Checksum.hpp"
+#include <windows.h>
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Decode a little-endian 32 bit value.
+
+static uint readUint32(const byte* bytes)
+{
+	return static_cast<uint>(bytes[0])
+		 | (static_cast<uint>(bytes[1]) << 8)
+		 | (static_cast<uint>(bytes[2]) << 16)
+		 | (static_cast<uint>(bytes[3]) << 24);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the journal file and the number of bytes to read at a
+//! time. The buffer grows to hold any record larger than that.
+
+JournalReader::JournalReader(const tstring& filename, size_t blockSize)
+	: m_filename(filename)
+	, m_file(INVALID_HANDLE_VALUE)
+	, m_blockSize(blockSize)
+	, m_buffer()
+	, m_next(0)
+	, m_end(0)
+	, m_eof(false)
+	, m_validSize(0)
+	, m_torn(false)
+	, m_stopped(false)
+{
+	if (blockSize == 0)
+		throw InvalidArgException(TXT("The block size cannot be zero"));
+
+	m_file = ::CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+							OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (m_file == INVALID_HANDLE_VALUE)
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw FileSystemException(Core::fmt(TXT("Failed to open file '%s' [0x%08lX - %s]"), filename.c_str(), errorCode, errorText.c_str()));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+JournalReader::~JournalReader()
+{
+	::CloseHandle(m_file);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the next valid record, if there is one. The record remains valid until
+//! the next record is read. Returns false at the end of the file or at the
+//! first torn record, after which no more records are returned.
+
+bool JournalReader::readRecord(ByteRange& record)
+{
+	if (m_stopped)
+		return false;
+
+	if (!fill(HEADER_SIZE))
+	{
+		// A partial header is a torn record.
+		m_torn = (m_next != m_end);
+		m_stopped = true;
+		return false;
+	}
+
+	const uint length = readUint32(&m_buffer[m_next]);
+	const uint checksum = readUint32(&m_buffer[m_next + 4]);
+
+	if ( (length > MAX_RECORD_SIZE) || !fill(HEADER_SIZE + length) )
+	{
+		m_torn = true;
+		m_stopped = true;
+		return false;
+	}
+
+	const byte* header = &m_buffer[m_next];
+	const byte* contents = header + HEADER_SIZE;
+
+	// The checksum covers the length as well as the contents.
+	if (crc32(contents, length, crc32(header, 4)) != checksum)
+	{
+		m_torn = true;
+		m_stopped = true;
+		return false;
+	}
+
+	record = ByteRange(contents, contents + length);
+
+	m_next += HEADER_SIZE + length;
+	m_validSize += HEADER_SIZE + length;
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Ensure that the buffer holds the given number of unread bytes, moving any
+//! unread bytes to the front of the buffer before reading more. Returns false
+//! if the end of the file is reached first.
+
+bool JournalReader::fill(size_t bytes)
+{
+	while ((m_end - m_next) < bytes)
+	{
+		if (m_eof)
+			return false;
+
+		if (m_next != 0)
+		{
+			if (m_next != m_end)
+				memmove(&m_buffer[0], &m_buffer[m_next], m_end - m_next);
+
+			m_end -= m_next;
+			m_next = 0;
+		}
+
+		// Grow as the data arrives so that a corrupt length cannot cause a
+		// huge allocation.
+		if ((m_buffer.size() - m_end) < m_blockSize)
+			m_buffer.resize(std::max(m_end + m_blockSize, m_buffer.size() * 2));
+
+		DWORD read = 0;
+
+		if (!::ReadFile(m_file, &m_buffer[m_end], static_cast<DWORD>(m_buffer.size() - m_end), &read, nullptr))
+		{
+			DWORD   errorCode = ::GetLastError();
+			tstring errorText = formatWin32ErrorMessage(errorCode);
+
+			throw FileSystemException(Core::fmt(TXT("Failed to read from file '%s' [0x%08lX - %s]"), m_filename.c_str(), errorCode, errorText.c_str()));
+		}
+
+		if (read == 0)
+			m_eof = true;
+
+		m_end += read;
+	}
+
+	return true;
+}
+
+//namespace Core
+}
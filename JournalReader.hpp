@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   JournalReader.hpp
+//! \brief  The JournalReader class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_JOURNALREADER_HPP
+#define CORE_JOURNALREADER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include "Range.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Reads the records of a journal file written by a JournalWriter. Each record
+//! is stored as its length and CRC-32 followed by its contents. Reading stops
+//! at the first record which is incomplete or fails its checksum, which is
+//! what remains of a write that was interrupted, i.e. a torn tail.
+
+class JournalReader /*: private NotCopyable*/
+{
+public:
+	//! The size of the length and checksum that precede each record.
+	static const size_t HEADER_SIZE = 8;
+
+	//! The largest record that can be stored.
+	static const size_t MAX_RECORD_SIZE = 0x7FFFFFFF;
+
+	//! The default number of bytes read at a time.
+	static const size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+public:
+	//! Construction from the journal file and the number of bytes to read at a time.
+	explicit JournalReader(const tstring& filename, size_t blockSize = DEFAULT_BLOCK_SIZE); // throw(FileSystemException, InvalidArgException)
+
+	//! Destructor.
+	~JournalReader();
+
+	//
+	// Properties.
+	//
+
+	//! Get the offset just after the last valid record read.
+	ulonglong validSize() const;
+
+	//! Query if reading stopped at an incomplete or corrupt record.
+	bool isTorn() const;
+
+	//
+	// Methods.
+	//
+
+	//! Read the next valid record, if there is one.
+	bool readRecord(ByteRange& record); // throw(FileSystemException)
+
+private:
+	//! A buffer of bytes.
+	typedef std::vector<byte> ByteBuffer;
+
+	//
+	// Members.
+	//
+	tstring		m_filename;		//!< The journal file.
+	void*		m_file;			//!< The file handle.
+	size_t		m_blockSize;	//!< The number of bytes read at a time.
+	ByteBuffer	m_buffer;		//!< The bytes read from the file.
+	size_t		m_next;			//!< The offset of the next record in the buffer.
+	size_t		m_end;			//!< The end of the bytes in the buffer.
+	bool		m_eof;			//!< Has the end of the file been reached?
+	ulonglong	m_validSize;	//!< The offset after the last valid record.
+	bool		m_torn;			//!< Did reading stop at a torn record?
+	bool		m_stopped;		//!< Has reading stopped?
+
+	//
+	// Internal methods.
+	//
+
+	//! Ensure that the buffer holds the given number of unread bytes.
+	bool fill(size_t bytes);
+
+	// NotCopyable.
+	JournalReader(const JournalReader&);
+	JournalReader& operator=(const JournalReader&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the offset just after the last valid record read. Once all the records
+//! have been read this is the length of the intact part of the journal.
+
+inline ulonglong JournalReader::validSize() const
+{
+	return m_validSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if reading stopped at an incomplete or corrupt record rather than at
+//! the end of the file.
+
+inline bool JournalReader::isTorn() const
+{
+	return m_torn;
+}
+
+//namespace Core
+}
+
+#endif // CORE_JOURNALREADER_HPP
@@ -0,0 +1,320 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   JournalWriter.cpp
+//! \brief  The JournalWriter class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "JournalWriter.hpp"
+#include "JournalReader.hpp"
+#include "Win32Error.hpp"
+#include "FileSystemException.hpp"
+#include "InvalidArgException.hpp"
+#include "StringUtils.hpp"
+#include "Checksum.hpp"
+#include <windows.h>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Encode a 32 bit value as little-endian.
+
+static void writeUint32(uint value, byte* bytes)
+{
+	bytes[0] = static_cast<byte>(value & 0xFF);
+	bytes[1] = static_cast<byte>((value >> 8) & 0xFF);
+	bytes[2] = static_cast<byte>((value >> 16) & 0xFF);
+	bytes[3] = static_cast<byte>((value >> 24) & 0xFF);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Format the last WIN32 error when accessing the file.
+
+static tstring lastErrorMessage(const tchar* operation, const tstring& filename)
+{
+	DWORD   errorCode = ::GetLastError();
+	tstring errorText = formatWin32ErrorMessage(errorCode);
+
+	return Core::fmt(TXT("%s '%s' [0x%08lX - %s]"), operation, filename.c_str(), errorCode, errorText.c_str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+JournalWriter::Batch::Batch()
+	: m_records()
+	, m_written(Event::MANUAL_RESET)
+	, m_failed(false)
+	, m_error()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the journal file and the batching thresholds. The file is
+//! created if it does not exist. Any torn record at the end of an existing
+//! journal is truncated so that new records follow the last valid one. Once a
+//! batch has been started the flusher waits up to the maximum latency for
+//! more records, unless the batch reaches the maximum size first. A latency of
+//! zero writes each batch as soon as the previous one is durable.
+
+JournalWriter::JournalWriter(const tstring& filename, uint maxLatency, size_t maxBatchSize)
+	: m_filename(filename)
+	, m_file(INVALID_HANDLE_VALUE)
+	, m_maxLatency(maxLatency)
+	, m_maxBatchSize(maxBatchSize)
+	, m_lock()
+	, m_current(new Batch)
+	, m_error()
+	, m_stopping(false)
+	, m_wakeup(Event::AUTO_RESET)
+	, m_flusher()
+{
+	if (maxBatchSize == 0)
+		throw InvalidArgException(TXT("The maximum batch size cannot be zero"));
+
+	m_file = ::CreateFile(filename.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+							OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (m_file == INVALID_HANDLE_VALUE)
+		throw FileSystemException(lastErrorMessage(TXT("Failed to open file"), filename));
+
+	try
+	{
+		ulonglong validSize = 0;
+
+		{
+			JournalReader reader(filename);
+			ByteRange     record;
+
+			while (reader.readRecord(record))
+				;
+
+			validSize = reader.validSize();
+		}
+
+		LARGE_INTEGER offset;
+
+		offset.QuadPart = validSize;
+
+		if (!::SetFilePointerEx(m_file, offset, nullptr, FILE_BEGIN))
+			throw FileSystemException(lastErrorMessage(TXT("Failed to seek within file"), filename));
+
+		if (!::SetEndOfFile(m_file))
+			throw FileSystemException(lastErrorMessage(TXT("Failed to truncate file"), filename));
+
+		m_flusher.reset(new Thread(flushThread, this));
+	}
+	catch (...)
+	{
+		::CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+JournalWriter::~JournalWriter()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append a record and wait until it is durable. The record is added to the
+//! current batch and the calling thread blocks until the flusher has written
+//! and flushed the whole batch. If writing a batch fails, that batch and every
+//! later append fail with the same error.
+
+void JournalWriter::append(const void* data, size_t size)
+{
+	if (size > JournalReader::MAX_RECORD_SIZE)
+		throw InvalidArgException(Core::fmt(TXT("The record is too large to be written to journal '%s'"), m_filename.c_str()));
+
+	BatchPtr batch;
+	bool     wakeFlusher = false;
+
+	{
+		AutoLock lock(m_lock);
+
+		if (!m_error.empty())
+			throw FileSystemException(m_error);
+
+		if (m_stopping)
+			throw FileSystemException(Core::fmt(TXT("The journal '%s' has been closed"), m_filename.c_str()));
+
+		std::vector<byte>& records = m_current->m_records;
+		const size_t       offset = records.size();
+		const byte*        bytes = static_cast<const byte*>(data);
+
+		records.resize(offset + JournalReader::HEADER_SIZE);
+		records.insert(records.end(), bytes, bytes + size);
+
+		byte* header = &records[offset];
+
+		// The checksum covers the length as well as the contents.
+		writeUint32(static_cast<uint>(size), header);
+		writeUint32(crc32(bytes, size, crc32(header, 4)), header + 4);
+
+		// First record or batch full?
+		wakeFlusher = (offset == 0) || (records.size() >= m_maxBatchSize);
+
+		batch = m_current;
+	}
+
+	if (wakeFlusher)
+		m_wakeup.signal();
+
+	batch->m_written.wait();
+
+	if (batch->m_failed)
+		throw FileSystemException(batch->m_error);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write any outstanding records and close the file. The flusher is stopped
+//! once the final batch is durable.
+
+void JournalWriter::close()
+{
+	if (m_flusher.get() != nullptr)
+	{
+		{
+			AutoLock lock(m_lock);
+
+			m_stopping = true;
+		}
+
+		m_wakeup.signal();
+
+		try
+		{
+			m_flusher->join();
+		}
+		catch (...)
+		{
+			m_flusher.reset();
+			::CloseHandle(m_file);
+			m_file = INVALID_HANDLE_VALUE;
+			throw;
+		}
+
+		m_flusher.reset();
+	}
+
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		::CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write and flush a batch of records. FlushFileBuffers() is the equivalent of
+//! fsync() and only returns once the data has reached the disk.
+
+void JournalWriter::writeBatch(const Batch& batch)
+{
+	const byte* next = &batch.m_records.front();
+	const byte* end = next + batch.m_records.size();
+
+	while (next != end)
+	{
+		DWORD written = 0;
+
+		if (!::WriteFile(m_file, next, static_cast<DWORD>(end - next), &written, nullptr))
+			throw FileSystemException(lastErrorMessage(TXT("Failed to write to file"), m_filename));
+
+		next += written;
+	}
+
+	if (!::FlushFileBuffers(m_file))
+		throw FileSystemException(lastErrorMessage(TXT("Failed to flush file"), m_filename));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write batches until the journal is closed. The flusher sleeps until the
+//! first record of a batch arrives, optionally waits for more, and then swaps
+//! in an empty batch before writing the full one so that appends can continue
+//! whilst the disk is busy. Once a write has failed the journal is broken and
+//! every later batch fails without being written.
+
+void JournalWriter::flushBatches()
+{
+	for (;;)
+	{
+		m_wakeup.wait();
+
+		bool waitForMore = false;
+
+		{
+			AutoLock lock(m_lock);
+
+			waitForMore = (m_maxLatency != 0) && !m_stopping && (m_current->m_records.size() < m_maxBatchSize);
+		}
+
+		// Give other threads a chance to add to the batch.
+		if (waitForMore)
+			m_wakeup.wait(m_maxLatency);
+
+		BatchPtr batch;
+		bool     stopping = false;
+		tstring  error;
+
+		{
+			AutoLock lock(m_lock);
+
+			batch = m_current;
+			m_current = BatchPtr(new Batch);
+			stopping = m_stopping;
+			error = m_error;
+		}
+
+		if (!batch->m_records.empty())
+		{
+			if (error.empty())
+			{
+				try
+				{
+					writeBatch(*batch);
+				}
+				catch (const FileSystemException& e)
+				{
+					error = e.twhat();
+
+					AutoLock lock(m_lock);
+
+					m_error = error;
+				}
+			}
+
+			if (!error.empty())
+			{
+				batch->m_failed = true;
+				batch->m_error = error;
+			}
+
+			batch->m_written.signal();
+		}
+
+		if (stopping)
+			break;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The flusher thread function.
+
+void JournalWriter::flushThread(void* param)
+{
+	static_cast<JournalWriter*>(param)->flushBatches();
+}
+
+//namespace Core
+}
@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   JournalWriter.hpp
+//! \brief  The JournalWriter class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_JOURNALWRITER_HPP
+#define CORE_JOURNALWRITER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include "CriticalSection.hpp"
+#include "Event.hpp"
+#include "Thread.hpp"
+#include "SharedPtr.hpp"
+#include "UniquePtr.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Appends records to a journal file durably, using group commit. Any number
+//! of threads can append records, which are added to a shared batch. A single
+//! background thread writes and flushes each batch to disk and then wakes the
+//! threads whose records were in it. The records which arrive whilst a batch
+//! is being flushed form the next batch, so the number of flushes depends on
+//! the speed of the disk rather than the number of records. The records can be
+//! read back with a JournalReader.
+
+class JournalWriter /*: private NotCopyable*/
+{
+public:
+	//! The default time in milliseconds to wait for more records.
+	static const uint DEFAULT_MAX_LATENCY = 0;
+
+	//! The default size in bytes at which a batch is written without waiting.
+	static const size_t DEFAULT_MAX_BATCH_SIZE = 1024 * 1024;
+
+public:
+	//! Construction from the journal file and the batching thresholds.
+	explicit JournalWriter(const tstring& filename, uint maxLatency = DEFAULT_MAX_LATENCY, size_t maxBatchSize = DEFAULT_MAX_BATCH_SIZE); // throw(FileSystemException, InvalidArgException, RuntimeException)
+
+	//! Destructor.
+	~JournalWriter();
+
+	//
+	// Methods.
+	//
+
+	//! Append a record and wait until it is durable.
+	void append(const void* data, size_t size); // throw(FileSystemException, InvalidArgException)
+
+	//! Write any outstanding records and close the file.
+	void close(); // throw(FileSystemException)
+
+private:
+	//! A batch of records to be written together.
+	struct Batch
+	{
+		//! Default constructor.
+		Batch();
+
+		std::vector<byte>	m_records;	//!< The encoded records.
+		Event				m_written;	//!< Signalled once the batch is durable.
+		bool				m_failed;	//!< Did writing the batch fail?
+		tstring				m_error;	//!< The details of the failure.
+	};
+
+	//! The smart-pointer type used to share a batch.
+	typedef SharedPtr<Batch> BatchPtr;
+
+	//
+	// Members.
+	//
+	tstring				m_filename;		//!< The journal file.
+	void*				m_file;			//!< The file handle.
+	uint				m_maxLatency;	//!< The time to wait for more records.
+	size_t				m_maxBatchSize;	//!< The size at which a batch is written.
+	CriticalSection		m_lock;			//!< The lock for the current batch.
+	BatchPtr			m_current;		//!< The batch being filled.
+	tstring				m_error;		//!< The details of the first failed write.
+	bool				m_stopping;		//!< Should the flusher stop?
+	Event				m_wakeup;		//!< Used to wake the flusher.
+	UniquePtr<Thread>	m_flusher;		//!< The thread writing the batches.
+
+	//
+	// Internal methods.
+	//
+
+	//! Write and flush a batch of records.
+	void writeBatch(const Batch& batch);
+
+	//! Write batches until the journal is closed.
+	void flushBatches();
+
+	//! The flusher thread function.
+	static void flushThread(void* param);
+
+	// NotCopyable.
+	JournalWriter(const JournalWriter&);
+	JournalWriter& operator=(const JournalWriter&);
+};
+
+//namespace Core
+}
+
+#endif // CORE_JOURNALWRITER_HPP
@@ -0,0 +1,328 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   LineIndex.cpp
+//! \brief  The LineIndex class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "LineIndex.hpp"
+#include "Win32Error.hpp"
+#include "FileSystemException.hpp"
+#include "InvalidArgException.hpp"
+#include "StringUtils.hpp"
+#include <windows.h>
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The number of bytes read at a time when building the index.
+
+static const size_t READ_BLOCK_SIZE = 1024 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+//! The characters that identify an index file.
+
+static const char INDEX_MAGIC[8] = { 'L', 'I', 'N', 'E', 'I', 'N', 'D', 'X' };
+
+////////////////////////////////////////////////////////////////////////////////
+//! The version of the index file format.
+
+static const ulonglong INDEX_VERSION = 1;
+
+////////////////////////////////////////////////////////////////////////////////
+//! The layout of the index file header, which is followed by the offsets.
+
+struct IndexHeader
+{
+	char		m_magic[8];		//!< The file identifier.
+	ulonglong	m_version;		//!< The file format version.
+	ulonglong	m_fileSize;		//!< The size of the indexed file.
+	ulonglong	m_lastWrite;	//!< The last write time of the indexed file.
+	ulonglong	m_interval;		//!< The number of lines between samples.
+	ulonglong	m_lineCount;	//!< The number of lines in the indexed file.
+	ulonglong	m_offsets;		//!< The number of offsets that follow.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Open the file for shared, read-only access. Returns INVALID_HANDLE_VALUE
+//! on failure.
+
+static HANDLE openForReading(const tstring& filename)
+{
+	return ::CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+						OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query the size and last write time of the file used to detect changes.
+
+static void queryFileStamp(HANDLE file, const tstring& filename, ulonglong& size, ulonglong& lastWrite)
+{
+	LARGE_INTEGER fileSize;
+	FILETIME      writeTime;
+
+	if (!::GetFileSizeEx(file, &fileSize))
+		throwLastError(TXT("Failed to query the size of file"), filename);
+
+	if (!::GetFileTime(file, nullptr, nullptr, &writeTime))
+		throwLastError(TXT("Failed to query the last write time of file"), filename);
+
+	size = fileSize.QuadPart;
+	lastWrite = (static_cast<ulonglong>(writeTime.dwHighDateTime) << 32) | writeTime.dwLowDateTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+LineIndex::LineIndex()
+	: m_fileSize(0)
+	, m_lastWrite(0)
+	, m_interval(DEFAULT_INTERVAL)
+	, m_lineCount(0)
+	, m_offsets(1, 0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+LineIndex::~LineIndex()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Build the index by scanning the file once. The newlines are found with
+//! memchr(), which the CRT vectorises, rather than by examining each byte.
+
+void LineIndex::build(const tstring& filename, size_t interval)
+{
+	if (interval == 0)
+		throw InvalidArgException(TXT("The index interval cannot be zero"));
+
+	HandlePtr file(openForReading(filename), closeHandle);
+
+	if (file.get() == INVALID_HANDLE_VALUE)
+	{
+		file.detach();
+		throwLastError(TXT("Failed to open file"), filename);
+	}
+
+	ulonglong fileSize = 0;
+	ulonglong lastWrite = 0;
+
+	queryFileStamp(file.get(), filename, fileSize, lastWrite);
+
+	std::vector<char> buffer(READ_BLOCK_SIZE);
+	Offsets           offsets(1, 0);
+	ulonglong         lines = 0;
+	ulonglong         position = 0;
+	char              last = '\n';
+
+	// Only index the file as it was when stamped.
+	while (position != fileSize)
+	{
+		const DWORD size = static_cast<DWORD>(std::min<ulonglong>(buffer.size(), fileSize - position));
+		DWORD       read = 0;
+
+		if (!::ReadFile(file.get(), &buffer.front(), size, &read, nullptr))
+			throwLastError(TXT("Failed to read from file"), filename);
+
+		if (read == 0)
+			break;
+
+		const char* begin = &buffer.front();
+		const char* end = begin + read;
+
+		for (const char* next = begin; next != end; )
+		{
+			const char* newline = static_cast<const char*>(memchr(next, '\n', end - next));
+
+			if (newline == nullptr)
+				break;
+
+			next = newline + 1;
+
+			if ((++lines % interval) == 0)
+				offsets.push_back(position + (next - begin));
+		}
+
+		last = *(end-1);
+		position += read;
+	}
+
+	// Final line without a terminator?
+	if (last != '\n')
+		++lines;
+
+	// Drop a sample for the line after a trailing terminator.
+	if ( (offsets.size() > 1) && (offsets.back() == position) )
+		offsets.pop_back();
+
+	m_fileSize = position;
+	m_lastWrite = lastWrite;
+	m_interval = interval;
+	m_lineCount = lines;
+	m_offsets.swap(offsets);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Load the index from a file. Returns false, leaving the index unchanged, if
+//! the index file is missing, is not a valid index file or the indexed file
+//! has changed size or been written to since the index was built.
+
+bool LineIndex::load(const tstring& indexFile, const tstring& filename)
+{
+	HandlePtr file(openForReading(filename), closeHandle);
+
+	if (file.get() == INVALID_HANDLE_VALUE)
+	{
+		file.detach();
+		throwLastError(TXT("Failed to open file"), filename);
+	}
+
+	ulonglong fileSize = 0;
+	ulonglong lastWrite = 0;
+
+	queryFileStamp(file.get(), filename, fileSize, lastWrite);
+
+	HandlePtr index(openForReading(indexFile), closeHandle);
+
+	if (index.get() == INVALID_HANDLE_VALUE)
+	{
+		index.detach();
+		return false;
+	}
+
+	IndexHeader header;
+	DWORD       read = 0;
+
+	if (!::ReadFile(index.get(), &header, sizeof(header), &read, nullptr) || (read != sizeof(header)))
+		return false;
+
+	if ( (memcmp(header.m_magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) || (header.m_version != INDEX_VERSION)
+	  || (header.m_interval == 0) || (header.m_offsets == 0) )
+		return false;
+
+	if ( (header.m_fileSize != fileSize) || (header.m_lastWrite != lastWrite) )
+		return false;
+
+	LARGE_INTEGER indexSize;
+
+	if (!::GetFileSizeEx(index.get(), &indexSize))
+		throwLastError(TXT("Failed to query the size of file"), indexFile);
+
+	const ulonglong expected = sizeof(header) + (header.m_offsets * sizeof(ulonglong));
+
+	if ( (static_cast<ulonglong>(indexSize.QuadPart) != expected) || (header.m_offsets > header.m_lineCount + 1) )
+		return false;
+
+	Offsets offsets(static_cast<size_t>(header.m_offsets));
+	DWORD   size = static_cast<DWORD>(offsets.size() * sizeof(ulonglong));
+
+	if (!::ReadFile(index.get(), &offsets.front(), size, &read, nullptr) || (read != size))
+		return false;
+
+	m_fileSize = header.m_fileSize;
+	m_lastWrite = header.m_lastWrite;
+	m_interval = static_cast<size_t>(header.m_interval);
+	m_lineCount = header.m_lineCount;
+	m_offsets.swap(offsets);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Save the index to a file, replacing any existing one. A partially written
+//! file is deleted so that it cannot be mistaken for a valid index.
+
+void LineIndex::save(const tstring& indexFile) const
+{
+	HandlePtr file(::CreateFile(indexFile.c_str(), GENERIC_WRITE, 0, nullptr,
+								CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr), closeHandle);
+
+	if (file.get() == INVALID_HANDLE_VALUE)
+	{
+		file.detach();
+		throwLastError(TXT("Failed to create file"), indexFile);
+	}
+
+	IndexHeader header;
+
+	memcpy(header.m_magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+	header.m_version = INDEX_VERSION;
+	header.m_fileSize = m_fileSize;
+	header.m_lastWrite = m_lastWrite;
+	header.m_interval = m_interval;
+	header.m_lineCount = m_lineCount;
+	header.m_offsets = m_offsets.size();
+
+	const DWORD size = static_cast<DWORD>(m_offsets.size() * sizeof(ulonglong));
+	DWORD       written = 0;
+
+	try
+	{
+		if (!::WriteFile(file.get(), &header, sizeof(header), &written, nullptr) || (written != sizeof(header)))
+			throwLastError(TXT("Failed to write to file"), indexFile);
+
+		if (!::WriteFile(file.get(), &m_offsets.front(), size, &written, nullptr) || (written != size))
+			throwLastError(TXT("Failed to write to file"), indexFile);
+	}
+	catch (...)
+	{
+		file.reset();
+		::DeleteFile(indexFile.c_str());
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Load the index from its sidecar file if it is still valid, otherwise build
+//! it and try to save it for next time. Failing to save the sidecar file, e.g.
+//! because the folder is read-only, is not an error.
+
+void LineIndex::loadOrBuild(const tstring& filename, size_t interval)
+{
+	const tstring indexFile = sidecarFile(filename);
+
+	if (load(indexFile, filename))
+		return;
+
+	build(filename, interval);
+
+	try
+	{
+		save(indexFile);
+	}
+	catch (const FileSystemException& /*e*/)
+	{
+		// Carry on without the sidecar file.
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Find the nearest sampled line at or before the line. The byte offset of
+//! the sampled line is returned via the output parameter.
+
+ulonglong LineIndex::findLine(ulonglong line, ulonglong& offset) const
+{
+	ASSERT(!m_offsets.empty());
+
+	const size_t sample = static_cast<size_t>(std::min<ulonglong>(line / m_interval, m_offsets.size()-1));
+
+	offset = m_offsets[sample];
+
+	return static_cast<ulonglong>(sample) * m_interval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the path of the sidecar index file for a file, which is the file's
+//! path with an extra ".idx" extension.
+
+tstring LineIndex::sidecarFile(const tstring& filename)
+{
+	return filename + TXT(".idx");
+}
+
+//namespace Core
+}
@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   LineIndex.hpp
+//! \brief  The LineIndex class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_LINEINDEX_HPP
+#define CORE_LINEINDEX_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! An index of the byte offsets of the lines in a text file, which allows a
+//! reader to jump close to any line without reading the lines before it. The
+//! offset of every Nth line is sampled, so finding a line needs at most N-1
+//! lines to be skipped. The index can be saved alongside the file and later
+//! reloaded, as long as the file's size and last write time are unchanged.
+
+class LineIndex
+{
+public:
+	//! The default number of lines between each sampled offset.
+	static const size_t DEFAULT_INTERVAL = 1024;
+
+public:
+	//! Default constructor.
+	LineIndex();
+
+	//! Destructor.
+	~LineIndex();
+
+	//
+	// Properties.
+	//
+
+	//! Get the size of the file when it was indexed.
+	ulonglong fileSize() const;
+
+	//! Get the number of lines in the file.
+	ulonglong lineCount() const;
+
+	//! Get the number of lines between each sampled offset.
+	size_t interval() const;
+
+	//
+	// Methods.
+	//
+
+	//! Build the index by scanning the file.
+	void build(const tstring& filename, size_t interval = DEFAULT_INTERVAL); // throw(FileSystemException, InvalidArgException)
+
+	//! Load the index from a file, if it is still valid for the indexed file.
+	bool load(const tstring& indexFile, const tstring& filename); // throw(FileSystemException)
+
+	//! Save the index to a file.
+	void save(const tstring& indexFile) const; // throw(FileSystemException)
+
+	//! Load the index from its sidecar file, or build and save it.
+	void loadOrBuild(const tstring& filename, size_t interval = DEFAULT_INTERVAL); // throw(FileSystemException, InvalidArgException)
+
+	//! Find the nearest sampled line at or before the line.
+	ulonglong findLine(ulonglong line, ulonglong& offset) const;
+
+	//
+	// Class methods.
+	//
+
+	//! Get the path of the sidecar index file for a file.
+	static tstring sidecarFile(const tstring& filename);
+
+private:
+	//! The sampled line offsets.
+	typedef std::vector<ulonglong> Offsets;
+
+	//
+	// Members.
+	//
+	ulonglong	m_fileSize;		//!< The size of the file when indexed.
+	ulonglong	m_lastWrite;	//!< The last write time of the file when indexed.
+	size_t		m_interval;		//!< The number of lines between samples.
+	ulonglong	m_lineCount;	//!< The number of lines in the file.
+	Offsets		m_offsets;		//!< The offset of every Nth line.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the size of the file when it was indexed.
+
+inline ulonglong LineIndex::fileSize() const
+{
+	return m_fileSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of lines in the file. As with LineReader, the final line
+//! does not need a terminator.
+
+inline ulonglong LineIndex::lineCount() const
+{
+	return m_lineCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of lines between each sampled offset.
+
+inline size_t LineIndex::interval() const
+{
+	return m_interval;
+}
+
+//namespace Core
+}
+
+#endif // CORE_LINEINDEX_HPP
@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   LineIterator.cpp
+//! \brief  The LineIterator class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "LineIterator.hpp"
+#include "BadLogicException.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Constructor for the End iterator.
+
+LineIterator::LineIterator()
+	: m_reader()
+	, m_value()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Constructor for the Begin iterator.
+
+LineIterator::LineIterator(const LineReaderPtr& reader)
+	: m_reader(reader)
+	, m_value()
+{
+	ASSERT(m_reader.get() != nullptr);
+
+	increment();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+LineIterator::~LineIterator()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Dereference operator.
+
+const TextRange& LineIterator::operator*() const
+{
+	if (m_reader.get() == nullptr)
+		throw BadLogicException(TXT("Attempted to dereference end iterator"));
+
+	return m_value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Pointer-to-member operator.
+
+const TextRange* LineIterator::operator->() const
+{
+	if (m_reader.get() == nullptr)
+		throw BadLogicException(TXT("Attempted to dereference end iterator"));
+
+	return &m_value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare to another iterator for equivalence.
+
+bool LineIterator::equals(const LineIterator& rhs) const
+{
+	if (m_reader.get() == nullptr)
+		return (rhs.m_reader.get() == nullptr);
+
+	return (m_reader.get() == rhs.m_reader.get());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move the iterator forward.
+
+void LineIterator::increment()
+{
+	if (m_reader.get() == nullptr)
+		throw BadLogicException(TXT("Attempted to increment end iterator"));
+
+	if (!m_reader->readLine(m_value))
+	{
+		m_reader.reset();
+		m_value = TextRange();
+	}
+}
+
+//namespace Core
+}
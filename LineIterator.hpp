@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   LineIterator.hpp
+//! \brief  The LineIterator class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_LINEITERATOR_HPP
+#define CORE_LINEITERATOR_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "LineReader.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The iterator type used to read lines of text from a LineReader. Unlike the
+//! TextFileIterator each line is a view which is only valid until the iterator
+//! is next advanced.
+
+class LineIterator
+{
+public:
+	//! Constructor for the End iterator.
+	LineIterator();
+
+	//! Constructor for the Begin iterator.
+	explicit LineIterator(const LineReaderPtr& reader);
+
+	//! Destructor.
+	~LineIterator();
+
+	//
+	// Operators.
+	//
+
+	//! Dereference operator.
+	const TextRange& operator*() const;
+
+	//! Pointer-to-member operator.
+	const TextRange* operator->() const;
+
+	//! Advance the iterator.
+	LineIterator& operator++();
+
+	//
+	// Methods.
+	//
+
+	//! Compare to another iterator for equivalence.
+	bool equals(const LineIterator& rhs) const;
+
+private:
+	//
+	// Members.
+	//
+	LineReaderPtr	m_reader;	//!< The underlying line reader.
+	TextRange		m_value;	//!< The current iterator value.
+
+	//
+	// Internal methods.
+	//
+
+	//! Move the iterator forward.
+	void increment();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Advance the iterator.
+
+inline LineIterator& LineIterator::operator++()
+{
+	increment();
+
+	return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare two iterators for equivalence.
+
+inline bool operator==(const LineIterator& lhs, const LineIterator& rhs)
+{
+	return lhs.equals(rhs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare two iterators for difference.
+
+inline bool operator!=(const LineIterator& lhs, const LineIterator& rhs)
+{
+	return !lhs.equals(rhs);
+}
+
+//namespace Core
+}
+
+#endif // CORE_LINEITERATOR_HPP
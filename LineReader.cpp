@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   LineReader.cpp
+//! \brief  The LineReader class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "LineReader.hpp"
+#include "AnsiWide.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+LineReader::LineReader()
+	: m_next(nullptr)
+	, m_end(nullptr)
+	, m_partial()
+	, m_clearPartial(false)
+	, m_widened()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+LineReader::~LineReader()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the next line, if there is one. For a UNICODE build the line is
+//! widened into a buffer that is reused for each line.
+
+bool LineReader::readLine(TextRange& line)
+{
+	const char* begin = nullptr;
+	const char* end = nullptr;
+
+	if (!readAnsiLine(begin, end))
+		return false;
+
+#ifdef ANSI_BUILD
+	line = TextRange(begin, end);
+#else
+	const size_t length = end - begin;
+
+	if (m_widened.size() < length)
+		m_widened.resize(length);
+
+	if (length != 0)
+		ansiToWide(begin, end, &m_widened.front());
+
+	line = TextRange((length != 0) ? &m_widened.front() : TXT(""), length);
+#endif
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the next line as its ANSI characters, if there is one, such as when
+//! the bytes of a line matter rather than its text. The current block is
+//! scanned in place for the next newline. When the block runs out first, the
+//! start of the line is copied aside before fetching the next block, as the
+//! previous block is no longer valid after that.
+
+bool LineReader::readAnsiLine(const char*& lineBegin, const char*& lineEnd)
+{
+	if (m_clearPartial)
+	{
+		m_partial.clear();
+		m_clearPartial = false;
+	}
+
+	for (;;)
+	{
+		if (m_next != m_end)
+		{
+			const size_t remaining = m_end - m_next;
+			const char*  newline = static_cast<const char*>(memchr(m_next, '\n', remaining));
+
+			if (newline != nullptr)
+			{
+				const char* begin = m_next;
+
+				m_next = newline + 1;
+
+				// Line is wholly within the block?
+				if (m_partial.empty())
+				{
+					setLine(begin, newline, lineBegin, lineEnd);
+				}
+				else
+				{
+					m_partial.insert(m_partial.end(), begin, newline);
+					setLine(&m_partial.front(), &m_partial.front() + m_partial.size(), lineBegin, lineEnd);
+					m_clearPartial = true;
+				}
+
+				return true;
+			}
+
+			m_partial.insert(m_partial.end(), m_next, m_end);
+			m_next = m_end;
+		}
+
+		if (!nextBlock(m_next, m_end))
+			break;
+	}
+
+	m_next = m_end = nullptr;
+
+	// Final line without a terminator?
+	if (!m_partial.empty())
+	{
+		setLine(&m_partial.front(), &m_partial.front() + m_partial.size(), lineBegin, lineEnd);
+		m_clearPartial = true;
+		return true;
+	}
+
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Discard the current block and any partial line. This is for a derived
+//! class that repositions its source so that the next line is read from the
+//! start of the next block.
+
+void LineReader::reset()
+{
+	m_next = m_end = nullptr;
+	m_partial.clear();
+	m_clearPartial = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Return the line, trimming any trailing CR.
+
+void LineReader::setLine(const char* begin, const char* end, const char*& lineBegin, const char*& lineEnd)
+{
+	if ( (begin != end) && (*(end-1) == '\r') )
+		--end;
+
+	lineBegin = begin;
+	lineEnd = end;
+}
+
+//namespace Core
+}
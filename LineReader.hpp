@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   LineReader.hpp
+//! \brief  The LineReader class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_LINEREADER_HPP
+#define CORE_LINEREADER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include "Range.hpp"
+#include "SharedPtr.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The base class for reading lines of ANSI text from a sequence of blocks of
+//! characters. Each line is returned as a view which remains valid until the
+//! next line is read. Lines are terminated by either "\n" or "\r\n" and the
+//! final line does not need a terminator. A line is only copied when it
+//! straddles two blocks, or when widening it for a UNICODE build.
+
+class LineReader /*: private NotCopyable*/
+{
+public:
+	//! Destructor.
+	virtual ~LineReader();
+
+	//
+	// Methods.
+	//
+
+	//! Read the next line, if there is one.
+	bool readLine(TextRange& line);
+
+	//! Read the next line as its ANSI characters, if there is one.
+	bool readAnsiLine(const char*& begin, const char*& end);
+
+protected:
+	//! Default constructor.
+	LineReader();
+
+	//
+	// Derived class methods.
+	//
+
+	//! Get the next block of characters, if there is one.
+	virtual bool nextBlock(const char*& begin, const char*& end) = 0;
+
+	//
+	// Internal methods.
+	//
+
+	//! Discard the current block and any partial line.
+	void reset();
+
+private:
+	//! A buffer of characters.
+	typedef std::vector<char> CharBuffer;
+	//! A buffer of build specific characters.
+	typedef std::vector<tchar> TCharBuffer;
+
+	//
+	// Members.
+	//
+	const char*	m_next;			//!< The start of the next line in the block.
+	const char*	m_end;			//!< The end of the current block.
+	CharBuffer	m_partial;		//!< The start of a line that straddles blocks.
+	bool		m_clearPartial;	//!< Was the partial line returned last time?
+	TCharBuffer	m_widened;		//!< The last line converted to UNICODE.
+
+	//
+	// Internal methods.
+	//
+
+	//! Return the line, trimming any trailing CR.
+	void setLine(const char* begin, const char* end, const char*& lineBegin, const char*& lineEnd);
+
+	// NotCopyable.
+	LineReader(const LineReader&);
+	LineReader& operator=(const LineReader&);
+};
+
+//! The default LineReader smart-pointer type.
+typedef SharedPtr<LineReader> LineReaderPtr;
+
+//namespace Core
+}
+
+#endif // CORE_LINEREADER_HPP
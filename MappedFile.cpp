@@ -0,0 +1,236 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   MappedFile.cpp
+//! \brief  The MappedFile class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "MappedFile.hpp"
+#include "Win32Error.hpp"
+#include "FileSystemException.hpp"
+#include "StringUtils.hpp"
+#include <windows.h>
+#include <limits>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the file flags that tell the cache manager how the file will be read.
+//! This is the closest Windows comes to madvise() for a mapped file.
+
+static DWORD hintFlags(MappedFile::Hint hint)
+{
+	if (hint == MappedFile::SEQUENTIAL)
+		return FILE_FLAG_SEQUENTIAL_SCAN;
+
+	if (hint == MappedFile::RANDOM)
+		return FILE_FLAG_RANDOM_ACCESS;
+
+	return FILE_ATTRIBUTE_NORMAL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the path of the file to map, the type of access and the
+//! expected pattern of access. A read-only file is opened for shared read
+//! access whereas a writable one is created if it does not exist. The whole
+//! file is mapped. An empty file cannot be mapped and so has no view until it
+//! is resized.
+
+MappedFile::MappedFile(const tstring& filename, Access access, Hint hint)
+	: m_filename(filename)
+	, m_access(access)
+	, m_file(INVALID_HANDLE_VALUE)
+	, m_mapping(nullptr)
+	, m_view(nullptr)
+	, m_size(0)
+{
+	if (m_access == READ_WRITE)
+	{
+		m_file = ::CreateFile(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+								OPEN_ALWAYS, hintFlags(hint), nullptr);
+	}
+	else
+	{
+		m_file = ::CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+								OPEN_EXISTING, hintFlags(hint), nullptr);
+	}
+
+	if (m_file == INVALID_HANDLE_VALUE)
+		throwLastError(TXT("Failed to open file"), filename);
+
+	try
+	{
+		LARGE_INTEGER size;
+
+		if (!::GetFileSizeEx(m_file, &size))
+			throwLastError(TXT("Failed to query the size of file"), filename);
+
+		if (static_cast<ulonglong>(size.QuadPart) > std::numeric_limits<size_t>::max())
+			throw FileSystemException(Core::fmt(TXT("The file '%s' is too large to be mapped"), filename.c_str()));
+
+		m_size = static_cast<size_t>(size.QuadPart);
+
+		map();
+	}
+	catch (...)
+	{
+		close();
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the entire file into memory ahead of it being accessed by touching
+//! every page, so that the page faults happen now rather than later.
+
+void MappedFile::prefault() const
+{
+	SYSTEM_INFO info;
+
+	::GetSystemInfo(&info);
+
+	const size_t   pageSize = info.dwPageSize;
+	volatile byte  sum = 0;
+
+	for (size_t offset = 0; offset < m_size; offset += pageSize)
+		sum ^= m_view[offset];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Change the size of the file and remap the view. Any pointers into the old
+//! view are invalidated. Growing the file zero fills the new space. The file
+//! must have been mapped for READ_WRITE access. If the size cannot be changed
+//! the original view is remapped, and if that or mapping the new size fails
+//! the view is left empty.
+
+void MappedFile::resize(size_t size)
+{
+	if (m_access != READ_WRITE)
+		throw FileSystemException(Core::fmt(TXT("Cannot resize the read-only mapping of file '%s'"), m_filename.c_str()));
+
+	// The file cannot be truncated whilst a view of it is mapped.
+	unmap();
+
+	try
+	{
+		LARGE_INTEGER offset;
+
+		offset.QuadPart = size;
+
+		if (!::SetFilePointerEx(m_file, offset, nullptr, FILE_BEGIN))
+			throwLastError(TXT("Failed to seek within file"), m_filename);
+
+		if (!::SetEndOfFile(m_file))
+			throwLastError(TXT("Failed to resize file"), m_filename);
+	}
+	catch (...)
+	{
+		try
+		{
+			map();
+		}
+		catch (...)
+		{
+			unmap();
+			m_size = 0;
+		}
+
+		throw;
+	}
+
+	m_size = size;
+
+	try
+	{
+		map();
+	}
+	catch (...)
+	{
+		unmap();
+		m_size = 0;
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write any modified pages to the disk, waiting for them to be written.
+
+void MappedFile::flush()
+{
+	if (m_access != READ_WRITE)
+		return;
+
+	if ( (m_view != nullptr) && !::FlushViewOfFile(m_view, 0) )
+		throwLastError(TXT("Failed to flush the view of file"), m_filename);
+
+	if (!::FlushFileBuffers(m_file))
+		throwLastError(TXT("Failed to flush file"), m_filename);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Map a view of the whole file, unless it is empty.
+
+void MappedFile::map()
+{
+	if (m_size == 0)
+		return;
+
+	const bool  writable = (m_access == READ_WRITE);
+	const DWORD protect = writable ? PAGE_READWRITE : PAGE_READONLY;
+	const DWORD access = writable ? FILE_MAP_WRITE : FILE_MAP_READ;
+
+	m_mapping = ::CreateFileMapping(m_file, nullptr, protect, 0, 0, nullptr);
+
+	if (m_mapping == nullptr)
+		throwLastError(TXT("Failed to create a mapping for file"), m_filename);
+
+	m_view = static_cast<byte*>(::MapViewOfFile(m_mapping, access, 0, 0, 0));
+
+	if (m_view == nullptr)
+		throwLastError(TXT("Failed to map a view of file"), m_filename);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Unmap the view and close the mapping.
+
+void MappedFile::unmap()
+{
+	if (m_view != nullptr)
+	{
+		::UnmapViewOfFile(m_view);
+		m_view = nullptr;
+	}
+
+	if (m_mapping != nullptr)
+	{
+		::CloseHandle(m_mapping);
+		m_mapping = nullptr;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Unmap the view and close the handles.
+
+void MappedFile::close()
+{
+	unmap();
+
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		::CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+	}
+
+	m_size = 0;
+}
+
+//namespace Core
+}
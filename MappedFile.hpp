@@ -0,0 +1,182 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   MappedFile.hpp
+//! \brief  The MappedFile class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_MAPPEDFILE_HPP
+#define CORE_MAPPEDFILE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Range.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A view of an entire file mapped into memory, which is unmapped when the
+//! object is destroyed. The file must be small enough to fit within the
+//! process's address space. A writable mapping can also be resized, which
+//! remaps the view, and so invalidates any pointers into it.
+
+class MappedFile /*: private NotCopyable*/
+{
+public:
+	//! The type of access to the file.
+	enum Access
+	{
+		READ_ONLY,	//!< Map an existing file for reading.
+		READ_WRITE,	//!< Map a file for reading and writing, creating it if necessary.
+	};
+
+	//! The expected pattern of access to the file's contents.
+	enum Hint
+	{
+		NORMAL,		//!< No particular pattern.
+		SEQUENTIAL,	//!< Mostly from beginning to end.
+		RANDOM,		//!< Mostly at random.
+	};
+
+public:
+	//! Construction from the path of the file to map.
+	explicit MappedFile(const tstring& filename, Access access = READ_ONLY, Hint hint = SEQUENTIAL); // throw(FileSystemException)
+
+	//! Destructor.
+	~MappedFile();
+
+	//
+	// Properties.
+	//
+
+	//! Query if the mapping can be written to.
+	bool isWritable() const;
+
+	//! Get the start of the file's contents.
+	const byte* begin() const;
+
+	//! Get the end of the file's contents.
+	const byte* end() const;
+
+	//! Get the start of the file's contents for writing.
+	byte* data();
+
+	//! Get the size of the file.
+	size_t size() const;
+
+	//! Get the file's contents as a range of bytes.
+	ByteRange bytes() const;
+
+	//! Get the file's contents as a range of characters.
+	TextRange text() const;
+
+	//
+	// Methods.
+	//
+
+	//! Read the entire file into memory ahead of it being accessed.
+	void prefault() const;
+
+	//! Change the size of the file and remap the view.
+	void resize(size_t size); // throw(FileSystemException)
+
+	//! Write any modified pages to the disk.
+	void flush(); // throw(FileSystemException)
+
+private:
+	//
+	// Members.
+	//
+	tstring		m_filename;		//!< The path of the file.
+	Access		m_access;		//!< The type of access.
+	void*		m_file;			//!< The file handle.
+	void*		m_mapping;		//!< The file mapping handle.
+	byte*		m_view;			//!< The start of the mapped view.
+	size_t		m_size;			//!< The size of the file.
+
+	//
+	// Internal methods.
+	//
+
+	//! Map a view of the whole file.
+	void map();
+
+	//! Unmap the view and close the mapping.
+	void unmap();
+
+	//! Unmap the view and close the handles.
+	void close();
+
+	// NotCopyable.
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the mapping can be written to.
+
+inline bool MappedFile::isWritable() const
+{
+	return (m_access == READ_WRITE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the start of the file's contents.
+
+inline const byte* MappedFile::begin() const
+{
+	return m_view;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the end of the file's contents.
+
+inline const byte* MappedFile::end() const
+{
+	return m_view + m_size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the start of the file's contents for writing. The file must have been
+//! mapped for READ_WRITE access.
+
+inline byte* MappedFile::data()
+{
+	ASSERT(isWritable());
+
+	return m_view;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the size of the file.
+
+inline size_t MappedFile::size() const
+{
+	return m_size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the file's contents as a range of bytes.
+
+inline ByteRange MappedFile::bytes() const
+{
+	return ByteRange(m_view, m_view + m_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the file's contents as a range of characters. For a UNICODE build any
+//! odd trailing byte is excluded.
+
+inline TextRange MappedFile::text() const
+{
+	const tchar* begin = reinterpret_cast<const tchar*>(m_view);
+
+	return TextRange(begin, begin + (m_size / sizeof(tchar)));
+}
+
+//namespace Core
+}
+
+#endif // CORE_MAPPEDFILE_HPP
@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   MappedLineReader.cpp
+//! \brief  The MappedLineReader class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "MappedLineReader.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the path of the file to read.
+
+MappedLineReader::MappedLineReader(const tstring& filename)
+	: m_file(filename)
+	, m_mapped(false)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+MappedLineReader::~MappedLineReader()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the next block of characters, if there is one. The entire mapping is
+//! returned as a single block.
+
+bool MappedLineReader::nextBlock(const char*& begin, const char*& end)
+{
+	if (m_mapped || (m_file.size() == 0))
+		return false;
+
+	begin = reinterpret_cast<const char*>(m_file.begin());
+	end = reinterpret_cast<const char*>(m_file.end());
+	m_mapped = true;
+
+	return true;
+}
+
+//namespace Core
+}
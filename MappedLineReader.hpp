@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   MappedLineReader.hpp
+//! \brief  The MappedLineReader class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_MAPPEDLINEREADER_HPP
+#define CORE_MAPPEDLINEREADER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "LineReader.hpp"
+#include "MappedFile.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A LineReader that maps the entire file into memory. For an ANSI build each
+//! line is a view directly onto the mapping and so no line is ever copied.
+
+class MappedLineReader : public LineReader
+{
+public:
+	//! Construction from the path of the file to read.
+	explicit MappedLineReader(const tstring& filename); // throw(FileSystemException)
+
+	//! Destructor.
+	virtual ~MappedLineReader();
+
+private:
+	//
+	// Members.
+	//
+	MappedFile	m_file;		//!< The mapped file.
+	bool		m_mapped;	//!< Has the mapping been returned as a block?
+
+	//
+	// LineReader methods.
+	//
+
+	//! Get the next block of characters, if there is one.
+	virtual bool nextBlock(const char*& begin, const char*& end);
+};
+
+//namespace Core
+}
+
+#endif // CORE_MAPPEDLINEREADER_HPP
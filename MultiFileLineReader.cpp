@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   MultiFileLineReader.cpp
+//! \brief  The MultiFileLineReader class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "MultiFileLineReader.hpp"
+#include "FileSystem.hpp"
+#include "DirectoryIterator.hpp"
+#include "InvalidArgException.hpp"
+#include "CriticalSection.hpp"
+#include "Thread.hpp"
+#include "CapturedException.hpp"
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Find the files in the folder which match the wildcard, sorted by name. A
+//! missing folder is an error, but no matches is not.
+
+static void findFiles(const tstring& folder, const tstring& mask, MultiFileLineReader::Filenames& filenames)
+{
+	DirectoryIterator it(folder, mask);
+	DirectoryEntry    entry;
+
+	while (it.next(entry))
+	{
+		if (!entry.isFolder())
+			filenames.push_back(combinePaths(folder, entry.name()));
+	}
+
+	std::sort(filenames.begin(), filenames.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The state shared between the worker threads when processing in parallel.
+
+struct FileWorkerContext
+{
+	MultiFileLineReader::Handler*	m_handler;	//!< The file handler.
+	BatchFileReader*				m_files;	//!< The reader for the files.
+	CriticalSection					m_lock;		//!< The lock for the reader and failure.
+	CapturedException				m_failure;	//!< The first exception thrown by a worker.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the folder, wildcard and number of files to read ahead.
+//! The folder is searched straight away, but the files are not read until
+//! the first line is requested or the files are processed.
+
+MultiFileLineReader::MultiFileLineReader(const tstring& folder, const tstring& mask, size_t prefetch)
+	: m_filenames()
+	, m_prefetch(prefetch)
+	, m_files()
+	, m_lines()
+	, m_current(0)
+{
+	if (prefetch == 0)
+		throw InvalidArgException(TXT("The number of files to read ahead cannot be zero"));
+
+	findFiles(folder, mask, m_filenames);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+MultiFileLineReader::~MultiFileLineReader()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the next line and the index of its file, if there is one. The line
+//! remains valid until the next line is read. If a file could not be read the
+//! error is thrown when its first line would have been returned; the lines of
+//! the remaining files can still be read by calling this method again.
+
+bool MultiFileLineReader::readLine(TextRange& line, size_t& file)
+{
+	if (m_files.get() == nullptr)
+		m_files.reset(new BatchFileReader(m_filenames, m_prefetch, m_prefetch, BatchFileReader::ORDERED));
+
+	for (;;)
+	{
+		if ( (m_lines.get() != nullptr) && m_lines->readLine(line) )
+		{
+			file = m_current;
+			return true;
+		}
+
+		m_lines.reset();
+
+		if (!m_files->nextFile(m_current, m_lines))
+			return false;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Process the files in parallel. Each worker thread takes the next file that
+//! has been read and passes its lines to the handler. If the number of threads
+//! is zero one is used per processor. If a file cannot be read, or the handler
+//! throws an exception, the workers stop taking files and the first failure is
+//! rethrown with its original type on the calling thread once they have all
+//! finished.
+
+void MultiFileLineReader::process(Handler& handler, size_t threads)
+{
+	typedef SharedPtr<Thread> ThreadPtr;
+	typedef std::vector<ThreadPtr> Threads;
+
+	if (threads == 0)
+		threads = Thread::processorCount();
+
+	BatchFileReader   files(m_filenames, m_prefetch, m_prefetch);
+	FileWorkerContext context;
+
+	context.m_handler = &handler;
+	context.m_files = &files;
+
+	Threads workers;
+
+	for (size_t i = 0; i != std::min(threads, m_filenames.size()); ++i)
+		workers.push_back(ThreadPtr(new Thread(processFiles, &context)));
+
+	for (Threads::iterator it = workers.begin(); it != workers.end(); ++it)
+		(*it)->join();
+
+	if (context.m_failure.isCaptured())
+		context.m_failure.rethrow();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The worker thread function used when processing in parallel. The files are
+//! taken from the shared reader one at a time under the lock. The first failure
+//! is kept for the calling thread and stops the other workers taking files.
+
+void MultiFileLineReader::processFiles(void* param)
+{
+	FileWorkerContext& context = *static_cast<FileWorkerContext*>(param);
+
+	try
+	{
+		for (;;)
+		{
+			size_t        index;
+			LineReaderPtr lines;
+
+			{
+				AutoLock lock(context.m_lock);
+
+				if ( context.m_failure.isCaptured() || !context.m_files->nextFile(index, lines) )
+					break;
+			}
+
+			context.m_handler->processFile(index, *lines);
+		}
+	}
+	catch (...)
+	{
+		AutoLock lock(context.m_lock);
+
+		if (!context.m_failure.isCaptured())
+			context.m_failure.capture();
+	}
+}
+
+//namespace Core
+}
@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   MultiFileLineReader.hpp
+//! \brief  The MultiFileLineReader class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_MULTIFILELINEREADER_HPP
+#define CORE_MULTIFILELINEREADER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "BatchFileReader.hpp"
+#include "UniquePtr.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Reads the lines of every file in a folder which matches a wildcard. The
+//! files are read in name order and each line is tagged with the index of its
+//! file. Whilst one file is being consumed the next few are read on background
+//! threads. Alternatively the files can be processed in parallel, with each
+//! file handled by a single thread.
+
+class MultiFileLineReader /*: private NotCopyable*/
+{
+public:
+	//! The collection of matching files.
+	typedef BatchFileReader::Filenames Filenames;
+
+	//! The default number of files read ahead of the consumer.
+	static const size_t DEFAULT_PREFETCH = 4;
+
+	////////////////////////////////////////////////////////////////////////////
+	//! The interface used to process each file in parallel.
+
+	class Handler
+	{
+	public:
+		//! Destructor.
+		virtual ~Handler() {}
+
+		//! Process the lines of a file. This is called concurrently on the
+		//! worker threads and so must only touch state for the file.
+		virtual void processFile(size_t file, LineReader& lines) = 0;
+	};
+
+public:
+	//! Construction from the folder, wildcard and number of files to read ahead.
+	MultiFileLineReader(const tstring& folder, const tstring& mask, size_t prefetch = DEFAULT_PREFETCH); // throw(FileSystemException, InvalidArgException)
+
+	//! Destructor.
+	~MultiFileLineReader();
+
+	//
+	// Properties.
+	//
+
+	//! Get the number of matching files.
+	size_t fileCount() const;
+
+	//! Get the name of a file.
+	const tstring& filename(size_t index) const;
+
+	//
+	// Methods.
+	//
+
+	//! Read the next line and the index of its file, if there is one.
+	bool readLine(TextRange& line, size_t& file); // throw(FileSystemException, RuntimeException)
+
+	//! Process the files in parallel.
+	void process(Handler& handler, size_t threads = 0); // throw(Exception)
+
+private:
+	//! The smart pointer type for the file reader.
+	typedef UniquePtr<BatchFileReader> BatchReaderPtr;
+
+	//
+	// Members.
+	//
+	Filenames		m_filenames;	//!< The matching files.
+	size_t			m_prefetch;		//!< The number of files to read ahead.
+	BatchReaderPtr	m_files;		//!< The reader for the files.
+	LineReaderPtr	m_lines;		//!< The lines of the current file.
+	size_t			m_current;		//!< The index of the current file.
+
+	//
+	// Internal methods.
+	//
+
+	//! The worker thread function used when processing in parallel.
+	static void processFiles(void* param);
+
+	// NotCopyable.
+	MultiFileLineReader(const MultiFileLineReader&);
+	MultiFileLineReader& operator=(const MultiFileLineReader&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of matching files.
+
+inline size_t MultiFileLineReader::fileCount() const
+{
+	return m_filenames.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the name of a file.
+
+inline const tstring& MultiFileLineReader::filename(size_t index) const
+{
+	return m_filenames.at(index);
+}
+
+//namespace Core
+}
+
+#endif // CORE_MULTIFILELINEREADER_HPP
@@ -0,0 +1,346 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ParallelLineProcessor.cpp
+//! \brief  The ParallelLineProcessor class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "ParallelLineProcessor.hpp"
+#include "Win32Error.hpp"
+#include "InvalidArgException.hpp"
+#include "StringUtils.hpp"
+#include "CriticalSection.hpp"
+#include "Interlocked.hpp"
+#include "Thread.hpp"
+#include "CapturedException.hpp"
+#include <windows.h>
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The number of bytes read at a time when processing a chunk or searching for
+//! the start of a line.
+
+static const size_t READ_BLOCK_SIZE = 1024 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+//! Open the file for shared, read-only access.
+
+static HANDLE openFile(const tstring& filename)
+{
+	HANDLE file = ::CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+								OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+		throwLastError(TXT("Failed to open file"), filename);
+
+	return file;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The LineReader used to read the lines of a single chunk.
+
+class ChunkReader : public LineReader
+{
+public:
+	//! Construction from the file and the location of the chunk.
+	ChunkReader(HANDLE file, const tstring& filename, ulonglong begin, ulonglong end, long& cancelled)
+		: m_file(file)
+		, m_filename(filename)
+		, m_next(begin)
+		, m_end(end)
+		, m_cancelled(cancelled)
+		, m_buffer(static_cast<size_t>(std::min<ulonglong>(end - begin, READ_BLOCK_SIZE)))
+	{
+	}
+
+private:
+	//
+	// Members.
+	//
+	HANDLE				m_file;			//!< The file handle.
+	const tstring&		m_filename;		//!< The name of the file.
+	ulonglong			m_next;			//!< The offset of the next block.
+	ulonglong			m_end;			//!< The offset of the end of the chunk.
+	long&				m_cancelled;	//!< Has processing been cancelled?
+	std::vector<char>	m_buffer;		//!< The block buffer.
+
+	//! Get the next block of the chunk, unless processing has been cancelled.
+	virtual bool nextBlock(const char*& begin, const char*& end)
+	{
+		if ( (m_next == m_end) || (m_cancelled != 0) )
+			return false;
+
+		size_t size = static_cast<size_t>(std::min<ulonglong>(m_end - m_next, READ_BLOCK_SIZE));
+		size_t read = readAt(m_file, m_filename, m_next, &m_buffer.front(), size);
+
+		// File truncated?
+		if (read == 0)
+			return false;
+
+		m_next += read;
+
+		begin = &m_buffer.front();
+		end = begin + read;
+
+		return true;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! The state shared between the calling thread and the worker threads.
+
+struct WorkerContext
+{
+	//! The indices of chunks.
+	typedef std::vector<size_t> Indices;
+
+	ParallelLineProcessor*				m_processor;	//!< The processor.
+	ParallelLineProcessor::Handler*		m_handler;		//!< The chunk handler.
+	long								m_nextChunk;	//!< The next chunk to process.
+	CriticalSection						m_lock;			//!< The lock for the completed chunks and failure.
+	Indices								m_completed;	//!< The chunks completed since last checked.
+	CapturedException					m_failure;		//!< The first exception thrown by a worker.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the file to process, number of threads and chunk size.
+//! If the number of threads is zero one is used per processor. The file is
+//! split into chunks up front so that the caller can size any per-chunk
+//! results before processing.
+
+ParallelLineProcessor::ParallelLineProcessor(const tstring& filename, size_t threads, size_t chunkSize)
+	: m_filename(filename)
+	, m_threads(threads)
+	, m_size(0)
+	, m_chunks()
+	, m_cancelled(0)
+	, m_wakeup(Event::AUTO_RESET)
+{
+	if (chunkSize == 0)
+		throw InvalidArgException(TXT("The chunk size cannot be zero"));
+
+	if (m_threads == 0)
+		m_threads = Thread::processorCount();
+
+	splitFile(chunkSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+ParallelLineProcessor::~ParallelLineProcessor()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Process the file's lines. The chunks are processed by the worker threads
+//! whilst the calling thread reports each chunk as it completes, or in file
+//! order if requested. If the handler throws an exception, processing is
+//! cancelled and the first exception is rethrown with its original type on
+//! the calling thread once all the workers have finished. A processor can be
+//! reused after being cancelled. Returns false if processing was cancelled.
+
+bool ParallelLineProcessor::process(Handler& handler, Order order)
+{
+	typedef SharedPtr<Thread> ThreadPtr;
+	typedef std::vector<ThreadPtr> Threads;
+
+	WorkerContext context;
+
+	context.m_processor = this;
+	context.m_handler = &handler;
+	context.m_nextChunk = 0;
+
+	m_cancelled = 0;
+	m_wakeup.reset();
+
+	const size_t count = m_chunks.size();
+
+	std::vector<bool> completed(count, false);
+	size_t            reported = 0;
+	size_t            nextInOrder = 0;
+	ulonglong         processed = 0;
+
+	{
+		Threads workers;
+
+		try
+		{
+			for (size_t i = 0; i != std::min(m_threads, count); ++i)
+				workers.push_back(ThreadPtr(new Thread(processChunks, &context)));
+
+			while ( (reported != count) && !isCancelled() )
+			{
+				m_wakeup.wait();
+
+				WorkerContext::Indices ready;
+
+				{
+					AutoLock lock(context.m_lock);
+
+					ready.swap(context.m_completed);
+				}
+
+				// Hold back chunks that complete out of order?
+				if (order == ORDERED)
+				{
+					for (WorkerContext::Indices::const_iterator it = ready.begin(); it != ready.end(); ++it)
+						completed[*it] = true;
+
+					ready.clear();
+
+					while ( (nextInOrder != count) && completed[nextInOrder] )
+						ready.push_back(nextInOrder++);
+				}
+
+				for (WorkerContext::Indices::const_iterator it = ready.begin(); (it != ready.end()) && !isCancelled(); ++it)
+				{
+					const Chunk& chunk = m_chunks[*it];
+
+					handler.chunkCompleted(*it);
+
+					processed += chunk.m_end - chunk.m_begin;
+					++reported;
+
+					handler.progress(processed, m_size);
+				}
+			}
+		}
+		catch (...)
+		{
+			cancel();
+			throw;
+		}
+
+		// Wait for the workers.
+		for (Threads::iterator it = workers.begin(); it != workers.end(); ++it)
+			(*it)->join();
+	}
+
+	if (context.m_failure.isCaptured())
+		context.m_failure.rethrow();
+
+	return !isCancelled();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Request that processing stops as soon as possible. This can be called from
+//! any thread, including from the handler. Chunks that have been partially
+//! processed are not reported.
+
+void ParallelLineProcessor::cancel()
+{
+	atomicIncrement(m_cancelled);
+
+	m_wakeup.signal();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Split the file into chunks aligned to the start of a line. Each cut is
+//! moved forward to just after the next newline so that no line straddles two
+//! chunks. An empty file has no chunks.
+
+void ParallelLineProcessor::splitFile(size_t chunkSize)
+{
+	HandlePtr     file(openFile(m_filename), closeHandle);
+	LARGE_INTEGER size;
+
+	if (!::GetFileSizeEx(file.get(), &size))
+		throwLastError(TXT("Failed to query the size of file"), m_filename);
+
+	m_size = size.QuadPart;
+
+	std::vector<char> buffer(std::min(READ_BLOCK_SIZE, chunkSize));
+
+	for (ulonglong begin = 0; begin != m_size; )
+	{
+		ulonglong end = std::min<ulonglong>(begin + chunkSize, m_size);
+
+		// Find the end of the line containing the cut.
+		while (end != m_size)
+		{
+			size_t read = readAt(file.get(), m_filename, end-1, &buffer.front(), buffer.size());
+
+			if (read == 0)
+			{
+				end = m_size;
+				break;
+			}
+
+			const char* newline = static_cast<const char*>(memchr(&buffer.front(), '\n', read));
+
+			if (newline != nullptr)
+			{
+				end += newline - &buffer.front();
+				break;
+			}
+
+			end = std::min<ulonglong>(end + read, m_size);
+		}
+
+		Chunk chunk = { begin, end };
+
+		m_chunks.push_back(chunk);
+
+		begin = end;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The worker thread function. Each worker opens its own handle to the file
+//! and repeatedly takes the next unprocessed chunk until there are none left
+//! or processing is cancelled. The first failure is kept for the calling
+//! thread and cancels processing.
+
+void ParallelLineProcessor::processChunks(void* param)
+{
+	WorkerContext&         context = *static_cast<WorkerContext*>(param);
+	ParallelLineProcessor& processor = *context.m_processor;
+
+	try
+	{
+		HandlePtr file(openFile(processor.m_filename), closeHandle);
+
+		const size_t count = processor.m_chunks.size();
+
+		while (!processor.isCancelled())
+		{
+			size_t index = static_cast<size_t>(atomicIncrement(context.m_nextChunk) - 1);
+
+			if (index >= count)
+				break;
+
+			const Chunk& chunk = processor.m_chunks[index];
+			ChunkReader  reader(file.get(), processor.m_filename, chunk.m_begin, chunk.m_end, processor.m_cancelled);
+
+			context.m_handler->processChunk(index, reader);
+
+			if (processor.isCancelled())
+				break;
+
+			{
+				AutoLock lock(context.m_lock);
+
+				context.m_completed.push_back(index);
+			}
+
+			processor.m_wakeup.signal();
+		}
+	}
+	catch (...)
+	{
+		{
+			AutoLock lock(context.m_lock);
+
+			if (!context.m_failure.isCaptured())
+				context.m_failure.capture();
+		}
+
+		processor.cancel();
+	}
+}
+
+//namespace Core
+}
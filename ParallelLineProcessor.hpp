@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ParallelLineProcessor.hpp
+//! \brief  The ParallelLineProcessor class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_PARALLELLINEPROCESSOR_HPP
+#define CORE_PARALLELLINEPROCESSOR_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include "LineReader.hpp"
+#include "Event.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Processes the lines of a large text file using multiple threads. The file
+//! is split into chunks of roughly equal size, with each boundary moved forward
+//! to the start of the next line, and the chunks are then shared out between
+//! the worker threads. The completion of each chunk is reported on the calling
+//! thread, either as soon as it happens or in file order.
+
+class ParallelLineProcessor /*: private NotCopyable*/
+{
+public:
+	//! The order in which completed chunks are reported.
+	enum Order
+	{
+		UNORDERED,	//!< Report chunks as soon as they have been processed.
+		ORDERED,	//!< Report chunks in the order they appear in the file.
+	};
+
+	//! The default number of bytes in each chunk.
+	static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024 * 1024;
+
+	////////////////////////////////////////////////////////////////////////////
+	//! The interface used to process the lines of each chunk.
+
+	class Handler
+	{
+	public:
+		//! Destructor.
+		virtual ~Handler() {}
+
+		//! Process the lines of a chunk. This is called concurrently on the
+		//! worker threads and so must only touch state for the chunk.
+		virtual void processChunk(size_t chunk, LineReader& lines) = 0;
+
+		//! Called on the calling thread once a chunk has been processed.
+		virtual void chunkCompleted(size_t /*chunk*/) {}
+
+		//! Called on the calling thread with the number of bytes in the chunks
+		//! reported so far.
+		virtual void progress(ulonglong /*processed*/, ulonglong /*total*/) {}
+	};
+
+public:
+	//! Construction from the file to process, number of threads and chunk size.
+	ParallelLineProcessor(const tstring& filename, size_t threads = 0, size_t chunkSize = DEFAULT_CHUNK_SIZE); // throw(FileSystemException, InvalidArgException)
+
+	//! Destructor.
+	~ParallelLineProcessor();
+
+	//
+	// Properties.
+	//
+
+	//! Get the size of the file.
+	ulonglong fileSize() const;
+
+	//! Get the number of chunks the file has been split into.
+	size_t chunkCount() const;
+
+	//! Query if processing has been cancelled.
+	bool isCancelled() const;
+
+	//
+	// Methods.
+	//
+
+	//! Process the file's lines, returning false if cancelled.
+	bool process(Handler& handler, Order order = UNORDERED); // throw(FileSystemException, RuntimeException)
+
+	//! Request that processing stops as soon as possible.
+	void cancel();
+
+private:
+	//! The location of a chunk within the file.
+	struct Chunk
+	{
+		ulonglong	m_begin;	//!< The offset of the first line.
+		ulonglong	m_end;		//!< The offset after the last line.
+	};
+
+	//! The collection of chunks.
+	typedef std::vector<Chunk> Chunks;
+
+	//
+	// Members.
+	//
+	tstring			m_filename;		//!< The file to process.
+	size_t			m_threads;		//!< The number of worker threads.
+	ulonglong		m_size;			//!< The size of the file.
+	Chunks			m_chunks;		//!< The chunks to process.
+	long			m_cancelled;	//!< Has processing been cancelled?
+	Event			m_wakeup;		//!< Used to wake the calling thread.
+
+	//
+	// Internal methods.
+	//
+
+	//! Split the file into chunks aligned to the start of a line.
+	void splitFile(size_t chunkSize);
+
+	//! The worker thread function.
+	static void processChunks(void* param);
+
+	// NotCopyable.
+	ParallelLineProcessor(const ParallelLineProcessor&);
+	ParallelLineProcessor& operator=(const ParallelLineProcessor&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the size of the file.
+
+inline ulonglong ParallelLineProcessor::fileSize() const
+{
+	return m_size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of chunks the file has been split into. Every line belongs
+//! to exactly one chunk.
+
+inline size_t ParallelLineProcessor::chunkCount() const
+{
+	return m_chunks.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if processing has been cancelled.
+
+inline bool ParallelLineProcessor::isCancelled() const
+{
+	return (m_cancelled != 0);
+}
+
+//namespace Core
+}
+
+#endif // CORE_PARALLELLINEPROCESSOR_HPP
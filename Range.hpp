@@ -0,0 +1,221 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Range.hpp
+//! \brief  The Range class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_RANGE_HPP
+#define CORE_RANGE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A non-owning view of a contiguous sequence of values, such as a token within
+//! a larger buffer. The range does not manage the lifetime of the underlying
+//! values and so is only valid for as long as the buffer it refers to.
+
+template <typename T>
+class Range
+{
+public:
+	//! The value type.
+	typedef T value_type;
+	//! The iterator type.
+	typedef const T* const_iterator;
+
+public:
+	//! Default constructor.
+	Range();
+
+	//! Construction from a pair of pointers.
+	Range(const T* begin, const T* end);
+
+	//! Construction from a pointer and length.
+	Range(const T* begin, size_t length);
+
+	//
+	// Operators.
+	//
+
+	//! Index operator.
+	const T& operator[](size_t index) const;
+
+	//
+	// Properties.
+	//
+
+	//! Get the start of the range.
+	const T* begin() const;
+
+	//! Get the end of the range.
+	const T* end() const;
+
+	//! Get the number of values in the range.
+	size_t size() const;
+
+	//! Query if the range is empty.
+	bool empty() const;
+
+private:
+	//
+	// Members.
+	//
+	const T*	m_begin;	//!< The first value in the range.
+	const T*	m_end;		//!< One past the last value in the range.
+};
+
+//! A range of characters.
+typedef Range<tchar> TextRange;
+
+//! A range of bytes.
+typedef Range<byte> ByteRange;
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+template <typename T>
+inline Range<T>::Range()
+	: m_begin(nullptr)
+	, m_end(nullptr)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a pair of pointers.
+
+template <typename T>
+inline Range<T>::Range(const T* begin, const T* end)
+	: m_begin(begin)
+	, m_end(end)
+{
+	ASSERT(m_begin <= m_end);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a pointer and length.
+
+template <typename T>
+inline Range<T>::Range(const T* begin, size_t length)
+	: m_begin(begin)
+	, m_end(begin + length)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Index operator.
+
+template <typename T>
+inline const T& Range<T>::operator[](size_t index) const
+{
+	ASSERT(index < size());
+
+	return m_begin[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the start of the range.
+
+template <typename T>
+inline const T* Range<T>::begin() const
+{
+	return m_begin;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the end of the range.
+
+template <typename T>
+inline const T* Range<T>::end() const
+{
+	return m_end;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of values in the range.
+
+template <typename T>
+inline size_t Range<T>::size() const
+{
+	return (m_end - m_begin);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the range is empty.
+
+template <typename T>
+inline bool Range<T>::empty() const
+{
+	return (m_begin == m_end);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare two ranges for equality of their contents.
+
+template <typename T>
+inline bool operator==(const Range<T>& lhs, const Range<T>& rhs)
+{
+	return (lhs.size() == rhs.size()) && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare two ranges for inequality of their contents.
+
+template <typename T>
+inline bool operator!=(const Range<T>& lhs, const Range<T>& rhs)
+{
+	return !(lhs == rhs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare a range of characters with a string for equality.
+
+inline bool operator==(const TextRange& lhs, const tstring& rhs)
+{
+	return (lhs.size() == rhs.size()) && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare a range of characters with a string for inequality.
+
+inline bool operator!=(const TextRange& lhs, const tstring& rhs)
+{
+	return !(lhs == rhs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare a range of characters with a string for equality.
+
+inline bool operator==(const TextRange& lhs, const tchar* rhs)
+{
+	const size_t length = tstrlen(rhs);
+
+	return (lhs.size() == length) && std::equal(lhs.begin(), lhs.end(), rhs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare a range of characters with a string for inequality.
+
+inline bool operator!=(const TextRange& lhs, const tchar* rhs)
+{
+	return !(lhs == rhs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a string from a range of characters.
+
+inline tstring toString(const TextRange& range)
+{
+	return tstring(range.begin(), range.end());
+}
+
+//namespace Core
+}
+
+#endif // CORE_RANGE_HPP
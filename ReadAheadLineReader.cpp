@@ -0,0 +1,315 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ReadAheadLineReader.cpp
+//! \brief  The ReadAheadLineReader class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "ReadAheadLineReader.hpp"
+#include "Win32Error.hpp"
+#include "FileSystemException.hpp"
+#include "InvalidArgException.hpp"
+#include "StringUtils.hpp"
+#include <windows.h>
+#include <limits.h>
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The largest number of bytes that can be requested by a single ReadFile().
+
+static const size_t MAX_BLOCK_SIZE = INT_MAX;
+
+////////////////////////////////////////////////////////////////////////////////
+//! The value used when no buffer is being consumed.
+
+static const size_t NO_BUFFER = static_cast<size_t>(-1);
+
+////////////////////////////////////////////////////////////////////////////////
+//! The source used to read a file sequentially.
+
+class FileSource : public ByteSource
+{
+public:
+	//! Construction from the file to read.
+	explicit FileSource(const tstring& filename)
+		: m_filename(filename)
+		, m_file(INVALID_HANDLE_VALUE)
+	{
+		m_file = ::CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+								OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		if (m_file == INVALID_HANDLE_VALUE)
+		{
+			DWORD   errorCode = ::GetLastError();
+			tstring errorText = formatWin32ErrorMessage(errorCode);
+
+			throw FileSystemException(Core::fmt(TXT("Failed to open file '%s' [0x%08lX - %s]"), filename.c_str(), errorCode, errorText.c_str()));
+		}
+	}
+
+	//! Destructor.
+	virtual ~FileSource()
+	{
+		::CloseHandle(m_file);
+	}
+
+	//! Read the next block from the file.
+	virtual size_t read(char* buffer, size_t size)
+	{
+		DWORD read = 0;
+
+		if (!::ReadFile(m_file, buffer, static_cast<DWORD>(size), &read, nullptr))
+		{
+			DWORD   errorCode = ::GetLastError();
+			tstring errorText = formatWin32ErrorMessage(errorCode);
+
+			throw FileSystemException(Core::fmt(TXT("Failed to read from file '%s' [0x%08lX - %s]"), m_filename.c_str(), errorCode, errorText.c_str()));
+		}
+
+		return read;
+	}
+
+private:
+	//
+	// Members.
+	//
+	tstring	m_filename;	//!< The file being read.
+	HANDLE	m_file;		//!< The file handle.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the file to read, block size and number of buffers. The
+//! file is opened on the calling thread so that a missing file is reported
+//! immediately, and the background thread then starts reading straight away.
+
+ReadAheadLineReader::ReadAheadLineReader(const tstring& filename, size_t blockSize, size_t buffers)
+	: m_source()
+	, m_buffers()
+	, m_lock()
+	, m_free()
+	, m_filled()
+	, m_current(NO_BUFFER)
+	, m_eof(false)
+	, m_failed(false)
+	, m_failure()
+	, m_stopping(false)
+	, m_blockFilled(Event::AUTO_RESET)
+	, m_bufferFreed(Event::AUTO_RESET)
+	, m_thread()
+{
+	if (blockSize == 0)
+		throw InvalidArgException(TXT("The block size cannot be zero"));
+
+	if (buffers == 0)
+		throw InvalidArgException(TXT("The number of buffers cannot be zero"));
+
+	m_source = ByteSourcePtr(new FileSource(filename));
+
+	start(blockSize, buffers);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the source to read, block size and number of buffers.
+//! The source is only read on the background thread, which starts reading
+//! straight away.
+
+ReadAheadLineReader::ReadAheadLineReader(const ByteSourcePtr& source, size_t blockSize, size_t buffers)
+	: m_source(source)
+	, m_buffers()
+	, m_lock()
+	, m_free()
+	, m_filled()
+	, m_current(NO_BUFFER)
+	, m_eof(false)
+	, m_failed(false)
+	, m_failure()
+	, m_stopping(false)
+	, m_blockFilled(Event::AUTO_RESET)
+	, m_bufferFreed(Event::AUTO_RESET)
+	, m_thread()
+{
+	ASSERT(m_source.get() != nullptr);
+
+	if (blockSize == 0)
+		throw InvalidArgException(TXT("The block size cannot be zero"));
+
+	if (buffers == 0)
+		throw InvalidArgException(TXT("The number of buffers cannot be zero"));
+
+	start(blockSize, buffers);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. The background thread is stopped even if the file has not
+//! been read to the end.
+
+ReadAheadLineReader::~ReadAheadLineReader()
+{
+	stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the next block of characters, if there is one. The previous block is
+//! handed back to the background thread to refill before waiting for the
+//! next one to be filled.
+
+bool ReadAheadLineReader::nextBlock(const char*& begin, const char*& end)
+{
+	if (m_current != NO_BUFFER)
+	{
+		{
+			AutoLock lock(m_lock);
+
+			m_free.push_back(m_current);
+			m_current = NO_BUFFER;
+		}
+
+		m_bufferFreed.signal();
+	}
+
+	for (;;)
+	{
+		{
+			AutoLock lock(m_lock);
+
+			if (!m_filled.empty())
+			{
+				const Block block = m_filled.front();
+
+				m_filled.pop_front();
+				m_current = block.m_buffer;
+
+				begin = &m_buffers[block.m_buffer].front();
+				end = begin + block.m_size;
+
+				return true;
+			}
+
+			if (m_failed)
+				m_failure.rethrow();
+
+			if (m_eof)
+				return false;
+		}
+
+		m_blockFilled.wait();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Allocate the buffers and start the background thread.
+
+void ReadAheadLineReader::start(size_t blockSize, size_t buffers)
+{
+	m_buffers.resize(buffers, CharBuffer(std::min(blockSize, MAX_BLOCK_SIZE)));
+
+	for (size_t i = 0; i != buffers; ++i)
+		m_free.push_back(buffers-i-1);
+
+	m_thread.reset(new Thread(readAhead, this));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Fill the free buffers until the end of the source is reached, a read fails
+//! or the reader is being destroyed. When there are no free buffers the
+//! thread waits for the consumer to hand one back.
+
+void ReadAheadLineReader::readSource()
+{
+	for (;;)
+	{
+		size_t index = NO_BUFFER;
+
+		{
+			AutoLock lock(m_lock);
+
+			if (m_stopping)
+				return;
+
+			if (!m_free.empty())
+			{
+				index = m_free.back();
+				m_free.pop_back();
+			}
+		}
+
+		if (index == NO_BUFFER)
+		{
+			m_bufferFreed.wait();
+			continue;
+		}
+
+		CharBuffer&       buffer = m_buffers[index];
+		size_t            read = 0;
+		bool              failed = false;
+		CapturedException failure;
+
+		try
+		{
+			read = m_source->read(&buffer.front(), buffer.size());
+		}
+		catch (...)
+		{
+			failure.capture();
+			failed = true;
+		}
+
+		const bool finished = failed || (read == 0);
+
+		{
+			AutoLock lock(m_lock);
+
+			if (failed)
+			{
+				m_failed = true;
+				m_failure = failure;
+			}
+			else if (read == 0)
+			{
+				m_eof = true;
+			}
+			else
+			{
+				const Block block = { index, read };
+
+				m_filled.push_back(block);
+			}
+		}
+
+		m_blockFilled.signal();
+
+		if (finished)
+			return;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Stop the background thread.
+
+void ReadAheadLineReader::stop()
+{
+	if (m_thread.get() != nullptr)
+	{
+		{
+			AutoLock lock(m_lock);
+
+			m_stopping = true;
+		}
+
+		m_bufferFreed.signal();
+		m_thread.reset();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The background thread function.
+
+void ReadAheadLineReader::readAhead(void* param)
+{
+	static_cast<ReadAheadLineReader*>(param)->readSource();
+}
+
+//namespace Core
+}
@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ReadAheadLineReader.hpp
+//! \brief  The ReadAheadLineReader class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_READAHEADLINEREADER_HPP
+#define CORE_READAHEADLINEREADER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include <deque>
+#include "LineReader.hpp"
+#include "ByteSource.hpp"
+#include "CriticalSection.hpp"
+#include "Event.hpp"
+#include "Thread.hpp"
+#include "UniquePtr.hpp"
+#include "CapturedException.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A LineReader that reads a file, or any other source of bytes, on a background
+//! thread so that the next block is being read whilst the lines of the current
+//! one are consumed. The number of blocks in flight is bounded by a fixed pool
+//! of buffers; the background thread waits once they are all full. Any read
+//! error is rethrown, with its original type, on the consuming thread when the
+//! block it failed on would have been used.
+
+class ReadAheadLineReader : public LineReader
+{
+public:
+	//! The default number of bytes read at a time.
+	static const size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+	//! The default number of buffers, i.e. double buffering.
+	static const size_t DEFAULT_BUFFERS = 2;
+
+public:
+	//! Construction from the file to read, block size and number of buffers.
+	explicit ReadAheadLineReader(const tstring& filename, size_t blockSize = DEFAULT_BLOCK_SIZE, size_t buffers = DEFAULT_BUFFERS); // throw(FileSystemException, InvalidArgException)
+
+	//! Construction from the source to read, block size and number of buffers.
+	explicit ReadAheadLineReader(const ByteSourcePtr& source, size_t blockSize = DEFAULT_BLOCK_SIZE, size_t buffers = DEFAULT_BUFFERS); // throw(InvalidArgException)
+
+	//! Destructor.
+	virtual ~ReadAheadLineReader();
+
+private:
+	//! A buffer of characters.
+	typedef std::vector<char> CharBuffer;
+	//! The pool of buffers.
+	typedef std::vector<CharBuffer> Buffers;
+	//! The indices of buffers.
+	typedef std::vector<size_t> Indices;
+
+	//! A buffer that has been filled by the background thread.
+	struct Block
+	{
+		size_t	m_buffer;	//!< The index of the buffer.
+		size_t	m_size;		//!< The number of bytes read.
+	};
+
+	//! The queue of filled buffers.
+	typedef std::deque<Block> Blocks;
+
+	//
+	// Members.
+	//
+	ByteSourcePtr		m_source;		//!< The source being read.
+	Buffers				m_buffers;		//!< The pool of buffers.
+	CriticalSection		m_lock;			//!< The lock for the shared state.
+	Indices				m_free;			//!< The buffers waiting to be filled.
+	Blocks				m_filled;		//!< The buffers waiting to be consumed.
+	size_t				m_current;		//!< The buffer being consumed.
+	bool				m_eof;			//!< Has the end of the file been read?
+	bool				m_failed;		//!< Did a read fail?
+	CapturedException	m_failure;		//!< The exception thrown by the failed read.
+	bool				m_stopping;		//!< Should the background thread stop?
+	Event				m_blockFilled;	//!< Signalled when a block is filled.
+	Event				m_bufferFreed;	//!< Signalled when a buffer is freed.
+	UniquePtr<Thread>	m_thread;		//!< The background thread.
+
+	//
+	// LineReader methods.
+	//
+
+	//! Get the next block of characters, if there is one.
+	virtual bool nextBlock(const char*& begin, const char*& end); // throw(Exception)
+
+	//
+	// Internal methods.
+	//
+
+	//! Allocate the buffers and start the background thread.
+	void start(size_t blockSize, size_t buffers);
+
+	//! Fill the free buffers until the end of the source is reached.
+	void readSource();
+
+	//! Stop the background thread.
+	void stop();
+
+	//! The background thread function.
+	static void readAhead(void* param);
+
+	// NotCopyable.
+	ReadAheadLineReader(const ReadAheadLineReader&);
+	ReadAheadLineReader& operator=(const ReadAheadLineReader&);
+};
+
+//namespace Core
+}
+
+#endif // CORE_READAHEADLINEREADER_HPP
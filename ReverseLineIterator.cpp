@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ReverseLineIterator.cpp
+//! \brief  The ReverseLineIterator class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "ReverseLineIterator.hpp"
+#include "BadLogicException.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Constructor for the End iterator.
+
+ReverseLineIterator::ReverseLineIterator()
+	: m_reader()
+	, m_value()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Constructor for the Begin iterator.
+
+ReverseLineIterator::ReverseLineIterator(const ReverseLineReaderPtr& reader)
+	: m_reader(reader)
+	, m_value()
+{
+	ASSERT(m_reader.get() != nullptr);
+
+	increment();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+ReverseLineIterator::~ReverseLineIterator()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Dereference operator.
+
+const TextRange& ReverseLineIterator::operator*() const
+{
+	if (m_reader.get() == nullptr)
+		throw BadLogicException(TXT("Attempted to dereference end iterator"));
+
+	return m_value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Pointer-to-member operator.
+
+const TextRange* ReverseLineIterator::operator->() const
+{
+	if (m_reader.get() == nullptr)
+		throw BadLogicException(TXT("Attempted to dereference end iterator"));
+
+	return &m_value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare to another iterator for equivalence.
+
+bool ReverseLineIterator::equals(const ReverseLineIterator& rhs) const
+{
+	if (m_reader.get() == nullptr)
+		return (rhs.m_reader.get() == nullptr);
+
+	return (m_reader.get() == rhs.m_reader.get());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move the iterator forward.
+
+void ReverseLineIterator::increment()
+{
+	if (m_reader.get() == nullptr)
+		throw BadLogicException(TXT("Attempted to increment end iterator"));
+
+	if (!m_reader->readLine(m_value))
+	{
+		m_reader.reset();
+		m_value = TextRange();
+	}
+}
+
+//namespace Core
+}
@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ReverseLineIterator.hpp
+//! \brief  The ReverseLineIterator class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_REVERSELINEITERATOR_HPP
+#define CORE_REVERSELINEITERATOR_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "ReverseLineReader.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The iterator type used to read the lines of a file in reverse order from a
+//! ReverseLineReader. Each line is a view which is only valid until the
+//! iterator is next advanced.
+
+class ReverseLineIterator
+{
+public:
+	//! Constructor for the End iterator.
+	ReverseLineIterator();
+
+	//! Constructor for the Begin iterator.
+	explicit ReverseLineIterator(const ReverseLineReaderPtr& reader);
+
+	//! Destructor.
+	~ReverseLineIterator();
+
+	//
+	// Operators.
+	//
+
+	//! Dereference operator.
+	const TextRange& operator*() const;
+
+	//! Pointer-to-member operator.
+	const TextRange* operator->() const;
+
+	//! Advance the iterator.
+	ReverseLineIterator& operator++();
+
+	//
+	// Methods.
+	//
+
+	//! Compare to another iterator for equivalence.
+	bool equals(const ReverseLineIterator& rhs) const;
+
+private:
+	//
+	// Members.
+	//
+	ReverseLineReaderPtr	m_reader;	//!< The underlying line reader.
+	TextRange		m_value;	//!< The current iterator value.
+
+	//
+	// Internal methods.
+	//
+
+	//! Move the iterator forward.
+	void increment();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Advance the iterator.
+
+inline ReverseLineIterator& ReverseLineIterator::operator++()
+{
+	increment();
+
+	return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare two iterators for equivalence.
+
+inline bool operator==(const ReverseLineIterator& lhs, const ReverseLineIterator& rhs)
+{
+	return lhs.equals(rhs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare two iterators for difference.
+
+inline bool operator!=(const ReverseLineIterator& lhs, const ReverseLineIterator& rhs)
+{
+	return !lhs.equals(rhs);
+}
+
+//namespace Core
+}
+
+#endif // CORE_REVERSELINEITERATOR_HPP
@@ -0,0 +1,190 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ReverseLineReader.cpp
+//! \brief  The ReverseLineReader class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "ReverseLineReader.hpp"
+#include "Win32Error.hpp"
+#include "FileSystemException.hpp"
+#include "InvalidArgException.hpp"
+#include "StringUtils.hpp"
+#include "AnsiWide.hpp"
+#include <windows.h>
+#include <limits.h>
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The largest number of bytes that can be requested by a single ReadFile().
+
+static const size_t MAX_BLOCK_SIZE = INT_MAX;
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the file to read and the block size. The last block is
+//! read straight away so that a final line terminator can be discarded.
+
+ReverseLineReader::ReverseLineReader(const tstring& filename, size_t blockSize)
+	: m_file(INVALID_HANDLE_VALUE)
+	, m_filename(filename)
+	, m_blockSize(std::min(blockSize, MAX_BLOCK_SIZE))
+	, m_position(0)
+	, m_buffer()
+	, m_end(0)
+	, m_finished(false)
+	, m_widened()
+{
+	if (blockSize == 0)
+		throw InvalidArgException(TXT("The block size cannot be zero"));
+
+	m_file = ::CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+							OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+
+	if (m_file == INVALID_HANDLE_VALUE)
+		throwLastError(TXT("Failed to open file"), m_filename);
+
+	try
+	{
+		LARGE_INTEGER size;
+
+		if (!::GetFileSizeEx(m_file, &size))
+			throwLastError(TXT("Failed to query the size of file"), m_filename);
+
+		m_position = size.QuadPart;
+
+		if (m_position == 0)
+		{
+			m_finished = true;
+		}
+		else
+		{
+			readPreviousBlock();
+
+			if (m_buffer[m_end-1] == '\n')
+				--m_end;
+		}
+	}
+	catch (...)
+	{
+		::CloseHandle(m_file);
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+ReverseLineReader::~ReverseLineReader()
+{
+	::CloseHandle(m_file);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the previous line, if there is one. The buffered text is scanned from
+//! the end for the newline that precedes the line. When the buffer runs out
+//! first the previous block is read in front of it and only that block is
+//! scanned, as the rest is already known not to contain a newline.
+
+bool ReverseLineReader::readLine(TextRange& line)
+{
+	if (m_finished)
+		return false;
+
+	size_t searchEnd = m_end;
+
+	for (;;)
+	{
+		size_t next = searchEnd;
+
+		while ( (next != 0) && (m_buffer[next-1] != '\n') )
+			--next;
+
+		if (next != 0)
+		{
+			setLine(&m_buffer.front() + next, &m_buffer.front() + m_end, line);
+			m_end = next-1;
+			return true;
+		}
+
+		// First line in the file?
+		if (m_position == 0)
+		{
+			setLine(&m_buffer.front(), &m_buffer.front() + m_end, line);
+			m_finished = true;
+			return true;
+		}
+
+		searchEnd = readPreviousBlock();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the block before the buffered text, moving the text along to make
+//! room for it at the front of the buffer. The buffer only grows beyond the
+//! block size for lines longer than a block. Returns the size of the block.
+
+size_t ReverseLineReader::readPreviousBlock()
+{
+	const size_t size = static_cast<size_t>(std::min<ulonglong>(m_blockSize, m_position));
+
+	if (m_buffer.size() < (size + m_end))
+		m_buffer.resize(size + m_end);
+
+	if (m_end != 0)
+		memmove(&m_buffer[size], &m_buffer.front(), m_end);
+
+	m_position -= size;
+	m_end += size;
+
+	for (size_t offset = 0; offset != size; )
+	{
+		const ulonglong position = m_position + offset;
+		OVERLAPPED      overlapped;
+		DWORD           read = 0;
+
+		memset(&overlapped, 0, sizeof(overlapped));
+
+		overlapped.Offset = static_cast<DWORD>(position & 0xFFFFFFFF);
+		overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+		if ( !::ReadFile(m_file, &m_buffer[offset], static_cast<DWORD>(size - offset), &read, &overlapped)
+		  && (::GetLastError() != ERROR_HANDLE_EOF) )
+			throwLastError(TXT("Failed to read from file"), m_filename);
+
+		if (read == 0)
+			throw FileSystemException(Core::fmt(TXT("The file '%s' was truncated whilst being read"), m_filename.c_str()));
+
+		offset += read;
+	}
+
+	return size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Return the line, trimming any trailing CR. For a UNICODE build the line is
+//! widened into a buffer that is reused for each line.
+
+void ReverseLineReader::setLine(const char* begin, const char* end, TextRange& line)
+{
+	if ( (begin != end) && (*(end-1) == '\r') )
+		--end;
+
+#ifdef ANSI_BUILD
+	line = TextRange(begin, end);
+#else
+	const size_t length = end - begin;
+
+	if (m_widened.size() < length)
+		m_widened.resize(length);
+
+	if (length != 0)
+		ansiToWide(begin, end, &m_widened.front());
+
+	line = TextRange((length != 0) ? &m_widened.front() : TXT(""), length);
+#endif
+}
+
+//namespace Core
+}
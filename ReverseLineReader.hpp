@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ReverseLineReader.hpp
+//! \brief  The ReverseLineReader class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_REVERSELINEREADER_HPP
+#define CORE_REVERSELINEREADER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include "Range.hpp"
+#include "SharedPtr.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Reads the lines of an ANSI text file in reverse order, starting with the
+//! last line. The file is read in blocks backwards from the end, so only the
+//! blocks containing the lines actually read are touched. As with LineReader,
+//! lines are terminated by either "\n" or "\r\n", the final line does not
+//! need a terminator and each line is a view which remains valid until the
+//! next line is read.
+
+class ReverseLineReader /*: private NotCopyable*/
+{
+public:
+	//! The default number of bytes read at a time.
+	static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+public:
+	//! Construction from the file to read and the block size.
+	explicit ReverseLineReader(const tstring& filename, size_t blockSize = DEFAULT_BLOCK_SIZE); // throw(FileSystemException, InvalidArgException)
+
+	//! Destructor.
+	~ReverseLineReader();
+
+	//
+	// Methods.
+	//
+
+	//! Read the previous line, if there is one.
+	bool readLine(TextRange& line); // throw(FileSystemException)
+
+private:
+	//! A buffer of characters.
+	typedef std::vector<char> CharBuffer;
+	//! A buffer of build specific characters.
+	typedef std::vector<tchar> TCharBuffer;
+
+	//
+	// Members.
+	//
+	void*		m_file;		//!< The file handle.
+	tstring		m_filename;	//!< The file being read.
+	size_t		m_blockSize;	//!< The number of bytes read at a time.
+	ulonglong	m_position;	//!< The offset of the start of the buffered text.
+	CharBuffer	m_buffer;	//!< The text read but not yet returned.
+	size_t		m_end;		//!< The end of the unreturned text in the buffer.
+	bool		m_finished;	//!< Has the first line been returned?
+	TCharBuffer	m_widened;	//!< The last line converted to UNICODE.
+
+	//
+	// Internal methods.
+	//
+
+	//! Read the block before the buffered text.
+	size_t readPreviousBlock(); // throw(FileSystemException)
+
+	//! Return the line, trimming any trailing CR.
+	void setLine(const char* begin, const char* end, TextRange& line);
+
+	// NotCopyable.
+	ReverseLineReader(const ReverseLineReader&);
+	ReverseLineReader& operator=(const ReverseLineReader&);
+};
+
+//! The default ReverseLineReader smart-pointer type.
+typedef SharedPtr<ReverseLineReader> ReverseLineReaderPtr;
+
+//namespace Core
+}
+
+#endif // CORE_REVERSELINEREADER_HPP
@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Semaphore.cpp
+//! \brief  The Semaphore class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "Semaphore.hpp"
+#include "RuntimeException.hpp"
+#include "Win32Error.hpp"
+#include "StringUtils.hpp"
+#include <windows.h>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the initial and maximum count.
+
+Semaphore::Semaphore(long initialCount, long maximumCount)
+	: m_handle(nullptr)
+{
+	m_handle = ::CreateSemaphore(nullptr, initialCount, maximumCount, nullptr);
+
+	if (m_handle == nullptr)
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw RuntimeException(Core::fmt(TXT("Failed to create semaphore [0x%08lX - %s]"), errorCode, errorText.c_str()));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+Semaphore::~Semaphore()
+{
+	::CloseHandle(m_handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Return units to the count, waking up to that many waiting threads. It is
+//! an error to take the count above its maximum.
+
+void Semaphore::release(long count)
+{
+	if (!::ReleaseSemaphore(m_handle, count, nullptr))
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw RuntimeException(Core::fmt(TXT("Failed to release semaphore [0x%08lX - %s]"), errorCode, errorText.c_str()));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait for the count to be non-zero and then decrement it.
+
+void Semaphore::wait()
+{
+	wait(INFINITE_WAIT);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait for the count to be non-zero or the timeout, in milliseconds, to
+//! expire. Returns false if the wait timed out.
+
+bool Semaphore::wait(uint timeout)
+{
+	DWORD result = ::WaitForSingleObject(m_handle, timeout);
+
+	if (result == WAIT_FAILED)
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw RuntimeException(Core::fmt(TXT("Failed to wait for semaphore [0x%08lX - %s]"), errorCode, errorText.c_str()));
+	}
+
+	return (result == WAIT_OBJECT_0);
+}
+
+//namespace Core
+}
@@ -0,0 +1,62 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Semaphore.hpp
+//! \brief  The Semaphore class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_SEMAPHORE_HPP
+#define CORE_SEMAPHORE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! An unnamed counting semaphore used to limit the number of threads that can
+//! use a resource at the same time. A successful wait takes one unit of the
+//! count and a release returns units back.
+
+class Semaphore /*: private NotCopyable*/
+{
+public:
+	//! The timeout value for an infinite wait.
+	static const uint INFINITE_WAIT = 0xFFFFFFFF;
+
+public:
+	//! Construction with the initial and maximum count.
+	Semaphore(long initialCount, long maximumCount); // throw(RuntimeException)
+
+	//! Destructor.
+	~Semaphore();
+
+	//
+	// Methods.
+	//
+
+	//! Return units to the count.
+	void release(long count = 1); // throw(RuntimeException)
+
+	//! Wait for the count to be non-zero and then decrement it.
+	void wait(); // throw(RuntimeException)
+
+	//! Wait for the count to be non-zero or the timeout to expire.
+	bool wait(uint timeout); // throw(RuntimeException)
+
+private:
+	//
+	// Members.
+	//
+	void*	m_handle;	//!< The semaphore handle.
+
+	// NotCopyable.
+	Semaphore(const Semaphore&);
+	Semaphore& operator=(const Semaphore&);
+};
+
+//namespace Core
+}
+
+#endif // CORE_SEMAPHORE_HPP
@@ -100,6 +100,24 @@ TEST_CASE("exists_if returns false when it cannot find the item in the set using
 }
 TEST_CASE_END
 
+TEST_CASE("exists returns whether it finds the item in a sequence defined by a pair of iterators")
+{
+	int values[] = {1, 2, 3};
+
+	TEST_TRUE(Core::exists(values, values+ARRAY_SIZE(values), 2));
+	TEST_FALSE(Core::exists(values, values+ARRAY_SIZE(values), 5));
+}
+TEST_CASE_END
+
+TEST_CASE("exists_if returns whether it finds the item in a sequence defined by a pair of iterators using a predicate")
+{
+	const tchar* values[] = {TXT("A"), TXT("B"), TXT("C")};
+
+	TEST_TRUE(Core::exists_if(values, values+ARRAY_SIZE(values), StringValueEqualsIgnoringCase(TXT("b"))));
+	TEST_FALSE(Core::exists_if(values, values+ARRAY_SIZE(values), StringValueEqualsIgnoringCase(TXT("z"))));
+}
+TEST_CASE_END
+
 TEST_CASE("deep copying a vector creates an equivalent sequence with different object references")
 {
 	typedef Core::SharedPtr<int> IntPtr;
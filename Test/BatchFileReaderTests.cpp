@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   BatchFileReaderTests.cpp
+//! \brief  The unit tests for the BatchFileReader class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/BatchFileReader.hpp>
+#include <Core/LineIterator.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include <Core/StringUtils.hpp>
+#include <Core/FileSystemException.hpp>
+#include "FileTest.hpp"
+#include <algorithm>
+
+TEST_SET(BatchFileReader)
+{
+	typedef Core::BatchFileReader::Filenames Filenames;
+
+	const tstring folder = Core::getTempFolder();
+	const size_t  count = 20;
+	Filenames     filenames;
+
+	for (size_t i = 0; i != count; ++i)
+	{
+		tstring filename = Core::combinePaths(folder, Core::fmt(TXT("core_batch_test_file_%u.txt"), static_cast<uint>(i)));
+
+		createFile(filename, T2A(Core::fmt(TXT("file %u\r\nline 2\n"), static_cast<uint>(i))));
+
+		filenames.push_back(filename);
+	}
+
+	const tstring emptyFile = Core::combinePaths(folder, TXT("core_batch_empty_file.txt"));
+
+	createFile(emptyFile, "");
+
+TEST_CASE("construction with a zero read ahead throws an exception")
+{
+	TEST_THROWS(Core::BatchFileReader(filenames, 1, 0));
+}
+TEST_CASE_END
+
+TEST_CASE("an empty batch has no files")
+{
+	Core::BatchFileReader reader((Filenames()));
+	size_t                index;
+	Core::LineReaderPtr   lines;
+
+	TEST_TRUE(reader.fileCount() == 0);
+	TEST_FALSE(reader.nextFile(index, lines));
+}
+TEST_CASE_END
+
+TEST_CASE("every file is returned exactly once with its lines")
+{
+	Core::BatchFileReader reader(filenames, 4, 3);
+	size_t                index;
+	Core::LineReaderPtr   lines;
+	std::vector<bool>     seen(count, false);
+	bool                  linesMatch = true;
+
+	while (reader.nextFile(index, lines))
+	{
+		TEST_TRUE(index < count);
+		TEST_FALSE(seen[index]);
+
+		seen[index] = true;
+
+		Core::LineIterator it(lines);
+		Core::LineIterator end;
+
+		if ( (it == end) || (*it != Core::fmt(TXT("file %u"), static_cast<uint>(index))) )
+			linesMatch = false;
+		else if ( (++it == end) || (*it != TXT("line 2")) || (++it != end) )
+			linesMatch = false;
+	}
+
+	TEST_TRUE(linesMatch);
+	TEST_TRUE(std::count(seen.begin(), seen.end(), true) == static_cast<ptrdiff_t>(count));
+}
+TEST_CASE_END
+
+TEST_CASE("an ordered batch returns the files in the order given")
+{
+	Core::BatchFileReader reader(filenames, 4, 3, Core::BatchFileReader::ORDERED);
+	size_t                index;
+	Core::LineReaderPtr   lines;
+	size_t                expected = 0;
+	bool                  inOrder = true;
+
+	while (reader.nextFile(index, lines))
+	{
+		if (index != expected++)
+			inOrder = false;
+	}
+
+	TEST_TRUE(inOrder);
+	TEST_TRUE(expected == count);
+}
+TEST_CASE_END
+
+TEST_CASE("an empty file has no lines")
+{
+	Core::BatchFileReader reader(Filenames(1, emptyFile));
+	size_t                index;
+	Core::LineReaderPtr   lines;
+	Core::TextRange       line;
+
+	TEST_TRUE(reader.nextFile(index, lines) && (index == 0));
+	TEST_FALSE(lines->readLine(line));
+	TEST_FALSE(reader.nextFile(index, lines));
+}
+TEST_CASE_END
+
+TEST_CASE("a file that cannot be read throws when reached without stopping the batch")
+{
+	Filenames batch;
+
+	batch.push_back(TXT(".\\invalid_local_file_name.txt"));
+	batch.push_back(filenames[0]);
+
+	Core::BatchFileReader reader(batch, 1);
+	size_t                index;
+	Core::LineReaderPtr   lines;
+
+	TEST_THROWS(reader.nextFile(index, lines));
+	TEST_TRUE(reader.nextFile(index, lines) && (index == 1));
+	TEST_FALSE(reader.nextFile(index, lines));
+}
+TEST_CASE_END
+
+TEST_CASE("a file that cannot be read throws the original exception type")
+{
+	Filenames batch;
+
+	batch.push_back(TXT(".\\invalid_local_file_name.txt"));
+
+	Core::BatchFileReader reader(batch, 1);
+	size_t                index;
+	Core::LineReaderPtr   lines;
+
+	try
+	{
+		reader.nextFile(index, lines);
+
+		TEST_FAILED("nextFile did not throw");
+	}
+	catch (const Core::FileSystemException& /*e*/)
+	{
+		TEST_PASSED("nextFile threw the original exception");
+	}
+
+	TEST_FALSE(reader.nextFile(index, lines));
+}
+TEST_CASE_END
+
+TEST_CASE("destroying the reader before all files are returned stops the workers")
+{
+	{
+		Core::BatchFileReader reader(filenames, 2, 1);
+		size_t                index;
+		Core::LineReaderPtr   lines;
+
+		TEST_TRUE(reader.nextFile(index, lines));
+	}
+
+	TEST_PASSED("reader destroyed");
+}
+TEST_CASE_END
+
+	for (Filenames::const_iterator it = filenames.begin(); it != filenames.end(); ++it)
+		Core::deleteFile(*it, true);
+
+	Core::deleteFile(emptyFile, true);
+}
+TEST_SET_END
@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   BufferedLineReaderTests.cpp
+//! \brief  The unit tests for the BufferedLineReader class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/BufferedLineReader.hpp>
+#include <Core/LineIterator.hpp>
+#include <sstream>
+#include <streambuf>
+#include <io.h>
+#include <fcntl.h>
+
+class ShortReadBuffer : public std::streambuf
+{
+public:
+	ShortReadBuffer(const char** chunks, size_t count)
+		: m_chunks(chunks)
+		, m_count(count)
+		, m_reads(0)
+	{
+	}
+
+	virtual int_type underflow()
+	{
+		if (m_reads == m_count)
+			return traits_type::eof();
+
+		char* chunk = const_cast<char*>(m_chunks[m_reads++]);
+
+		setg(chunk, chunk, chunk + strlen(chunk));
+
+		return traits_type::to_int_type(*gptr());
+	}
+
+	const char**	m_chunks;
+	size_t			m_count;
+	size_t			m_reads;
+};
+
+TEST_SET(BufferedLineReader)
+{
+
+TEST_CASE("lines are read from a stream across block boundaries")
+{
+	std::istringstream       stream("first\r\nsecond line\n\nlast");
+	Core::BufferedLineReader reader(stream, 3);
+	Core::TextRange          line;
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("first")));
+	TEST_TRUE(reader.readLine(line) && (line == TXT("second line")));
+	TEST_TRUE(reader.readLine(line) && line.empty());
+	TEST_TRUE(reader.readLine(line) && (line == TXT("last")));
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("an empty stream has no lines")
+{
+	std::istringstream       stream("");
+	Core::BufferedLineReader reader(stream);
+	Core::TextRange          line;
+
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("a line from a stream is returned without waiting for a full block")
+{
+	const char*              chunks[] = { "line 1\n", "line 2\n" };
+	ShortReadBuffer          buffer(chunks, ARRAY_SIZE(chunks));
+	std::istream             stream(&buffer);
+	Core::BufferedLineReader reader(stream);
+	Core::TextRange          line;
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("line 1")));
+	TEST_TRUE(buffer.m_reads == 1);
+	TEST_TRUE(reader.readLine(line) && (line == TXT("line 2")));
+	TEST_TRUE(buffer.m_reads == 2);
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("lines are read from a file descriptor such as a pipe")
+{
+	const char* text = "line 1\r\nline 2\n";
+	int         fds[2];
+
+	TEST_TRUE(::_pipe(fds, 1024, _O_BINARY) == 0);
+	TEST_TRUE(::_write(fds[1], text, static_cast<uint>(strlen(text))) == static_cast<int>(strlen(text)));
+
+	::_close(fds[1]);
+
+	Core::LineIterator end;
+	Core::LineIterator it(Core::LineReaderPtr(new Core::BufferedLineReader(fds[0], 4)));
+
+	TEST_TRUE(*it == TXT("line 1"));
+	TEST_TRUE(*++it == TXT("line 2"));
+	TEST_TRUE(++it == end);
+
+	::_close(fds[0]);
+}
+TEST_CASE_END
+
+TEST_CASE("a zero block size or invalid file descriptor throws an exception")
+{
+	std::istringstream stream("");
+
+	TEST_THROWS(Core::BufferedLineReader(stream, 0));
+	TEST_THROWS(Core::BufferedLineReader(-1));
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
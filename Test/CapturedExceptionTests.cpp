@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   CapturedExceptionTests.cpp
+//! \brief  The unit tests for the CapturedException class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/CapturedException.hpp>
+#include <Core/FileSystemException.hpp>
+#include <Core/InvalidArgException.hpp>
+#include <Core/RuntimeException.hpp>
+#include <stdexcept>
+
+static void captureFileSystemException(Core::CapturedException& captured)
+{
+	try
+	{
+		throw Core::FileSystemException(TXT("Test Exception"));
+	}
+	catch (...)
+	{
+		captured.capture();
+	}
+}
+
+TEST_SET(CapturedException)
+{
+
+TEST_CASE("nothing is captured initially")
+{
+	Core::CapturedException captured;
+
+	TEST_FALSE(captured.isCaptured());
+}
+TEST_CASE_END
+
+TEST_CASE("a captured Core exception is rethrown with its original type")
+{
+	Core::CapturedException captured;
+
+	captureFileSystemException(captured);
+
+	TEST_TRUE(captured.isCaptured());
+	TEST_TRUE(tstrstr(captured.twhat(), TXT("Test Exception")) != nullptr);
+
+	try
+	{
+		captured.rethrow();
+
+		TEST_FAILED("rethrow did not throw");
+	}
+	catch (const Core::FileSystemException& exception)
+	{
+		TEST_TRUE(tstrstr(exception.twhat(), TXT("Test Exception")) != nullptr);
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("a copy shares the captured exception")
+{
+	Core::CapturedException captured;
+
+	captureFileSystemException(captured);
+
+	Core::CapturedException copy(captured);
+
+	captured.reset();
+
+	TEST_FALSE(captured.isCaptured());
+	TEST_TRUE(copy.isCaptured());
+	TEST_THROWS(copy.rethrow());
+}
+TEST_CASE_END
+
+TEST_CASE("a standard exception is rethrown as a runtime exception with the same details")
+{
+	Core::CapturedException captured;
+
+	try
+	{
+		throw std::logic_error("Test Exception");
+	}
+	catch (...)
+	{
+		captured.capture();
+	}
+
+	try
+	{
+		captured.rethrow();
+
+		TEST_FAILED("rethrow did not throw");
+	}
+	catch (const Core::RuntimeException& exception)
+	{
+		TEST_TRUE(tstrstr(exception.twhat(), TXT("Test Exception")) != nullptr);
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("an unknown exception is rethrown as a runtime exception")
+{
+	Core::CapturedException captured;
+
+	try
+	{
+		throw 42;
+	}
+	catch (...)
+	{
+		captured.capture();
+	}
+
+	try
+	{
+		captured.rethrow();
+
+		TEST_FAILED("rethrow did not throw");
+	}
+	catch (const Core::RuntimeException& /*e*/)
+	{
+		TEST_PASSED("rethrow threw a runtime exception");
+	}
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
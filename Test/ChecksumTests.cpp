@@ -0,0 +1,38 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ChecksumTests.cpp
+//! \brief  The unit tests for the checksum functions.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/Checksum.hpp>
+
+TEST_SET(Checksum)
+{
+
+TEST_CASE("the crc32 of no bytes is zero")
+{
+	TEST_TRUE(Core::crc32("", 0) == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("the crc32 matches the standard check value")
+{
+	const char* data = "123456789";
+
+	TEST_TRUE(Core::crc32(data, 9) == 0xCBF43926);
+}
+TEST_CASE_END
+
+TEST_CASE("the crc32 can be calculated incrementally")
+{
+	const char* data = "123456789";
+
+	const uint first = Core::crc32(data, 4);
+
+	TEST_TRUE(Core::crc32(data + 4, 5, first) == Core::crc32(data, 9));
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   CompressedLineReaderTests.cpp
+//! \brief  The unit tests for the CompressedLineReader class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/CompressedLineReader.hpp>
+#include <Core/ReadAheadLineReader.hpp>
+#include <Core/LineIterator.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include "FileTest.hpp"
+
+#ifdef CORE_USE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef CORE_USE_ZLIB
+static void createGzipFile(const tstring& path, const std::string& contents)
+{
+	gzFile file = ::gzopen(T2A(path), "wb");
+
+	::gzwrite(file, contents.data(), static_cast<unsigned>(contents.size()));
+	::gzclose(file);
+}
+#endif
+
+TEST_SET(CompressedLineReader)
+{
+	const tstring testFile = Core::combinePaths(Core::getTempFolder(), TXT("core_compressed_test_file"));
+
+TEST_CASE("construction with a zero block size throws an exception")
+{
+	createFile(testFile, "");
+
+	TEST_THROWS(Core::CompressedLineReader(testFile, 0));
+}
+TEST_CASE_END
+
+TEST_CASE("the lines of an uncompressed file are read")
+{
+	createFile(testFile, "first\r\nsecond line\n\nlast");
+
+	Core::CompressedLineReader reader(testFile, 3);
+	Core::TextRange            line;
+
+	TEST_TRUE(reader.format() == Core::Decompressor::PLAIN);
+	TEST_TRUE(reader.readLine(line) && (line == TXT("first")));
+	TEST_TRUE(reader.readLine(line) && (line == TXT("second line")));
+	TEST_TRUE(reader.readLine(line) && line.empty());
+	TEST_TRUE(reader.readLine(line) && (line == TXT("last")));
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+#ifdef CORE_USE_ZLIB
+TEST_CASE("the lines of a gzip file are read")
+{
+	createGzipFile(testFile, "first\r\nsecond line\n\nlast");
+
+	Core::CompressedLineReader reader(testFile, 3);
+	Core::TextRange            line;
+
+	TEST_TRUE(reader.format() == Core::Decompressor::GZIP);
+	TEST_TRUE(reader.readLine(line) && (line == TXT("first")));
+	TEST_TRUE(reader.readLine(line) && (line == TXT("second line")));
+	TEST_TRUE(reader.readLine(line) && line.empty());
+	TEST_TRUE(reader.readLine(line) && (line == TXT("last")));
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("a gzip file can be decompressed on a background thread")
+{
+	createGzipFile(testFile, "line 1\nline 2\n");
+
+	Core::ByteSourcePtr source(new Core::Decompressor(testFile));
+	Core::LineIterator  it(Core::LineReaderPtr(new Core::ReadAheadLineReader(source, 4)));
+	Core::LineIterator  end;
+
+	TEST_TRUE(*it == TXT("line 1"));
+	TEST_TRUE(*++it == TXT("line 2"));
+	TEST_TRUE(++it == end);
+}
+TEST_CASE_END
+#endif
+
+	Core::deleteFile(testFile, true);
+}
+TEST_SET_END
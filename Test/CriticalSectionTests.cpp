@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   CriticalSectionTests.cpp
+//! \brief  The unit tests for the CriticalSection class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/CriticalSection.hpp>
+#include <Core/Thread.hpp>
+
+struct Counter
+{
+	Core::CriticalSection	m_lock;
+	long					m_value;
+};
+
+static void incrementCounter(void* param)
+{
+	Counter* counter = static_cast<Counter*>(param);
+
+	for (int i = 0; i != 10000; ++i)
+	{
+		Core::AutoLock lock(counter->m_lock);
+
+		++counter->m_value;
+	}
+}
+
+TEST_SET(CriticalSection)
+{
+
+TEST_CASE("the lock can be re-entered by the thread that holds it")
+{
+	Core::CriticalSection section;
+
+	{
+		Core::AutoLock outer(section);
+		Core::AutoLock inner(section);
+	}
+
+	TEST_PASSED("lock re-entered");
+}
+TEST_CASE_END
+
+TEST_CASE("the lock serialises access between threads")
+{
+	Counter counter;
+
+	counter.m_value = 0;
+
+	{
+		Core::Thread first(incrementCounter, &counter);
+		Core::Thread second(incrementCounter, &counter);
+
+		first.join();
+		second.join();
+	}
+
+	TEST_TRUE(counter.m_value == 20000);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,180 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   CsvReaderTests.cpp
+//! \brief  The unit tests for the CsvReader class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/CsvReader.hpp>
+#include <sstream>
+
+TEST_SET(CsvReader)
+{
+	typedef Core::CsvReader::Fields Fields;
+
+TEST_CASE("an empty stream returns no records")
+{
+	tistringstream  stream(TXT(""));
+	Core::CsvReader reader(stream);
+	Fields          fields;
+
+	TEST_FALSE(reader.readRecord(fields));
+}
+TEST_CASE_END
+
+TEST_CASE("each line is returned as a separate record")
+{
+	tistringstream  stream(TXT("a,b\nc,d\n"));
+	Core::CsvReader reader(stream);
+	Fields          fields;
+
+	TEST_TRUE(reader.readRecord(fields));
+	TEST_TRUE(fields.size() == 2);
+	TEST_TRUE(fields[0] == TXT("a"));
+	TEST_TRUE(fields[1] == TXT("b"));
+
+	TEST_TRUE(reader.readRecord(fields));
+	TEST_TRUE(fields.size() == 2);
+	TEST_TRUE(fields[0] == TXT("c"));
+	TEST_TRUE(fields[1] == TXT("d"));
+
+	TEST_FALSE(reader.readRecord(fields));
+}
+TEST_CASE_END
+
+TEST_CASE("the final record does not need to be terminated by a newline")
+{
+	tistringstream  stream(TXT("a,b\r\nc,d"));
+	Core::CsvReader reader(stream);
+	Fields          fields;
+
+	TEST_TRUE(reader.readRecord(fields));
+	TEST_TRUE(fields[1] == TXT("b"));
+	TEST_TRUE(reader.readRecord(fields));
+	TEST_TRUE(fields[1] == TXT("d"));
+	TEST_FALSE(reader.readRecord(fields));
+}
+TEST_CASE_END
+
+TEST_CASE("empty fields are returned for consecutive separators")
+{
+	tistringstream  stream(TXT(",,\n"));
+	Core::CsvReader reader(stream);
+	Fields          fields;
+
+	TEST_TRUE(reader.readRecord(fields));
+	TEST_TRUE(fields.size() == 3);
+	TEST_TRUE(fields[0].empty() && fields[1].empty() && fields[2].empty());
+}
+TEST_CASE_END
+
+TEST_CASE("consecutive separators are treated as one when merging is enabled")
+{
+	tistringstream  stream(TXT("a\t\tb\n"));
+	Core::CsvReader reader(stream, TXT('\t'), Core::Tokeniser::MERGE_SEPS);
+	Fields          fields;
+
+	TEST_TRUE(reader.readRecord(fields));
+	TEST_TRUE(fields.size() == 2);
+	TEST_TRUE(fields[0] == TXT("a"));
+	TEST_TRUE(fields[1] == TXT("b"));
+}
+TEST_CASE_END
+
+TEST_CASE("quoted fields can contain separators, newlines and escaped quotes")
+{
+	tistringstream  stream(TXT("\"a,b\",\"c\r\nd\",\"e\"\"f\"\r\n"));
+	Core::CsvReader reader(stream);
+	Fields          fields;
+
+	TEST_TRUE(reader.readRecord(fields));
+	TEST_TRUE(fields.size() == 3);
+	TEST_TRUE(fields[0] == TXT("a,b"));
+	TEST_TRUE(fields[1] == TXT("c\r\nd"));
+	TEST_TRUE(fields[2] == TXT("e\"f"));
+	TEST_FALSE(reader.readRecord(fields));
+}
+TEST_CASE_END
+
+TEST_CASE("the quote and escape characters are configurable")
+{
+	tistringstream  stream(TXT("'a\\'b';'c\\\\'\n"));
+	Core::CsvReader reader(stream, TXT(';'), Core::Tokeniser::QUOTED_FIELDS, TXT('\''), TXT('\\'));
+	Fields          fields;
+
+	TEST_TRUE(reader.readRecord(fields));
+	TEST_TRUE(fields.size() == 2);
+	TEST_TRUE(fields[0] == TXT("a'b"));
+	TEST_TRUE(fields[1] == TXT("c\\"));
+}
+TEST_CASE_END
+
+TEST_CASE("quotes are treated as normal characters when quoting is disabled")
+{
+	tistringstream  stream(TXT("\"a\",b\n"));
+	Core::CsvReader reader(stream, TXT(','), Core::Tokeniser::NONE);
+	Fields          fields;
+
+	TEST_TRUE(reader.readRecord(fields));
+	TEST_TRUE(fields[0] == TXT("\"a\""));
+}
+TEST_CASE_END
+
+TEST_CASE("records that straddle chunks are returned intact")
+{
+	tistringstream  stream(TXT("abc,\"d,\"\"e\"\nfghijklmnop,q\n"));
+	Core::CsvReader reader(stream, TXT(','), Core::Tokeniser::QUOTED_FIELDS, TXT('"'), TXT('"'), 3);
+	Fields          fields;
+
+	TEST_TRUE(reader.readRecord(fields));
+	TEST_TRUE(fields.size() == 2);
+	TEST_TRUE(fields[0] == TXT("abc"));
+	TEST_TRUE(fields[1] == TXT("d,\"e"));
+
+	TEST_TRUE(reader.readRecord(fields));
+	TEST_TRUE(fields.size() == 2);
+	TEST_TRUE(fields[0] == TXT("fghijklmnop"));
+	TEST_TRUE(fields[1] == TXT("q"));
+
+	TEST_FALSE(reader.readRecord(fields));
+}
+TEST_CASE_END
+
+TEST_CASE("an unterminated quoted field throws an exception")
+{
+	tistringstream  stream(TXT("\"abc\n"));
+	Core::CsvReader reader(stream);
+	Fields          fields;
+
+	TEST_THROWS(reader.readRecord(fields));
+}
+TEST_CASE_END
+
+TEST_CASE("text after a closing quote throws an exception")
+{
+	tistringstream  stream(TXT("\"abc\"d\n"));
+	Core::CsvReader reader(stream);
+	Fields          fields;
+
+	TEST_THROWS(reader.readRecord(fields));
+}
+TEST_CASE_END
+
+TEST_CASE("requesting separators be returned throws an exception")
+{
+	tistringstream stream(TXT(""));
+
+	TEST_THROWS(Core::CsvReader(stream, TXT(','), Core::Tokeniser::RETURN_SEPS));
+}
+TEST_CASE_END
+
+TEST_CASE("construction from an invalid filename throws an exception")
+{
+	tstring invalidFile = TXT(".\\invalid_local_file_name.csv");
+
+	TEST_THROWS(Core::CsvReader(invalidFile));
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
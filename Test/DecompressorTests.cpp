@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   DecompressorTests.cpp
+//! \brief  The unit tests for the Decompressor class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/Decompressor.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include "FileTest.hpp"
+
+#ifdef CORE_USE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef CORE_USE_ZSTD
+#include <zstd.h>
+#endif
+
+static std::string readAll(Core::Decompressor& decompressor, size_t blockSize)
+{
+	std::string       contents;
+	std::vector<char> buffer(blockSize);
+	size_t            read;
+
+	while ((read = decompressor.read(&buffer.front(), buffer.size())) != 0)
+		contents.append(&buffer.front(), read);
+
+	return contents;
+}
+
+#ifdef CORE_USE_ZLIB
+static std::string gzipCompress(const std::string& text)
+{
+	z_stream stream;
+
+	memset(&stream, 0, sizeof(stream));
+
+	::deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15+16, 8, Z_DEFAULT_STRATEGY);
+
+	std::vector<char> buffer(::deflateBound(&stream, static_cast<uLong>(text.size())) + 32);
+
+	stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(text.data()));
+	stream.avail_in = static_cast<uInt>(text.size());
+	stream.next_out = reinterpret_cast<Bytef*>(&buffer.front());
+	stream.avail_out = static_cast<uInt>(buffer.size());
+
+	::deflate(&stream, Z_FINISH);
+	::deflateEnd(&stream);
+
+	return std::string(&buffer.front(), buffer.size() - stream.avail_out);
+}
+#endif
+
+#ifdef CORE_USE_ZSTD
+static std::string zstdCompress(const std::string& text)
+{
+	std::vector<char> buffer(::ZSTD_compressBound(text.size()));
+
+	size_t size = ::ZSTD_compress(&buffer.front(), buffer.size(), text.data(), text.size(), 1);
+
+	return std::string(&buffer.front(), size);
+}
+#endif
+
+TEST_SET(Decompressor)
+{
+	const tstring testFile = Core::combinePaths(Core::getTempFolder(), TXT("core_decompressor_test_file"));
+
+	std::string text;
+
+	for (int i = 0; i != 1000; ++i)
+		text += "the quick brown fox jumps over the lazy dog\n";
+
+TEST_CASE("construction with a zero input size throws an exception")
+{
+	createFile(testFile, text);
+
+	TEST_THROWS(Core::Decompressor(testFile, 0));
+}
+TEST_CASE_END
+
+TEST_CASE("construction from an invalid filename throws an exception")
+{
+	tstring invalidFile = TXT(".\\invalid_local_file_name.txt");
+
+	TEST_THROWS(Core::Decompressor(invalidFile));
+}
+TEST_CASE_END
+
+TEST_CASE("an uncompressed file is passed through unchanged")
+{
+	createFile(testFile, text);
+
+	Core::Decompressor decompressor(testFile, 100);
+
+	TEST_TRUE(decompressor.format() == Core::Decompressor::PLAIN);
+	TEST_TRUE(readAll(decompressor, 77) == text);
+}
+TEST_CASE_END
+
+TEST_CASE("an empty or very short file is uncompressed")
+{
+	createFile(testFile, "");
+
+	Core::Decompressor empty(testFile);
+
+	TEST_TRUE(empty.format() == Core::Decompressor::PLAIN);
+	TEST_TRUE(readAll(empty, 10).empty());
+
+	createFile(testFile, "\x1F");
+
+	Core::Decompressor shortFile(testFile);
+
+	TEST_TRUE(shortFile.format() == Core::Decompressor::PLAIN);
+	TEST_TRUE(readAll(shortFile, 10) == "\x1F");
+}
+TEST_CASE_END
+
+TEST_CASE("plain files are always supported")
+{
+	TEST_TRUE(Core::Decompressor::isSupported(Core::Decompressor::PLAIN));
+}
+TEST_CASE_END
+
+#ifdef CORE_USE_ZLIB
+TEST_CASE("a gzip file is detected and decompressed")
+{
+	createFile(testFile, gzipCompress(text));
+
+	Core::Decompressor decompressor(testFile, 64);
+
+	TEST_TRUE(decompressor.format() == Core::Decompressor::GZIP);
+	TEST_TRUE(readAll(decompressor, 1000) == text);
+}
+TEST_CASE_END
+
+TEST_CASE("concatenated gzip members are decompressed as one stream")
+{
+	createFile(testFile, gzipCompress("first\n") + gzipCompress("second\n"));
+
+	Core::Decompressor decompressor(testFile, 7);
+
+	TEST_TRUE(readAll(decompressor, 3) == "first\nsecond\n");
+}
+TEST_CASE_END
+
+TEST_CASE("a truncated gzip file throws an exception")
+{
+	const std::string compressed = gzipCompress(text);
+
+	createFile(testFile, compressed.substr(0, compressed.size()/2));
+
+	Core::Decompressor decompressor(testFile);
+
+	TEST_THROWS(readAll(decompressor, 1000));
+}
+TEST_CASE_END
+#else
+TEST_CASE("a gzip file throws an exception when zlib is not enabled")
+{
+	createFile(testFile, "\x1F\x8B\x08\x00");
+
+	TEST_FALSE(Core::Decompressor::isSupported(Core::Decompressor::GZIP));
+	TEST_THROWS(Core::Decompressor(testFile));
+}
+TEST_CASE_END
+#endif
+
+#ifdef CORE_USE_ZSTD
+TEST_CASE("a zstd file is detected and decompressed")
+{
+	createFile(testFile, zstdCompress(text));
+
+	Core::Decompressor decompressor(testFile, 64);
+
+	TEST_TRUE(decompressor.format() == Core::Decompressor::ZSTD);
+	TEST_TRUE(readAll(decompressor, 1000) == text);
+}
+TEST_CASE_END
+
+TEST_CASE("concatenated zstd frames are decompressed as one stream")
+{
+	createFile(testFile, zstdCompress("first\n") + zstdCompress("second\n"));
+
+	Core::Decompressor decompressor(testFile, 7);
+
+	TEST_TRUE(readAll(decompressor, 3) == "first\nsecond\n");
+}
+TEST_CASE_END
+
+TEST_CASE("a truncated zstd file throws an exception")
+{
+	const std::string compressed = zstdCompress(text);
+
+	createFile(testFile, compressed.substr(0, compressed.size()/2));
+
+	Core::Decompressor decompressor(testFile);
+
+	TEST_THROWS(readAll(decompressor, 1000));
+}
+TEST_CASE_END
+#else
+TEST_CASE("a zstd file throws an exception when zstd is not enabled")
+{
+	createFile(testFile, "\x28\xB5\x2F\xFD");
+
+	TEST_FALSE(Core::Decompressor::isSupported(Core::Decompressor::ZSTD));
+	TEST_THROWS(Core::Decompressor(testFile));
+}
+TEST_CASE_END
+#endif
+
+	Core::deleteFile(testFile, true);
+}
+TEST_SET_END
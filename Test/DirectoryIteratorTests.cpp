@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   DirectoryIteratorTests.cpp
+//! \brief  The unit tests for the DirectoryIterator class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/DirectoryIterator.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include "FileTest.hpp"
+#include <map>
+
+typedef std::map<tstring, Core::DirectoryEntry> Entries;
+
+static Entries readEntries(Core::DirectoryIterator& it)
+{
+	Entries              entries;
+	Core::DirectoryEntry entry;
+
+	while (it.next(entry))
+		entries[entry.name()] = entry;
+
+	return entries;
+}
+
+TEST_SET(DirectoryIterator)
+{
+	const tstring folder = Core::combinePaths(Core::getTempFolder(), TXT("core_dir_iterator_test"));
+	const tstring emptyFolder = Core::combinePaths(folder, TXT("empty"));
+
+	Core::createFolder(folder);
+	Core::createFolder(emptyFolder);
+
+	createFile(Core::combinePaths(folder, TXT("one.txt")), "1");
+	createFile(Core::combinePaths(folder, TXT("three.log")), "333");
+
+TEST_CASE("enumerating a missing folder throws an exception")
+{
+	const tstring invalidFolder = TXT(".\\invalid_local_folder_name");
+
+	TEST_THROWS(Core::DirectoryIterator(invalidFolder));
+}
+TEST_CASE_END
+
+TEST_CASE("an empty folder has no entries")
+{
+	Core::DirectoryIterator it(emptyFolder);
+	Core::DirectoryEntry    entry;
+
+	TEST_TRUE(it.folder() == emptyFolder);
+	TEST_FALSE(it.next(entry));
+	TEST_FALSE(it.next(entry));
+}
+TEST_CASE_END
+
+TEST_CASE("every file and folder is returned along with its metadata")
+{
+	Core::DirectoryIterator it(folder);
+	Entries                 entries = readEntries(it);
+
+	TEST_TRUE(entries.size() == 3);
+
+	TEST_TRUE(entries.count(TXT("empty")) == 1);
+	TEST_TRUE(entries[TXT("empty")].isFolder());
+
+	TEST_TRUE(entries.count(TXT("one.txt")) == 1);
+	TEST_FALSE(entries[TXT("one.txt")].isFolder());
+	TEST_TRUE(entries[TXT("one.txt")].size() == 1);
+
+	TEST_TRUE(entries.count(TXT("three.log")) == 1);
+	TEST_TRUE(entries[TXT("three.log")].size() == 3);
+}
+TEST_CASE_END
+
+TEST_CASE("only the entries matching the wildcard are returned")
+{
+	Core::DirectoryIterator it(folder, TXT("*.log"));
+	Entries                 entries = readEntries(it);
+
+	TEST_TRUE(entries.size() == 1);
+	TEST_TRUE(entries.count(TXT("three.log")) == 1);
+}
+TEST_CASE_END
+
+TEST_CASE("a wildcard that matches nothing returns no entries")
+{
+	Core::DirectoryIterator it(folder, TXT("*.dat"));
+	Core::DirectoryEntry    entry;
+
+	TEST_FALSE(it.next(entry));
+}
+TEST_CASE_END
+
+	Core::deleteFile(Core::combinePaths(folder, TXT("one.txt")), true);
+	Core::deleteFile(Core::combinePaths(folder, TXT("three.log")), true);
+	Core::deleteFolder(emptyFolder, true);
+	Core::deleteFolder(folder, true);
+}
+TEST_SET_END
@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   DirectoryWalkerTests.cpp
+//! \brief  The unit tests for the DirectoryWalker class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/DirectoryWalker.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include <Core/CriticalSection.hpp>
+#include <Core/InvalidArgException.hpp>
+#include "FileTest.hpp"
+#include <vector>
+#include <algorithm>
+
+class CollectingHandler : public Core::DirectoryWalker::Handler
+{
+public:
+	CollectingHandler(const tstring& root)
+		: m_root(root)
+		, m_filterExtension()
+		, m_pruneFolder()
+		, m_throwOn()
+		, m_walker(nullptr)
+	{
+	}
+
+	virtual bool filter(const tstring& /*folder*/, const Core::DirectoryEntry& entry)
+	{
+		const tstring& name = entry.name();
+		const size_t   length = m_filterExtension.length();
+
+		return (length == 0) || ( (name.length() >= length) && (name.compare(name.length() - length, length, m_filterExtension) == 0) );
+	}
+
+	virtual bool prune(const tstring& /*folder*/, const Core::DirectoryEntry& entry)
+	{
+		return (entry.name() == m_pruneFolder);
+	}
+
+	virtual void processEntry(const tstring& folder, const Core::DirectoryEntry& entry)
+	{
+		if (entry.name() == m_throwOn)
+			throw Core::InvalidArgException(TXT("Handler failed"));
+
+		if (m_walker != nullptr)
+			m_walker->cancel();
+
+		Core::AutoLock lock(m_lock);
+
+		m_paths.push_back(Core::combinePaths(folder, entry.name()).substr(m_root.length() + 1));
+	}
+
+	std::vector<tstring> sortedPaths()
+	{
+		std::sort(m_paths.begin(), m_paths.end());
+
+		return m_paths;
+	}
+
+	tstring					m_root;
+	tstring					m_filterExtension;
+	tstring					m_pruneFolder;
+	tstring					m_throwOn;
+	Core::DirectoryWalker*	m_walker;
+	Core::CriticalSection	m_lock;
+	std::vector<tstring>	m_paths;
+};
+
+TEST_SET(DirectoryWalker)
+{
+	const tstring root = Core::combinePaths(Core::getTempFolder(), TXT("core_dir_walker_test"));
+
+	const tchar* folders[] = { TXT("d1"), TXT("d1\\d2"), TXT("d3") };
+	const tchar* files[] = { TXT("a.txt"), TXT("d1\\b.txt"), TXT("d1\\d2\\c.txt"), TXT("d1\\d2\\e.log") };
+
+	Core::createFolder(root);
+
+	for (size_t i = 0; i != ARRAY_SIZE(folders); ++i)
+		Core::createFolder(Core::combinePaths(root, folders[i]));
+
+	for (size_t i = 0; i != ARRAY_SIZE(files); ++i)
+		createFile(Core::combinePaths(root, files[i]), "text");
+
+TEST_CASE("walking a missing root throws an exception")
+{
+	const tstring invalidFolder = TXT(".\\invalid_local_folder_name");
+
+	Core::DirectoryWalker walker(invalidFolder);
+	CollectingHandler     handler(invalidFolder);
+
+	TEST_THROWS(walker.walk(handler));
+}
+TEST_CASE_END
+
+TEST_CASE("every entry below the root is processed once whatever the number of threads")
+{
+	for (size_t threads = 1; threads != 5; ++threads)
+	{
+		Core::DirectoryWalker walker(root, threads);
+		CollectingHandler     handler(root);
+
+		TEST_TRUE(walker.walk(handler));
+
+		const std::vector<tstring> paths = handler.sortedPaths();
+
+		TEST_TRUE(paths.size() == 7);
+		TEST_TRUE(paths[0] == TXT("a.txt"));
+		TEST_TRUE(paths[1] == TXT("d1"));
+		TEST_TRUE(paths[2] == TXT("d1\\b.txt"));
+		TEST_TRUE(paths[3] == TXT("d1\\d2"));
+		TEST_TRUE(paths[4] == TXT("d1\\d2\\c.txt"));
+		TEST_TRUE(paths[5] == TXT("d1\\d2\\e.log"));
+		TEST_TRUE(paths[6] == TXT("d3"));
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("filtered out folders are still walked")
+{
+	Core::DirectoryWalker walker(root, 2);
+	CollectingHandler     handler(root);
+
+	handler.m_filterExtension = TXT(".txt");
+
+	walker.walk(handler);
+
+	const std::vector<tstring> paths = handler.sortedPaths();
+
+	TEST_TRUE(paths.size() == 3);
+	TEST_TRUE(paths[0] == TXT("a.txt"));
+	TEST_TRUE(paths[1] == TXT("d1\\b.txt"));
+	TEST_TRUE(paths[2] == TXT("d1\\d2\\c.txt"));
+}
+TEST_CASE_END
+
+TEST_CASE("a pruned folder is processed but not walked")
+{
+	Core::DirectoryWalker walker(root, 2);
+	CollectingHandler     handler(root);
+
+	handler.m_pruneFolder = TXT("d2");
+
+	walker.walk(handler);
+
+	const std::vector<tstring> paths = handler.sortedPaths();
+
+	TEST_TRUE(paths.size() == 5);
+	TEST_TRUE(paths[3] == TXT("d1\\d2"));
+	TEST_TRUE(paths[4] == TXT("d3"));
+}
+TEST_CASE_END
+
+TEST_CASE("a handler failure stops the walk and is rethrown")
+{
+	Core::DirectoryWalker walker(root, 2);
+	CollectingHandler     handler(root);
+
+	handler.m_throwOn = TXT("d2");
+
+	TEST_THROWS(walker.walk(handler));
+	TEST_TRUE(walker.isCancelled());
+}
+TEST_CASE_END
+
+TEST_CASE("a handler failure keeps its type when rethrown")
+{
+	Core::DirectoryWalker walker(root, 2);
+	CollectingHandler     handler(root);
+
+	handler.m_throwOn = TXT("b.txt");
+
+	try
+	{
+		walker.walk(handler);
+
+		TEST_FAILED("walk did not throw");
+	}
+	catch (const Core::InvalidArgException& exception)
+	{
+		TEST_TRUE(tstrstr(exception.twhat(), TXT("Handler failed")) != nullptr);
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("cancelling the walk from the handler returns false")
+{
+	Core::DirectoryWalker walker(root, 1);
+	CollectingHandler     handler(root);
+
+	handler.m_walker = &walker;
+
+	TEST_FALSE(walker.walk(handler));
+	TEST_TRUE(handler.m_paths.size() == 1);
+}
+TEST_CASE_END
+
+	for (size_t i = 0; i != ARRAY_SIZE(files); ++i)
+		Core::deleteFile(Core::combinePaths(root, files[i]), true);
+
+	for (size_t i = ARRAY_SIZE(folders); i != 0; --i)
+		Core::deleteFolder(Core::combinePaths(root, folders[i-1]), true);
+
+	Core::deleteFolder(root, true);
+}
+TEST_SET_END
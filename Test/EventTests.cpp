@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   EventTests.cpp
+//! \brief  The unit tests for the Event class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/Event.hpp>
+#include <Core/Thread.hpp>
+
+static void signalEvent(void* param)
+{
+	static_cast<Core::Event*>(param)->signal();
+}
+
+TEST_SET(Event)
+{
+
+TEST_CASE("waiting on an unsignalled event times out")
+{
+	Core::Event event;
+
+	TEST_FALSE(event.wait(0));
+}
+TEST_CASE_END
+
+TEST_CASE("an auto-reset event is reset once a wait is satisfied")
+{
+	Core::Event event(Core::Event::AUTO_RESET, true);
+
+	TEST_TRUE(event.wait(0));
+	TEST_FALSE(event.wait(0));
+}
+TEST_CASE_END
+
+TEST_CASE("a manual-reset event remains signalled until reset")
+{
+	Core::Event event(Core::Event::MANUAL_RESET);
+
+	event.signal();
+
+	TEST_TRUE(event.wait(0));
+	TEST_TRUE(event.wait(0));
+
+	event.reset();
+
+	TEST_FALSE(event.wait(0));
+}
+TEST_CASE_END
+
+TEST_CASE("an event can be signalled by another thread")
+{
+	Core::Event  event;
+	Core::Thread thread(signalEvent, &event);
+
+	event.wait();
+	thread.join();
+
+	TEST_PASSED("event signalled");
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ExternalSorterTests.cpp
+//! \brief  The unit tests for the ExternalSorter class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/ExternalSorter.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include "FileTest.hpp"
+#include <algorithm>
+
+typedef std::vector<std::string> Lines;
+
+static std::string joinLines(const Lines& lines)
+{
+	std::string contents;
+
+	for (Lines::const_iterator it = lines.begin(); it != lines.end(); ++it)
+		contents += *it + "\n";
+
+	return contents;
+}
+
+TEST_SET(ExternalSorter)
+{
+	const tstring inputFile = Core::combinePaths(Core::getTempFolder(), TXT("core_sort_input_file"));
+	const tstring outputFile = Core::combinePaths(Core::getTempFolder(), TXT("core_sort_output_file"));
+
+TEST_CASE("construction with a zero memory budget throws an exception")
+{
+	TEST_THROWS(Core::ExternalSorter(Core::ExternalSorter::BYTEWISE, false, 0));
+}
+TEST_CASE_END
+
+TEST_CASE("sorting a missing file throws an exception")
+{
+	Core::ExternalSorter sorter;
+
+	TEST_THROWS(sorter.sort(TXT(".\\invalid_local_file_name.txt"), outputFile));
+}
+TEST_CASE_END
+
+TEST_CASE("sorting an empty file creates an empty file")
+{
+	createFile(inputFile, "");
+
+	Core::ExternalSorter sorter;
+
+	sorter.sort(inputFile, outputFile);
+
+	TEST_TRUE(sorter.runCount() == 0);
+	TEST_TRUE(Core::pathExists(outputFile));
+	TEST_TRUE(readFile(outputFile).empty());
+}
+TEST_CASE_END
+
+TEST_CASE("lines are sorted byte by byte and written with a newline")
+{
+	createFile(inputFile, "pear\r\napple\nfig\r\nBanana");
+
+	Core::ExternalSorter sorter;
+
+	sorter.sort(inputFile, outputFile);
+
+	TEST_TRUE(sorter.runCount() == 1);
+	TEST_TRUE(readFile(outputFile) == "Banana\napple\nfig\npear\n");
+}
+TEST_CASE_END
+
+TEST_CASE("a file larger than the memory budget is sorted via many runs")
+{
+	Lines lines;
+
+	for (unsigned i = 0; i != 2000; ++i)
+	{
+		char line[16];
+
+		sprintf(line, "%05u", (i * 7919) % 2000);
+		lines.push_back(line);
+	}
+
+	createFile(inputFile, joinLines(lines));
+
+	Core::ExternalSorter sorter(Core::ExternalSorter::BYTEWISE, false, 64, 2);
+
+	sorter.sort(inputFile, outputFile);
+
+	std::sort(lines.begin(), lines.end());
+
+	TEST_TRUE(sorter.runCount() > Core::ExternalSorter::MAX_MERGE_WIDTH);
+	TEST_TRUE(readFile(outputFile) == joinLines(lines));
+}
+TEST_CASE_END
+
+TEST_CASE("a line longer than the memory budget is kept whole")
+{
+	const std::string longLine(100, 'z');
+
+	createFile(inputFile, longLine + "\nb\na\n");
+
+	Core::ExternalSorter sorter(Core::ExternalSorter::BYTEWISE, false, 8, 1);
+
+	sorter.sort(inputFile, outputFile);
+
+	TEST_TRUE(readFile(outputFile) == "a\nb\n" + longLine + "\n");
+}
+TEST_CASE_END
+
+TEST_CASE("a case-insensitive sort keeps equal lines in their original order")
+{
+	createFile(inputFile, "b\nA\na\nB\n");
+
+	Core::ExternalSorter sorter(Core::ExternalSorter::CASE_INSENSITIVE, false, 4, 2);
+
+	sorter.sort(inputFile, outputFile);
+
+	TEST_TRUE(readFile(outputFile) == "A\na\nb\nB\n");
+}
+TEST_CASE_END
+
+TEST_CASE("a numeric sort orders lines by their leading number")
+{
+	createFile(inputFile, "10 ten\n9\n-1\n 2.50\nnone\n-0.5\n2.5 x\n0010\n");
+
+	Core::ExternalSorter sorter(Core::ExternalSorter::NUMERIC);
+
+	sorter.sort(inputFile, outputFile);
+
+	TEST_TRUE(readFile(outputFile) == "-1\n-0.5\nnone\n 2.50\n2.5 x\n9\n10 ten\n0010\n");
+}
+TEST_CASE_END
+
+TEST_CASE("a unique sort keeps only the first of equal lines across runs")
+{
+	createFile(inputFile, "b\na\nB\nb\na\nA\nc\n");
+
+	Core::ExternalSorter exact(Core::ExternalSorter::BYTEWISE, true, 4, 2);
+
+	exact.sort(inputFile, outputFile);
+
+	TEST_TRUE(exact.runCount() > 1);
+	TEST_TRUE(readFile(outputFile) == "A\nB\na\nb\nc\n");
+
+	Core::ExternalSorter ignoringCase(Core::ExternalSorter::CASE_INSENSITIVE, true, 4, 2);
+
+	ignoringCase.sort(inputFile, outputFile);
+
+	TEST_TRUE(readFile(outputFile) == "a\nb\nc\n");
+}
+TEST_CASE_END
+
+TEST_CASE("a file can be sorted in place")
+{
+	createFile(inputFile, "3\n1\n2\n");
+
+	Core::ExternalSorter sorter(Core::ExternalSorter::NUMERIC, false, 2, 1);
+
+	sorter.sort(inputFile, inputFile);
+
+	TEST_TRUE(readFile(inputFile) == "1\n2\n3\n");
+}
+TEST_CASE_END
+
+	Core::deleteFile(inputFile, true);
+	Core::deleteFile(outputFile, true);
+}
+TEST_SET_END
@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   FileLineReaderTests.cpp
+//! \brief  The unit tests for the FileLineReader class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/FileLineReader.hpp>
+#include <Core/LineIndex.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include <Core/StringUtils.hpp>
+#include "FileTest.hpp"
+
+TEST_SET(FileLineReader)
+{
+	const tstring testFile = Core::combinePaths(Core::getTempFolder(), TXT("core_file_line_reader_test_file.txt"));
+	const size_t  count = 1000;
+	std::string   contents;
+
+	for (size_t i = 0; i != count; ++i)
+		contents += T2A(Core::fmt(TXT("line %u\r\n"), static_cast<uint>(i)));
+
+	createFile(testFile, contents);
+
+TEST_CASE("construction with a zero block size throws an exception")
+{
+	TEST_THROWS(Core::FileLineReader(testFile, 0));
+}
+TEST_CASE_END
+
+TEST_CASE("construction from an invalid filename throws an exception")
+{
+	tstring invalidFile = TXT(".\\invalid_local_file_name.txt");
+
+	TEST_THROWS(Core::FileLineReader(invalidFile));
+}
+TEST_CASE_END
+
+TEST_CASE("lines are read across block boundaries")
+{
+	Core::FileLineReader reader(testFile, 7);
+	Core::TextRange      line;
+	size_t               lines = 0;
+	bool                 inOrder = true;
+
+	for (; reader.readLine(line); ++lines)
+	{
+		if (line != Core::fmt(TXT("line %u"), static_cast<uint>(lines)))
+			inOrder = false;
+	}
+
+	TEST_TRUE(inOrder);
+	TEST_TRUE(lines == count);
+}
+TEST_CASE_END
+
+TEST_CASE("seeking to the start of a line continues reading from that line")
+{
+	Core::FileLineReader reader(testFile, 16);
+	Core::TextRange      line;
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("line 0")));
+
+	reader.seek(8 * 2);
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("line 2")));
+
+	reader.seek(0);
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("line 0")));
+}
+TEST_CASE_END
+
+TEST_CASE("seeking to a line with an index jumps to that line")
+{
+	Core::LineIndex index;
+
+	index.build(testFile, 64);
+
+	Core::FileLineReader reader(testFile, 100);
+	Core::TextRange      line;
+
+	TEST_TRUE(reader.seekLine(index, 777) && reader.readLine(line) && (line == TXT("line 777")));
+	TEST_TRUE(reader.readLine(line) && (line == TXT("line 778")));
+	TEST_TRUE(reader.seekLine(index, 3) && reader.readLine(line) && (line == TXT("line 3")));
+	TEST_TRUE(reader.seekLine(index, count-1) && reader.readLine(line) && (line == Core::fmt(TXT("line %u"), static_cast<uint>(count-1))));
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("seeking beyond the last line fails")
+{
+	Core::LineIndex index;
+
+	index.build(testFile, 64);
+
+	Core::FileLineReader reader(testFile);
+	Core::TextRange      line;
+
+	TEST_FALSE(reader.seekLine(index, count));
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+	Core::deleteFile(testFile, true);
+}
+TEST_SET_END
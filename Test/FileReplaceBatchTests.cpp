@@ -0,0 +1,189 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   FileReplaceBatchTests.cpp
+//! \brief  The unit tests for the FileReplaceBatch class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/FileReplaceBatch.hpp>
+#include <Core/DirectoryIterator.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include <Core/DirectoryWalker.hpp>
+#include "FileTest.hpp"
+
+static size_t countFiles(const tstring& folder)
+{
+	Core::DirectoryIterator it(folder);
+	Core::DirectoryEntry    entry;
+	size_t                  count = 0;
+
+	while (it.next(entry))
+		++count;
+
+	return count;
+}
+
+static void add(Core::FileReplaceBatch& batch, const tstring& filename, const std::string& contents)
+{
+	batch.add(filename, contents.data(), contents.size());
+}
+
+class RecordingHandler : public Core::FileReplaceBatch::Handler
+{
+public:
+	virtual void fileReplaced(const tstring& path)
+	{
+		m_paths.push_back(path);
+	}
+
+	std::vector<tstring>	m_paths;
+};
+
+TEST_SET(FileReplaceBatch)
+{
+	const tstring folder = Core::combinePaths(Core::getTempFolder(), TXT("core_replace_test"));
+	const tstring existingFile = Core::combinePaths(folder, TXT("existing.txt"));
+	const tstring newFile = Core::combinePaths(folder, TXT("new.txt"));
+
+	Core::createFolder(folder);
+
+TEST_CASE("adding a file to a missing folder throws an exception")
+{
+	Core::FileReplaceBatch batch(TXT(".\\invalid_local_folder_name"));
+
+	TEST_THROWS(add(batch, TXT("file.txt"), "contents"));
+	TEST_TRUE(batch.pendingCount() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("the files are only replaced when the batch is committed")
+{
+	createFile(existingFile, "old");
+
+	{
+		Core::FileReplaceBatch batch(folder);
+
+		TEST_TRUE(batch.folder() == folder);
+
+		add(batch, TXT("existing.txt"), "replaced");
+		add(batch, TXT("new.txt"), "created");
+
+		TEST_TRUE(batch.pendingCount() == 2);
+		TEST_TRUE(readFile(existingFile) == "old");
+		TEST_FALSE(Core::pathExists(newFile));
+
+		batch.commit();
+
+		TEST_TRUE(batch.pendingCount() == 0);
+	}
+
+	TEST_TRUE(readFile(existingFile) == "replaced");
+	TEST_TRUE(readFile(newFile) == "created");
+	TEST_TRUE(countFiles(folder) == 2);
+
+	Core::deleteFile(newFile, true);
+}
+TEST_CASE_END
+
+TEST_CASE("the last contents added for a file are the ones written")
+{
+	createFile(existingFile, "old");
+
+	Core::FileReplaceBatch batch(folder);
+
+	add(batch, TXT("existing.txt"), "first");
+	add(batch, TXT("existing.txt"), "second");
+	batch.commit();
+
+	TEST_TRUE(readFile(existingFile) == "second");
+	TEST_TRUE(countFiles(folder) == 1);
+}
+TEST_CASE_END
+
+TEST_CASE("discarding the batch leaves the files unchanged")
+{
+	createFile(existingFile, "old");
+
+	{
+		Core::FileReplaceBatch batch(folder);
+
+		add(batch, TXT("existing.txt"), "discarded");
+		batch.discard();
+
+		TEST_TRUE(batch.pendingCount() == 0);
+
+		add(batch, TXT("new.txt"), "never committed");
+	}
+
+	TEST_TRUE(readFile(existingFile) == "old");
+	TEST_FALSE(Core::pathExists(newFile));
+	TEST_TRUE(countFiles(folder) == 1);
+}
+TEST_CASE_END
+
+TEST_CASE("the handler is told about each file once the batch is committed")
+{
+	RecordingHandler       handler;
+	Core::FileReplaceBatch batch(folder, &handler);
+
+	add(batch, TXT("existing.txt"), "1");
+	add(batch, TXT("new.txt"), "2");
+
+	TEST_TRUE(handler.m_paths.empty());
+
+	batch.commit();
+
+	TEST_TRUE(handler.m_paths.size() == 2);
+	TEST_TRUE(handler.m_paths[0] == existingFile);
+	TEST_TRUE(handler.m_paths[1] == newFile);
+
+	Core::deleteFile(newFile, true);
+}
+TEST_CASE_END
+
+TEST_CASE("committing an empty batch does nothing")
+{
+	RecordingHandler       handler;
+	Core::FileReplaceBatch batch(folder, &handler);
+
+	batch.commit();
+
+	TEST_TRUE(handler.m_paths.empty());
+}
+TEST_CASE_END
+
+TEST_CASE("replacing a single file swaps its contents")
+{
+	const std::string created = "created";
+	const std::string replaced = "replaced";
+
+	Core::replaceFile(newFile, created.data(), created.size());
+
+	TEST_TRUE(readFile(newFile) == created);
+
+	Core::replaceFile(newFile, replaced.data(), replaced.size());
+
+	TEST_TRUE(readFile(newFile) == replaced);
+
+	Core::deleteFile(newFile, true);
+}
+TEST_CASE_END
+
+TEST_CASE("replacing a file without a folder uses the current folder")
+{
+	const tstring localFile = TXT("core_replace_local_file.txt");
+	const std::string contents = "contents";
+
+	Core::replaceFile(localFile, contents.data(), contents.size());
+
+	TEST_TRUE(readFile(localFile) == contents);
+
+	Core::deleteFile(localFile, true);
+}
+TEST_CASE_END
+
+	Core::deleteFolderTree(folder, true);
+}
+TEST_SET_END
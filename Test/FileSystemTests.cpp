@@ -8,6 +8,12 @@
 #include <Core/FileSystem.hpp>
 #include <Core/AnsiWide.hpp>
 #include <Core/tfstream.hpp>
+#include <Core/StringUtils.hpp>
+#include <Core/DirectoryWalker.hpp>
+#include <Core/FileSystemException.hpp>
+#include "FileTest.hpp"
+#include <windows.h>
+#include <sddl.h>
 
 static void createEmptyFile(const tstring& path)
 {
@@ -16,6 +22,65 @@ static void createEmptyFile(const tstring& path)
 	testFile.close();
 }
 
+static void denyFolderListing(const tstring& path, bool deny)
+{
+	const tchar*         sddl = deny ? TXT("D:(D;;0x1;;;WD)(A;;FA;;;WD)") : TXT("D:(A;;FA;;;WD)");
+	PSECURITY_DESCRIPTOR descriptor = nullptr;
+
+	::ConvertStringSecurityDescriptorToSecurityDescriptor(sddl, SDDL_REVISION_1, &descriptor, nullptr);
+	::SetFileSecurity(path.c_str(), DACL_SECURITY_INFORMATION, descriptor);
+	::LocalFree(descriptor);
+}
+
+static void setLastWriteTime(const tstring& path, const FILETIME& time)
+{
+	HANDLE file = ::CreateFile(path.c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	ASSERT(file != INVALID_HANDLE_VALUE);
+
+	::SetFileTime(file, nullptr, nullptr, &time);
+	::CloseHandle(file);
+}
+
+static bool hasLastWriteTime(const tstring& path, const FILETIME& time)
+{
+	HANDLE   file = ::CreateFile(path.c_str(), FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	FILETIME written = { 0, 0 };
+
+	ASSERT(file != INVALID_HANDLE_VALUE);
+
+	::GetFileTime(file, nullptr, nullptr, &written);
+	::CloseHandle(file);
+
+	return (written.dwLowDateTime == time.dwLowDateTime) && (written.dwHighDateTime == time.dwHighDateTime);
+}
+
+class TestCopyProgress : public Core::CopyProgress
+{
+public:
+	TestCopyProgress(bool cancel)
+		: m_cancel(cancel)
+		, m_calls(0)
+		, m_copied(0)
+		, m_total(0)
+	{
+	}
+
+	virtual bool progress(ulonglong copied, ulonglong total)
+	{
+		++m_calls;
+		m_copied = copied;
+		m_total = total;
+
+		return !m_cancel;
+	}
+
+	bool		m_cancel;
+	size_t		m_calls;
+	ulonglong	m_copied;
+	ulonglong	m_total;
+};
+
 TEST_SET(FileSystem)
 {
 
@@ -147,5 +212,233 @@ TEST_CASE("deleting a folder doesn't throw when an error occurs and errors shoul
 }
 TEST_CASE_END
 
+TEST_CASE("a folder tree can be deleted along with its contents")
+{
+	const tstring tempFolder = Core::getTempFolder();
+	const tstring testFolder = Core::combinePaths(tempFolder, TXT("FileSystemTest"));
+	const tstring subFolder = Core::combinePaths(testFolder, TXT("sub"));
+
+	for (size_t threads = 1; threads != 4; ++threads)
+	{
+		ASSERT(!Core::pathExists(testFolder));
+
+		Core::createFolder(testFolder);
+		Core::createFolder(subFolder);
+		Core::createFolder(Core::combinePaths(subFolder, TXT("empty")));
+		Core::createFolder(Core::combinePaths(subFolder, TXT("deeper")));
+
+		for (size_t i = 0; i != 10; ++i)
+		{
+			createEmptyFile(Core::combinePaths(testFolder, Core::fmt(TXT("file%u.txt"), static_cast<uint>(i))));
+			createEmptyFile(Core::combinePaths(subFolder, Core::fmt(TXT("file%u.txt"), static_cast<uint>(i))));
+		}
+
+		createEmptyFile(Core::combinePaths(subFolder, TXT("deeper\\file.txt")));
+
+		Core::deleteFolderTree(testFolder, false, threads);
+
+		TEST_FALSE(Core::pathExists(testFolder));
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("deleting a folder tree deletes read-only files")
+{
+	const tstring tempFolder = Core::getTempFolder();
+	const tstring testFolder = Core::combinePaths(tempFolder, TXT("FileSystemTest"));
+	const tstring testFile = Core::combinePaths(testFolder, TXT("readonly.txt"));
+
+	ASSERT(!Core::pathExists(testFolder));
+
+	Core::createFolder(testFolder);
+	createEmptyFile(testFile);
+	::SetFileAttributes(testFile.c_str(), FILE_ATTRIBUTE_READONLY);
+
+	Core::deleteFolderTree(testFolder);
+
+	TEST_FALSE(Core::pathExists(testFolder));
+}
+TEST_CASE_END
+
+TEST_CASE("deleting a folder tree throws when an error occurs")
+{
+	const tstring invalidFolder = TXT(".\\invalid_local_folder_name");
+
+	TEST_THROWS(Core::deleteFolderTree(invalidFolder));
+
+	try
+	{
+		Core::deleteFolderTree(invalidFolder);
+
+		TEST_FAILED("deleteFolderTree did not throw");
+	}
+	catch (const Core::FileSystemException& exception)
+	{
+		TEST_TRUE(tstrstr(exception.twhat(), TXT("invalid_local_folder_name")) != nullptr);
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("deleting a folder tree doesn't throw when an error occurs and errors should be ignored")
+{
+	const tstring invalidFolder = TXT(".\\invalid_local_folder_name");
+
+	Core::deleteFolderTree(invalidFolder, true);
+
+	TEST_PASSED("no exception thrown");
+}
+TEST_CASE_END
+
+TEST_CASE("deleting a folder tree skips an unreadable folder when errors should be ignored")
+{
+	const tstring tempFolder = Core::getTempFolder();
+	const tstring testFolder = Core::combinePaths(tempFolder, TXT("FileSystemTest"));
+	const tstring lockedFolder = Core::combinePaths(testFolder, TXT("locked"));
+
+	ASSERT(!Core::pathExists(testFolder));
+
+	Core::createFolder(testFolder);
+	Core::createFolder(lockedFolder);
+	createEmptyFile(Core::combinePaths(lockedFolder, TXT("file.txt")));
+
+	for (size_t i = 0; i != 5; ++i)
+	{
+		const tstring sibling = Core::combinePaths(testFolder, Core::fmt(TXT("sibling%u"), static_cast<uint>(i)));
+
+		Core::createFolder(sibling);
+		Core::createFolder(Core::combinePaths(sibling, TXT("deeper")));
+		createEmptyFile(Core::combinePaths(sibling, TXT("deeper\\file.txt")));
+	}
+
+	denyFolderListing(lockedFolder, true);
+
+	Core::deleteFolderTree(testFolder, true, 1);
+
+	denyFolderListing(lockedFolder, false);
+
+	bool siblingsDeleted = true;
+
+	for (size_t i = 0; i != 5; ++i)
+	{
+		if (Core::pathExists(Core::combinePaths(testFolder, Core::fmt(TXT("sibling%u"), static_cast<uint>(i)))))
+			siblingsDeleted = false;
+	}
+
+	TEST_TRUE(siblingsDeleted);
+	TEST_TRUE(Core::pathExists(Core::combinePaths(lockedFolder, TXT("file.txt"))));
+
+	Core::deleteFolderTree(testFolder);
+
+	TEST_FALSE(Core::pathExists(testFolder));
+}
+TEST_CASE_END
+
+TEST_CASE("copying a file creates an identical file")
+{
+	const tstring tempFolder = Core::getTempFolder();
+	const tstring sourceFile = Core::combinePaths(tempFolder, TXT("core_copy_source.txt"));
+	const tstring targetFile = Core::combinePaths(tempFolder, TXT("core_copy_target.txt"));
+
+	createFile(sourceFile, "contents");
+	Core::deleteFile(targetFile, true);
+
+	TEST_TRUE(Core::copyFile(sourceFile, targetFile));
+	TEST_TRUE(readFile(targetFile) == "contents");
+	TEST_TRUE(readFile(sourceFile) == "contents");
+
+	Core::deleteFile(sourceFile, true);
+	Core::deleteFile(targetFile, true);
+}
+TEST_CASE_END
+
+TEST_CASE("copying a file only replaces an existing file when requested")
+{
+	const tstring tempFolder = Core::getTempFolder();
+	const tstring sourceFile = Core::combinePaths(tempFolder, TXT("core_copy_source.txt"));
+	const tstring targetFile = Core::combinePaths(tempFolder, TXT("core_copy_target.txt"));
+
+	// 2001-01-01 00:00:00 UTC.
+	const FILETIME lastWritten = { 0xC89DC000, 0x01C07385 };
+
+	createFile(sourceFile, "new");
+	createFile(targetFile, "old");
+	setLastWriteTime(sourceFile, lastWritten);
+
+	TEST_THROWS(Core::copyFile(sourceFile, targetFile));
+	TEST_TRUE(readFile(targetFile) == "old");
+
+	TEST_TRUE(Core::copyFile(sourceFile, targetFile, Core::OVERWRITE_EXISTING | Core::PRESERVE_TIMESTAMPS));
+	TEST_TRUE(readFile(targetFile) == "new");
+	TEST_TRUE(hasLastWriteTime(targetFile, lastWritten));
+
+	Core::deleteFile(sourceFile, true);
+	Core::deleteFile(targetFile, true);
+}
+TEST_CASE_END
+
+TEST_CASE("copying a file reports its progress and can be cancelled")
+{
+	const tstring tempFolder = Core::getTempFolder();
+	const tstring sourceFile = Core::combinePaths(tempFolder, TXT("core_copy_source.txt"));
+	const tstring targetFile = Core::combinePaths(tempFolder, TXT("core_copy_target.txt"));
+
+	createFile(sourceFile, std::string(256 * 1024, 'x'));
+	Core::deleteFile(targetFile, true);
+
+	TestCopyProgress progress(false);
+
+	TEST_TRUE(Core::copyFile(sourceFile, targetFile, Core::COPY_DEFAULT, &progress));
+	TEST_TRUE(progress.m_calls != 0);
+	TEST_TRUE((progress.m_copied == progress.m_total) && (progress.m_total == 256 * 1024));
+
+	Core::deleteFile(targetFile, true);
+
+	TestCopyProgress cancel(true);
+
+	TEST_FALSE(Core::copyFile(sourceFile, targetFile, Core::COPY_DEFAULT, &cancel));
+	TEST_FALSE(Core::pathExists(targetFile));
+
+	Core::deleteFile(sourceFile, true);
+}
+TEST_CASE_END
+
+TEST_CASE("copying a missing file throws an exception")
+{
+	const tstring invalidFile = TXT(".\\invalid_local_file_name.txt");
+	const tstring targetFile = Core::combinePaths(Core::getTempFolder(), TXT("core_copy_target.txt"));
+
+	TEST_THROWS(Core::copyFile(invalidFile, targetFile));
+}
+TEST_CASE_END
+
+TEST_CASE("moving a file renames it")
+{
+	const tstring tempFolder = Core::getTempFolder();
+	const tstring sourceFile = Core::combinePaths(tempFolder, TXT("core_move_source.txt"));
+	const tstring targetFile = Core::combinePaths(tempFolder, TXT("core_move_target.txt"));
+
+	// 2001-01-01 00:00:00 UTC.
+	const FILETIME lastWritten = { 0xC89DC000, 0x01C07385 };
+
+	createFile(sourceFile, "contents");
+	setLastWriteTime(sourceFile, lastWritten);
+	Core::deleteFile(targetFile, true);
+
+	TEST_TRUE(Core::moveFile(sourceFile, targetFile, Core::PRESERVE_TIMESTAMPS));
+	TEST_FALSE(Core::pathExists(sourceFile));
+	TEST_TRUE(readFile(targetFile) == "contents");
+	TEST_TRUE(hasLastWriteTime(targetFile, lastWritten));
+
+	createFile(sourceFile, "replacement");
+
+	TEST_THROWS(Core::moveFile(sourceFile, targetFile));
+	TEST_TRUE(Core::moveFile(sourceFile, targetFile, Core::OVERWRITE_EXISTING));
+	TEST_TRUE(readFile(targetFile) == "replacement");
+
+	Core::deleteFile(sourceFile, true);
+	Core::deleteFile(targetFile, true);
+}
+TEST_CASE_END
+
 }
 TEST_SET_END
@@ -0,0 +1,228 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   FileSystemWatcherTests.cpp
+//! \brief  The unit tests for the FileSystemWatcher class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/FileSystemWatcher.hpp>
+#include <Core/CriticalSection.hpp>
+#include <Core/Event.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include <Core/DirectoryWalker.hpp>
+#include <Core/InvalidArgException.hpp>
+#include "FileTest.hpp"
+
+typedef Core::FileSystemWatcher::Changes Changes;
+
+static const uint TIMEOUT = 5000;
+
+static size_t countChanges(const Changes& changes, const tstring& path)
+{
+	size_t count = 0;
+
+	for (Changes::const_iterator it = changes.begin(); it != changes.end(); ++it)
+	{
+		if (it->m_path == path)
+			++count;
+	}
+
+	return count;
+}
+
+class ChangeRecorder : public Core::FileSystemWatcher::Handler
+{
+public:
+	virtual void changesDetected(const Changes& changes)
+	{
+		Core::AutoLock lock(m_lock);
+
+		m_changes.insert(m_changes.end(), changes.begin(), changes.end());
+
+		m_detected.signal();
+	}
+
+	Core::CriticalSection	m_lock;
+	Changes					m_changes;
+	Core::Event				m_detected;
+};
+
+class FailingChangeHandler : public Core::FileSystemWatcher::Handler
+{
+public:
+	virtual void changesDetected(const Changes& /*changes*/)
+	{
+		throw Core::InvalidArgException(TXT("Test Exception"));
+	}
+};
+
+TEST_SET(FileSystemWatcher)
+{
+	const tstring folder = Core::combinePaths(Core::getTempFolder(), TXT("core_watcher_test"));
+	const tstring subFolder = Core::combinePaths(folder, TXT("sub"));
+	const tstring file = Core::combinePaths(folder, TXT("file.txt"));
+	const tstring otherFile = Core::combinePaths(folder, TXT("other.txt"));
+	const tstring subFile = Core::combinePaths(subFolder, TXT("file.txt"));
+
+	Core::deleteFolderTree(folder, true);
+	Core::createFolder(folder);
+	Core::createFolder(subFolder);
+
+TEST_CASE("watching a missing folder throws an exception")
+{
+	TEST_THROWS(Core::FileSystemWatcher(TXT(".\\invalid_local_folder_name")));
+}
+TEST_CASE_END
+
+TEST_CASE("reading changes returns false when none have been queued")
+{
+	Core::FileSystemWatcher watcher(folder);
+	Changes                 changes;
+
+	TEST_TRUE(watcher.folder() == folder);
+	TEST_FALSE(watcher.readChanges(changes));
+	TEST_FALSE(watcher.waitForChanges(changes, 10));
+	TEST_TRUE(changes.empty());
+}
+TEST_CASE_END
+
+TEST_CASE("creating a file is reported as a single addition")
+{
+	Core::deleteFile(file, true);
+
+	Core::FileSystemWatcher watcher(folder);
+	Changes                 changes;
+
+	createFile(file, "contents");
+
+	TEST_TRUE(watcher.waitForChanges(changes, TIMEOUT));
+	TEST_TRUE(changes.size() == 1);
+	TEST_TRUE(changes[0].m_path == file);
+	TEST_TRUE(changes[0].m_action == Core::FileSystemWatcher::ADDED);
+}
+TEST_CASE_END
+
+TEST_CASE("a burst of writes to the same file is reported as a single change")
+{
+	createFile(file, "old");
+
+	Core::FileSystemWatcher watcher(folder, false, nullptr, 500);
+	Changes                 changes;
+
+	for (int i = 0; i != 10; ++i)
+		createFile(file, "new");
+
+	TEST_TRUE(watcher.waitForChanges(changes, TIMEOUT));
+	TEST_TRUE(changes.size() == 1);
+	TEST_TRUE(changes[0].m_path == file);
+	TEST_TRUE(changes[0].m_action == Core::FileSystemWatcher::MODIFIED);
+}
+TEST_CASE_END
+
+TEST_CASE("a file created and deleted within the window is not reported")
+{
+	Core::deleteFile(file, true);
+	Core::deleteFile(otherFile, true);
+
+	Core::FileSystemWatcher watcher(folder, false, nullptr, 500);
+	Changes                 changes;
+
+	createFile(file, "contents");
+	Core::deleteFile(file);
+	createFile(otherFile, "contents");
+
+	TEST_TRUE(watcher.waitForChanges(changes, TIMEOUT));
+	TEST_TRUE(countChanges(changes, file) == 0);
+	TEST_TRUE(countChanges(changes, otherFile) == 1);
+
+	Core::deleteFile(otherFile, true);
+}
+TEST_CASE_END
+
+TEST_CASE("changes in a subfolder are only reported when watching recursively")
+{
+	Core::deleteFile(subFile, true);
+
+	Changes changes;
+
+	{
+		Core::FileSystemWatcher watcher(folder);
+
+		createFile(subFile, "contents");
+
+		watcher.waitForChanges(changes, 500);
+
+		TEST_TRUE(countChanges(changes, subFile) == 0);
+	}
+
+	Core::deleteFile(subFile);
+
+	Core::FileSystemWatcher watcher(folder, true);
+
+	createFile(subFile, "contents");
+
+	TEST_TRUE(watcher.waitForChanges(changes, TIMEOUT));
+	TEST_TRUE(countChanges(changes, subFile) == 1);
+}
+TEST_CASE_END
+
+TEST_CASE("the changes are passed to the handler when one is provided")
+{
+	Core::deleteFile(file, true);
+
+	ChangeRecorder        handler;
+	Core::FileSystemWatcher watcher(folder, false, &handler);
+	Changes                 changes;
+
+	createFile(file, "contents");
+
+	TEST_TRUE(handler.m_detected.wait(TIMEOUT));
+
+	watcher.stop();
+
+	TEST_TRUE(countChanges(handler.m_changes, file) == 1);
+	TEST_FALSE(watcher.readChanges(changes));
+}
+TEST_CASE_END
+
+TEST_CASE("a handler failure ends the watch and is rethrown with its original type")
+{
+	Core::deleteFile(file, true);
+
+	FailingChangeHandler    handler;
+	Core::FileSystemWatcher watcher(folder, false, &handler);
+	Changes                 changes;
+
+	createFile(file, "contents");
+
+	try
+	{
+		watcher.waitForChanges(changes, TIMEOUT);
+
+		TEST_FAILED("waitForChanges did not throw");
+	}
+	catch (const Core::InvalidArgException& exception)
+	{
+		TEST_TRUE(tstrstr(exception.twhat(), TXT("Test Exception")) != nullptr);
+	}
+
+	TEST_TRUE(watcher.hasEnded());
+
+	try
+	{
+		watcher.stop();
+
+		TEST_FAILED("stop did not throw");
+	}
+	catch (const Core::InvalidArgException& exception)
+	{
+		TEST_TRUE(tstrstr(exception.twhat(), TXT("Test Exception")) != nullptr);
+	}
+}
+TEST_CASE_END
+
+	Core::deleteFolderTree(folder, true);
+}
+TEST_SET_END
@@ -0,0 +1,30 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   FileTest.hpp
+//! \brief  The functions used in unit testing of the file based classes.
+//! \author Chris Oldwood
+
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <iterator>
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a file with the given contents, replacing any existing file.
+
+inline void createFile(const tstring& path, const std::string& contents)
+{
+	std::ofstream file(T2A(path), std::ios::binary);
+
+	file << contents;
+
+	file.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the entire contents of a file.
+
+inline std::string readFile(const tstring& path)
+{
+	std::ifstream file(T2A(path), std::ios::binary);
+
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
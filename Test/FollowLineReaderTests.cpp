@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   FollowLineReaderTests.cpp
+//! \brief  The unit tests for the FollowLineReader class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/FollowLineReader.hpp>
+#include <Core/Thread.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include "FileTest.hpp"
+#include <cstdio>
+
+static void appendToFile(const tstring& path, const std::string& contents)
+{
+	std::ofstream file(T2A(path), std::ios::binary | std::ios::app);
+
+	file << contents;
+
+	file.close();
+}
+
+static void stopReader(void* param)
+{
+	static_cast<Core::FollowLineReader*>(param)->stop();
+}
+
+TEST_SET(FollowLineReader)
+{
+	const tstring folder = Core::getTempFolder();
+	const tstring testFile = Core::combinePaths(folder, TXT("core_follow_test_file.log"));
+	const tstring rotatedFile = Core::combinePaths(folder, TXT("core_follow_test_file.log.1"));
+	const uint    pollInterval = 10;
+
+TEST_CASE("construction with a zero block size throws an exception")
+{
+	createFile(testFile, "");
+
+	TEST_THROWS(Core::FollowLineReader(testFile, Core::FollowLineReader::FROM_START, pollInterval, 0));
+}
+TEST_CASE_END
+
+TEST_CASE("construction from an invalid filename throws an exception")
+{
+	tstring invalidFile = TXT(".\\invalid_local_file_name.txt");
+
+	TEST_THROWS(Core::FollowLineReader(invalidFile));
+}
+TEST_CASE_END
+
+TEST_CASE("an incomplete line is only returned once it has been completed")
+{
+	createFile(testFile, "first\r\nsec");
+
+	Core::FollowLineReader reader(testFile, Core::FollowLineReader::FROM_START, pollInterval, 4);
+	Core::TextRange        line;
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("first")));
+
+	appendToFile(testFile, "ond\r\n");
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("second")));
+}
+TEST_CASE_END
+
+TEST_CASE("reading from the end only returns lines written after opening")
+{
+	createFile(testFile, "old line\nnew ");
+
+	Core::FollowLineReader reader(testFile, Core::FollowLineReader::FROM_END, pollInterval, 4);
+	Core::TextRange        line;
+
+	appendToFile(testFile, "line\n");
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("new line")));
+}
+TEST_CASE_END
+
+TEST_CASE("stopping the reader ends reading without returning an incomplete line")
+{
+	createFile(testFile, "line\nincomplete");
+
+	Core::FollowLineReader reader(testFile, Core::FollowLineReader::FROM_START, pollInterval);
+	Core::TextRange        line;
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("line")));
+
+	reader.stop();
+
+	TEST_TRUE(reader.isStopped());
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("a reader waiting for more data can be stopped from another thread")
+{
+	createFile(testFile, "");
+
+	Core::FollowLineReader reader(testFile, Core::FollowLineReader::FROM_START, Core::FollowLineReader::DEFAULT_POLL_INTERVAL);
+	Core::Thread           thread(stopReader, &reader);
+	Core::TextRange        line;
+
+	TEST_FALSE(reader.readLine(line));
+
+	thread.join();
+}
+TEST_CASE_END
+
+TEST_CASE("a truncated file is read again from the start")
+{
+	createFile(testFile, "first line\nsecond line\n");
+
+	Core::FollowLineReader reader(testFile, Core::FollowLineReader::FROM_START, pollInterval);
+	Core::TextRange        line;
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("first line")));
+	TEST_TRUE(reader.readLine(line) && (line == TXT("second line")));
+
+	createFile(testFile, "third\n");
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("third")));
+}
+TEST_CASE_END
+
+TEST_CASE("a rotated file is followed by reading the new file")
+{
+	Core::deleteFile(rotatedFile, true);
+	createFile(testFile, "before rotation\n");
+
+	Core::FollowLineReader reader(testFile, Core::FollowLineReader::FROM_START, pollInterval);
+	Core::TextRange        line;
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("before rotation")));
+
+	TEST_TRUE(std::rename(T2A(testFile), T2A(rotatedFile)) == 0);
+	createFile(testFile, "after rotation, which is longer\n");
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("after rotation, which is longer")));
+}
+TEST_CASE_END
+
+	Core::deleteFile(testFile, true);
+	Core::deleteFile(rotatedFile, true);
+}
+TEST_SET_END
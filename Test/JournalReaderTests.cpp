@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   JournalReaderTests.cpp
+//! \brief  The unit tests for the JournalReader class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/JournalReader.hpp>
+#include <Core/Checksum.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include "FileTest.hpp"
+
+static std::string encodeUint32(uint value)
+{
+	std::string bytes(4, '\0');
+
+	for (size_t i = 0; i != 4; ++i)
+		bytes[i] = static_cast<char>((value >> (i * 8)) & 0xFF);
+
+	return bytes;
+}
+
+static std::string encodeRecord(const std::string& contents)
+{
+	const std::string length = encodeUint32(static_cast<uint>(contents.size()));
+	const uint        checksum = Core::crc32(contents.data(), contents.size(), Core::crc32(length.data(), length.size()));
+
+	return length + encodeUint32(checksum) + contents;
+}
+
+static std::string toString(const Core::ByteRange& record)
+{
+	return std::string(record.begin(), record.end());
+}
+
+TEST_SET(JournalReader)
+{
+	const tstring filename = Core::combinePaths(Core::getTempFolder(), TXT("core_journal_test.log"));
+
+TEST_CASE("opening a missing file throws an exception")
+{
+	TEST_THROWS(Core::JournalReader(TXT(".\\invalid_local_file_name.log")));
+}
+TEST_CASE_END
+
+TEST_CASE("a zero block size throws an exception")
+{
+	createFile(filename, "");
+
+	TEST_THROWS(Core::JournalReader(filename, 0));
+}
+TEST_CASE_END
+
+TEST_CASE("an empty journal has no records and is not torn")
+{
+	createFile(filename, "");
+
+	Core::JournalReader reader(filename);
+	Core::ByteRange     record;
+
+	TEST_FALSE(reader.readRecord(record));
+	TEST_FALSE(reader.isTorn());
+	TEST_TRUE(reader.validSize() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("all the records are read in order")
+{
+	const std::string journal = encodeRecord("first") + encodeRecord("") + encodeRecord("third");
+
+	createFile(filename, journal);
+
+	// A tiny block size forces records to straddle blocks.
+	Core::JournalReader reader(filename, 3);
+	Core::ByteRange     record;
+
+	TEST_TRUE(reader.readRecord(record) && (toString(record) == "first"));
+	TEST_TRUE(reader.readRecord(record) && (toString(record) == ""));
+	TEST_TRUE(reader.readRecord(record) && (toString(record) == "third"));
+	TEST_FALSE(reader.readRecord(record));
+	TEST_FALSE(reader.isTorn());
+	TEST_TRUE(reader.validSize() == journal.size());
+}
+TEST_CASE_END
+
+TEST_CASE("reading stops at an incomplete record")
+{
+	const std::string valid = encodeRecord("first");
+	const std::string partial = encodeRecord("second");
+
+	createFile(filename, valid + partial.substr(0, partial.size()-1));
+
+	Core::JournalReader reader(filename);
+	Core::ByteRange     record;
+
+	TEST_TRUE(reader.readRecord(record));
+	TEST_FALSE(reader.readRecord(record));
+	TEST_TRUE(reader.isTorn());
+	TEST_TRUE(reader.validSize() == valid.size());
+}
+TEST_CASE_END
+
+TEST_CASE("reading stops at an incomplete header")
+{
+	const std::string valid = encodeRecord("first");
+
+	createFile(filename, valid + "\x01\x02");
+
+	Core::JournalReader reader(filename);
+	Core::ByteRange     record;
+
+	TEST_TRUE(reader.readRecord(record));
+	TEST_FALSE(reader.readRecord(record));
+	TEST_TRUE(reader.isTorn());
+	TEST_TRUE(reader.validSize() == valid.size());
+}
+TEST_CASE_END
+
+TEST_CASE("reading stops at a record that fails its checksum")
+{
+	const std::string valid = encodeRecord("first");
+	std::string       corrupt = encodeRecord("second");
+
+	corrupt[corrupt.size()-1] ^= 0x01;
+
+	createFile(filename, valid + corrupt + encodeRecord("third"));
+
+	Core::JournalReader reader(filename);
+	Core::ByteRange     record;
+
+	TEST_TRUE(reader.readRecord(record));
+	TEST_FALSE(reader.readRecord(record));
+	TEST_FALSE(reader.readRecord(record));
+	TEST_TRUE(reader.isTorn());
+	TEST_TRUE(reader.validSize() == valid.size());
+}
+TEST_CASE_END
+
+	Core::deleteFile(filename, true);
+}
+TEST_SET_END
@@ -0,0 +1,191 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   JournalWriterTests.cpp
+//! \brief  The unit tests for the JournalWriter class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/JournalWriter.hpp>
+#include <Core/JournalReader.hpp>
+#include <Core/Thread.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include <vector>
+#include <algorithm>
+
+static void append(Core::JournalWriter& writer, const std::string& record)
+{
+	writer.append(record.data(), record.size());
+}
+
+static std::vector<std::string> readRecords(const tstring& filename)
+{
+	Core::JournalReader      reader(filename);
+	Core::ByteRange          record;
+	std::vector<std::string> records;
+
+	while (reader.readRecord(record))
+		records.push_back(std::string(record.begin(), record.end()));
+
+	return records;
+}
+
+static void appendToFile(const tstring& path, const std::string& contents)
+{
+	std::ofstream file(T2A(path), std::ios::binary | std::ios::app);
+
+	file << contents;
+
+	file.close();
+}
+
+static const size_t RECORDS_PER_THREAD = 50;
+
+static void appendRecords(void* param)
+{
+	Core::JournalWriter& writer = *static_cast<Core::JournalWriter*>(param);
+
+	for (size_t i = 0; i != RECORDS_PER_THREAD; ++i)
+		append(writer, "record");
+}
+
+TEST_SET(JournalWriter)
+{
+	const tstring filename = Core::combinePaths(Core::getTempFolder(), TXT("core_journal_test.log"));
+
+	Core::deleteFile(filename, true);
+
+TEST_CASE("a zero batch size throws an exception")
+{
+	TEST_THROWS(Core::JournalWriter(filename, 0, 0));
+}
+TEST_CASE_END
+
+TEST_CASE("appended records can be read back in order")
+{
+	Core::deleteFile(filename, true);
+
+	{
+		Core::JournalWriter writer(filename);
+
+		append(writer, "first");
+		append(writer, "");
+		append(writer, "third");
+	}
+
+	std::vector<std::string> records = readRecords(filename);
+
+	TEST_TRUE(records.size() == 3);
+	TEST_TRUE(records[0] == "first");
+	TEST_TRUE(records[1] == "");
+	TEST_TRUE(records[2] == "third");
+}
+TEST_CASE_END
+
+TEST_CASE("an appended record is durable before append returns")
+{
+	Core::deleteFile(filename, true);
+
+	Core::JournalWriter writer(filename);
+
+	append(writer, "record");
+
+	std::vector<std::string> records = readRecords(filename);
+
+	TEST_TRUE(records.size() == 1);
+	TEST_TRUE(records[0] == "record");
+}
+TEST_CASE_END
+
+TEST_CASE("records appended concurrently are all written")
+{
+	typedef Core::SharedPtr<Core::Thread> ThreadPtr;
+
+	const size_t threads = 4;
+
+	Core::deleteFile(filename, true);
+
+	{
+		Core::JournalWriter    writer(filename, 5, 64);
+		std::vector<ThreadPtr> workers;
+
+		for (size_t i = 0; i != threads; ++i)
+			workers.push_back(ThreadPtr(new Core::Thread(appendRecords, &writer)));
+
+		for (size_t i = 0; i != threads; ++i)
+			workers[i]->join();
+	}
+
+	std::vector<std::string> records = readRecords(filename);
+
+	TEST_TRUE(records.size() == (threads * RECORDS_PER_THREAD));
+	TEST_TRUE(std::count(records.begin(), records.end(), std::string("record")) == static_cast<int>(records.size()));
+}
+TEST_CASE_END
+
+TEST_CASE("reopening a journal appends after the existing records")
+{
+	Core::deleteFile(filename, true);
+
+	{
+		Core::JournalWriter writer(filename);
+
+		append(writer, "first");
+	}
+
+	{
+		Core::JournalWriter writer(filename);
+
+		append(writer, "second");
+	}
+
+	std::vector<std::string> records = readRecords(filename);
+
+	TEST_TRUE(records.size() == 2);
+	TEST_TRUE(records[0] == "first");
+	TEST_TRUE(records[1] == "second");
+}
+TEST_CASE_END
+
+TEST_CASE("reopening a journal truncates a torn record")
+{
+	Core::deleteFile(filename, true);
+
+	{
+		Core::JournalWriter writer(filename);
+
+		append(writer, "first");
+	}
+
+	appendToFile(filename, std::string("\x10\x00\x00\x00garbage", 11));
+
+	{
+		Core::JournalWriter writer(filename);
+
+		append(writer, "second");
+	}
+
+	std::vector<std::string> records = readRecords(filename);
+
+	TEST_TRUE(records.size() == 2);
+	TEST_TRUE(records[0] == "first");
+	TEST_TRUE(records[1] == "second");
+}
+TEST_CASE_END
+
+TEST_CASE("appending after the journal is closed throws an exception")
+{
+	Core::deleteFile(filename, true);
+
+	Core::JournalWriter writer(filename);
+
+	writer.close();
+
+	TEST_THROWS(append(writer, "record"));
+}
+TEST_CASE_END
+
+	Core::deleteFile(filename, true);
+}
+TEST_SET_END
@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   LineIndexTests.cpp
+//! \brief  The unit tests for the LineIndex class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/LineIndex.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include <Core/StringUtils.hpp>
+#include "FileTest.hpp"
+
+static std::string numberedLines(size_t count)
+{
+	std::string contents;
+
+	for (size_t i = 0; i != count; ++i)
+		contents += T2A(Core::fmt(TXT("line %u\r\n"), static_cast<uint>(i)));
+
+	return contents;
+}
+
+TEST_SET(LineIndex)
+{
+	const tstring folder = Core::getTempFolder();
+	const tstring testFile = Core::combinePaths(folder, TXT("core_line_index_test_file.txt"));
+	const tstring indexFile = Core::LineIndex::sidecarFile(testFile);
+
+TEST_CASE("a default constructed index has no lines")
+{
+	Core::LineIndex index;
+	ulonglong       offset = 1;
+
+	TEST_TRUE(index.lineCount() == 0);
+	TEST_TRUE(index.findLine(10, offset) == 0);
+	TEST_TRUE(offset == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("building an index with a zero interval throws an exception")
+{
+	createFile(testFile, "");
+
+	Core::LineIndex index;
+
+	TEST_THROWS(index.build(testFile, 0));
+}
+TEST_CASE_END
+
+TEST_CASE("building an index for an invalid filename throws an exception")
+{
+	Core::LineIndex index;
+
+	TEST_THROWS(index.build(TXT(".\\invalid_local_file_name.txt")));
+}
+TEST_CASE_END
+
+TEST_CASE("the lines are counted with or without a final terminator")
+{
+	Core::LineIndex index;
+
+	createFile(testFile, "");
+	index.build(testFile);
+	TEST_TRUE(index.lineCount() == 0);
+
+	createFile(testFile, "a\nb\n");
+	index.build(testFile);
+	TEST_TRUE(index.lineCount() == 2);
+
+	createFile(testFile, "a\nb\nc");
+	index.build(testFile);
+	TEST_TRUE(index.lineCount() == 3);
+	TEST_TRUE(index.fileSize() == 5);
+}
+TEST_CASE_END
+
+TEST_CASE("finding a line returns the offset of the nearest sampled line before it")
+{
+	createFile(testFile, "aa\nbb\ncc\ndd\nee\n");
+
+	Core::LineIndex index;
+	ulonglong       offset = 0;
+
+	index.build(testFile, 2);
+
+	TEST_TRUE(index.lineCount() == 5);
+	TEST_TRUE((index.findLine(0, offset) == 0) && (offset == 0));
+	TEST_TRUE((index.findLine(1, offset) == 0) && (offset == 0));
+	TEST_TRUE((index.findLine(2, offset) == 2) && (offset == 6));
+	TEST_TRUE((index.findLine(4, offset) == 4) && (offset == 12));
+	TEST_TRUE((index.findLine(9, offset) == 4) && (offset == 12));
+}
+TEST_CASE_END
+
+TEST_CASE("a saved index can be loaded whilst the file is unchanged")
+{
+	createFile(testFile, numberedLines(1000));
+
+	Core::LineIndex saved;
+
+	saved.build(testFile, 100);
+	saved.save(indexFile);
+
+	Core::LineIndex loaded;
+	ulonglong       savedOffset = 0;
+	ulonglong       loadedOffset = 0;
+
+	TEST_TRUE(loaded.load(indexFile, testFile));
+	TEST_TRUE(loaded.lineCount() == 1000);
+	TEST_TRUE(loaded.interval() == 100);
+	TEST_TRUE(loaded.findLine(567, loadedOffset) == saved.findLine(567, savedOffset));
+	TEST_TRUE(loadedOffset == savedOffset);
+}
+TEST_CASE_END
+
+TEST_CASE("an index is not loaded once the file has changed size")
+{
+	createFile(testFile, numberedLines(10));
+
+	Core::LineIndex index;
+
+	index.build(testFile);
+	index.save(indexFile);
+
+	createFile(testFile, numberedLines(11));
+
+	TEST_FALSE(index.load(indexFile, testFile));
+	TEST_TRUE(index.lineCount() == 10);
+}
+TEST_CASE_END
+
+TEST_CASE("a missing or invalid index file is not loaded")
+{
+	createFile(testFile, numberedLines(10));
+
+	Core::LineIndex index;
+
+	Core::deleteFile(indexFile, true);
+	TEST_FALSE(index.load(indexFile, testFile));
+
+	createFile(indexFile, "not an index file");
+	TEST_FALSE(index.load(indexFile, testFile));
+}
+TEST_CASE_END
+
+TEST_CASE("loading or building an index creates the sidecar file")
+{
+	createFile(testFile, numberedLines(10));
+	Core::deleteFile(indexFile, true);
+
+	Core::LineIndex built;
+
+	built.loadOrBuild(testFile);
+
+	TEST_TRUE(Core::pathExists(indexFile));
+
+	Core::LineIndex loaded;
+
+	TEST_TRUE(loaded.load(indexFile, testFile));
+	TEST_TRUE(loaded.lineCount() == built.lineCount());
+}
+TEST_CASE_END
+
+	Core::deleteFile(testFile, true);
+	Core::deleteFile(indexFile, true);
+}
+TEST_SET_END
@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   LineIteratorTests.cpp
+//! \brief  The unit tests for the LineIterator class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/LineIterator.hpp>
+#include <Core/MappedLineReader.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include "FileTest.hpp"
+
+static Core::LineReaderPtr openMappedFile(const tstring& path)
+{
+	return Core::LineReaderPtr(new Core::MappedLineReader(path));
+}
+
+TEST_SET(LineIterator)
+{
+	tstring testEmptyFile = Core::combinePaths(Core::getTempFolder(), TXT("core_lines_empty_test_file.txt"));
+
+	createFile(testEmptyFile, "");
+
+	tstring testTextFile = Core::combinePaths(Core::getTempFolder(), TXT("core_lines_test_file.txt"));
+
+	createFile(testTextFile, "hello world\r\n\nlast line");
+
+TEST_CASE("end iterator throws when incremented or dereferenced")
+{
+	Core::LineIterator end;
+
+	TEST_THROWS(++end);
+	TEST_THROWS(*end);
+	TEST_THROWS(static_cast<void>(end->empty()));
+}
+TEST_CASE_END
+
+TEST_CASE("end iterator compares equal with itself")
+{
+	Core::LineIterator lhs;
+	Core::LineIterator rhs;
+
+	TEST_TRUE(lhs == rhs);
+}
+TEST_CASE_END
+
+TEST_CASE("iterating a mapped file returns each line as a view")
+{
+	Core::LineIterator end;
+	Core::LineIterator it(openMappedFile(testTextFile));
+
+	TEST_TRUE(it != end);
+	TEST_TRUE(*it == TXT("hello world"));
+	TEST_TRUE((++it)->empty());
+	TEST_TRUE(*++it == TXT("last line"));
+	TEST_TRUE(++it == end);
+}
+TEST_CASE_END
+
+TEST_CASE("opening an empty mapped file should set the iterator to the end")
+{
+	Core::LineIterator end;
+	Core::LineIterator it(openMappedFile(testEmptyFile));
+
+	TEST_TRUE(it == end);
+}
+TEST_CASE_END
+
+TEST_CASE("opening an invalid mapped file throws an exception")
+{
+	tstring invalidFile = TXT(".\\invalid_local_file_name.txt");
+
+	TEST_THROWS(openMappedFile(invalidFile));
+}
+TEST_CASE_END
+
+	Core::deleteFile(testEmptyFile, true);
+	Core::deleteFile(testTextFile, true);
+}
+TEST_SET_END
@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   LineReaderTests.cpp
+//! \brief  The unit tests for the LineReader class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/LineReader.hpp>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+//! A LineReader that returns a string in fixed size blocks. Each block is
+//! copied into the same buffer so that the previous block is overwritten.
+
+class BlockReader : public Core::LineReader
+{
+public:
+	BlockReader(const char* text, size_t blockSize)
+		: m_text(text)
+		, m_blockSize(blockSize)
+		, m_offset(0)
+		, m_block()
+	{
+	}
+
+private:
+	std::string	m_text;
+	size_t		m_blockSize;
+	size_t		m_offset;
+	std::string	m_block;
+
+	virtual bool nextBlock(const char*& begin, const char*& end)
+	{
+		if (m_offset == m_text.size())
+			return false;
+
+		m_block.assign(m_text, m_offset, m_blockSize);
+		m_offset += m_block.size();
+
+		begin = m_block.data();
+		end = begin + m_block.size();
+
+		return true;
+	}
+};
+
+static std::vector<tstring> readLines(Core::LineReader& reader)
+{
+	std::vector<tstring> lines;
+	Core::TextRange      line;
+
+	while (reader.readLine(line))
+		lines.push_back(Core::toString(line));
+
+	return lines;
+}
+
+TEST_SET(LineReader)
+{
+
+TEST_CASE("no lines are read when there are no blocks")
+{
+	BlockReader     reader("", 1);
+	Core::TextRange line;
+
+	TEST_FALSE(reader.readLine(line));
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("lines can be terminated by a LF, CRLF or the end of the text")
+{
+	BlockReader          reader("ab\ncd\r\n\nef", 64);
+	std::vector<tstring> lines = readLines(reader);
+
+	TEST_TRUE(lines.size() == 4);
+	TEST_TRUE(lines[0] == TXT("ab"));
+	TEST_TRUE(lines[1] == TXT("cd"));
+	TEST_TRUE(lines[2] == TXT(""));
+	TEST_TRUE(lines[3] == TXT("ef"));
+}
+TEST_CASE_END
+
+TEST_CASE("a terminator on the final line does not create an extra empty line")
+{
+	BlockReader          reader("ab\r\n", 64);
+	std::vector<tstring> lines = readLines(reader);
+
+	TEST_TRUE(lines.size() == 1);
+	TEST_TRUE(lines[0] == TXT("ab"));
+}
+TEST_CASE_END
+
+TEST_CASE("lines that straddle blocks are returned whole for any block size")
+{
+	const char* text = "abc\r\n\r\nd\nefghij\r\nk";
+	bool        matched = true;
+
+	for (size_t blockSize = 1; blockSize != strlen(text)+1; ++blockSize)
+	{
+		BlockReader          reader(text, blockSize);
+		std::vector<tstring> lines = readLines(reader);
+
+		if ( (lines.size() != 5) || (lines[0] != TXT("abc")) || (lines[1] != TXT(""))
+		  || (lines[2] != TXT("d")) || (lines[3] != TXT("efghij")) || (lines[4] != TXT("k")) )
+			matched = false;
+	}
+
+	TEST_TRUE(matched);
+}
+TEST_CASE_END
+
+TEST_CASE("lines can be read as their ANSI characters")
+{
+	BlockReader reader("ab\xE9\r\ncd", 3);
+	const char* begin = nullptr;
+	const char* end = nullptr;
+
+	TEST_TRUE(reader.readAnsiLine(begin, end) && (std::string(begin, end) == "ab\xE9"));
+	TEST_TRUE(reader.readAnsiLine(begin, end) && (std::string(begin, end) == "cd"));
+	TEST_FALSE(reader.readAnsiLine(begin, end));
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
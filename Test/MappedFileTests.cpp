@@ -0,0 +1,172 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   MappedFileTests.cpp
+//! \brief  The unit tests for the MappedFile class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/MappedFile.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include "FileTest.hpp"
+
+TEST_SET(MappedFile)
+{
+	tstring testEmptyFile = Core::combinePaths(Core::getTempFolder(), TXT("core_mapped_empty_test_file.txt"));
+
+	createFile(testEmptyFile, "");
+
+	tstring testTextFile = Core::combinePaths(Core::getTempFolder(), TXT("core_mapped_test_file.txt"));
+
+	createFile(testTextFile, "hello\r\nworld");
+
+	tstring testWriteFile = Core::combinePaths(Core::getTempFolder(), TXT("core_mapped_write_test_file.txt"));
+
+TEST_CASE("mapping a file provides access to its entire contents")
+{
+	Core::MappedFile file(testTextFile);
+
+	TEST_TRUE(file.size() == 12);
+	TEST_TRUE(file.end() == file.begin() + file.size());
+	TEST_TRUE(memcmp(file.begin(), "hello\r\nworld", file.size()) == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("mapping an empty file provides an empty view")
+{
+	Core::MappedFile file(testEmptyFile);
+
+	TEST_TRUE(file.size() == 0);
+	TEST_TRUE(file.begin() == file.end());
+}
+TEST_CASE_END
+
+TEST_CASE("the contents can be accessed as a range of bytes or characters")
+{
+	Core::MappedFile file(testTextFile);
+
+	Core::ByteRange bytes = file.bytes();
+	Core::TextRange text = file.text();
+
+	TEST_TRUE((bytes.begin() == file.begin()) && (bytes.size() == file.size()));
+	TEST_TRUE(reinterpret_cast<const byte*>(text.begin()) == file.begin());
+	TEST_TRUE(text.size() == (file.size() / sizeof(tchar)));
+#ifdef ANSI_BUILD
+	TEST_TRUE(text == TXT("hello\r\nworld"));
+#endif
+}
+TEST_CASE_END
+
+TEST_CASE("the contents are the same whatever the access hint")
+{
+	const Core::MappedFile::Hint hints[] =
+	{
+		Core::MappedFile::NORMAL,
+		Core::MappedFile::SEQUENTIAL,
+		Core::MappedFile::RANDOM,
+	};
+
+	for (size_t i = 0; i != ARRAY_SIZE(hints); ++i)
+	{
+		Core::MappedFile file(testTextFile, Core::MappedFile::READ_ONLY, hints[i]);
+
+		file.prefault();
+
+		TEST_TRUE(file.size() == 12);
+		TEST_TRUE(memcmp(file.begin(), "hello\r\nworld", file.size()) == 0);
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("a read-only mapping cannot be resized")
+{
+	Core::MappedFile file(testTextFile);
+
+	TEST_FALSE(file.isWritable());
+	TEST_THROWS(file.resize(24));
+	TEST_TRUE(readFile(testTextFile) == "hello\r\nworld");
+}
+TEST_CASE_END
+
+TEST_CASE("a writable mapping creates the file if it does not exist")
+{
+	Core::deleteFile(testWriteFile, true);
+
+	{
+		Core::MappedFile file(testWriteFile, Core::MappedFile::READ_WRITE);
+
+		TEST_TRUE(file.isWritable());
+		TEST_TRUE(file.size() == 0);
+		TEST_TRUE(file.begin() == file.end());
+	}
+
+	TEST_TRUE(Core::pathExists(testWriteFile));
+}
+TEST_CASE_END
+
+TEST_CASE("a writable mapping can be grown, written to and shrunk")
+{
+	createFile(testWriteFile, "hello");
+
+	{
+		Core::MappedFile file(testWriteFile, Core::MappedFile::READ_WRITE);
+
+		file.resize(11);
+
+		TEST_TRUE(file.size() == 11);
+		TEST_TRUE(memcmp(file.begin(), "hello\0\0\0\0\0\0", 11) == 0);
+
+		memcpy(file.data() + 5, " world", 6);
+		file.flush();
+
+		TEST_TRUE(readFile(testWriteFile) == "hello world");
+
+		file.resize(8);
+
+		TEST_TRUE(file.size() == 8);
+		TEST_TRUE(memcmp(file.begin(), "hello wo", 8) == 0);
+
+		file.resize(0);
+
+		TEST_TRUE(file.size() == 0);
+		TEST_TRUE(file.begin() == file.end());
+
+		file.resize(3);
+		memcpy(file.data(), "new", 3);
+	}
+
+	TEST_TRUE(readFile(testWriteFile) == "new");
+}
+TEST_CASE_END
+
+TEST_CASE("a failed resize keeps the original view")
+{
+	// The size is too large to seek to on a 64-bit build.
+	if (sizeof(size_t) == 8)
+	{
+		createFile(testWriteFile, "hello");
+
+		Core::MappedFile file(testWriteFile, Core::MappedFile::READ_WRITE);
+
+		TEST_THROWS(file.resize(static_cast<size_t>(-1)));
+
+		TEST_TRUE(file.size() == 5);
+		TEST_TRUE(memcmp(file.begin(), "hello", 5) == 0);
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("mapping an invalid filename throws an exception")
+{
+	tstring invalidFile = TXT(".\\invalid_local_file_name.txt");
+
+	TEST_THROWS(Core::MappedFile(invalidFile));
+}
+TEST_CASE_END
+
+	Core::deleteFile(testEmptyFile, true);
+	Core::deleteFile(testTextFile, true);
+	Core::deleteFile(testWriteFile, true);
+}
+TEST_SET_END
@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   MultiFileLineReaderTests.cpp
+//! \brief  The unit tests for the MultiFileLineReader class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/MultiFileLineReader.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include <Core/StringUtils.hpp>
+#include <Core/Interlocked.hpp>
+#include <Core/InvalidArgException.hpp>
+#include "FileTest.hpp"
+
+class CountingHandler : public Core::MultiFileLineReader::Handler
+{
+public:
+	CountingHandler(size_t count)
+		: m_lines(count, 0)
+		, m_files(0)
+	{
+	}
+
+	virtual void processFile(size_t file, Core::LineReader& lines)
+	{
+		Core::TextRange line;
+
+		while (lines.readLine(line))
+			++m_lines[file];
+
+		Core::atomicIncrement(m_files);
+	}
+
+	std::vector<size_t>	m_lines;
+	long				m_files;
+};
+
+class FailingFileHandler : public Core::MultiFileLineReader::Handler
+{
+public:
+	virtual void processFile(size_t /*file*/, Core::LineReader& /*lines*/)
+	{
+		throw Core::InvalidArgException(TXT("Test Exception"));
+	}
+};
+
+TEST_SET(MultiFileLineReader)
+{
+	const tstring folder = Core::combinePaths(Core::getTempFolder(), TXT("core_multi_file_test"));
+	const tstring subFolder = Core::combinePaths(folder, TXT("sub.log"));
+
+	const tchar* logFiles[] = { TXT("c.log"), TXT("a.log"), TXT("b.log") };
+
+	Core::createFolder(folder);
+	Core::createFolder(subFolder);
+
+	createFile(Core::combinePaths(folder, logFiles[0]), "c1\nc2\nc3");
+	createFile(Core::combinePaths(folder, logFiles[1]), "a1\r\n");
+	createFile(Core::combinePaths(folder, logFiles[2]), "");
+	createFile(Core::combinePaths(folder, TXT("other.txt")), "other\n");
+
+TEST_CASE("construction with a zero prefetch throws an exception")
+{
+	TEST_THROWS(Core::MultiFileLineReader(folder, TXT("*.log"), 0));
+}
+TEST_CASE_END
+
+TEST_CASE("construction with a missing folder throws an exception")
+{
+	TEST_THROWS(Core::MultiFileLineReader(Core::combinePaths(folder, TXT("missing")), TXT("*.log")));
+}
+TEST_CASE_END
+
+TEST_CASE("a wildcard with no matches has no files or lines")
+{
+	Core::MultiFileLineReader reader(folder, TXT("*.csv"));
+	Core::TextRange           line;
+	size_t                    file;
+
+	TEST_TRUE(reader.fileCount() == 0);
+	TEST_FALSE(reader.readLine(line, file));
+}
+TEST_CASE_END
+
+TEST_CASE("only files matching the wildcard are found, sorted by name")
+{
+	Core::MultiFileLineReader reader(folder, TXT("*.log"));
+
+	TEST_TRUE(reader.fileCount() == 3);
+	TEST_TRUE(reader.filename(0) == Core::combinePaths(folder, TXT("a.log")));
+	TEST_TRUE(reader.filename(1) == Core::combinePaths(folder, TXT("b.log")));
+	TEST_TRUE(reader.filename(2) == Core::combinePaths(folder, TXT("c.log")));
+}
+TEST_CASE_END
+
+TEST_CASE("the lines are read in file order and tagged with their file")
+{
+	Core::MultiFileLineReader reader(folder, TXT("*.log"), 1);
+	Core::TextRange           line;
+	size_t                    file;
+
+	TEST_TRUE(reader.readLine(line, file) && (line == TXT("a1")) && (file == 0));
+	TEST_TRUE(reader.readLine(line, file) && (line == TXT("c1")) && (file == 2));
+	TEST_TRUE(reader.readLine(line, file) && (line == TXT("c2")) && (file == 2));
+	TEST_TRUE(reader.readLine(line, file) && (line == TXT("c3")) && (file == 2));
+	TEST_FALSE(reader.readLine(line, file));
+	TEST_FALSE(reader.readLine(line, file));
+}
+TEST_CASE_END
+
+TEST_CASE("processing in parallel passes each file to the handler once")
+{
+	Core::MultiFileLineReader reader(folder, TXT("*.log"));
+	CountingHandler           handler(reader.fileCount());
+
+	reader.process(handler, 2);
+
+	TEST_TRUE(handler.m_files == 3);
+	TEST_TRUE(handler.m_lines[0] == 1);
+	TEST_TRUE(handler.m_lines[1] == 0);
+	TEST_TRUE(handler.m_lines[2] == 3);
+}
+TEST_CASE_END
+
+TEST_CASE("a handler failure whilst processing in parallel keeps its type")
+{
+	Core::MultiFileLineReader reader(folder, TXT("*.log"));
+	FailingFileHandler        handler;
+
+	try
+	{
+		reader.process(handler, 2);
+
+		TEST_FAILED("process did not throw");
+	}
+	catch (const Core::InvalidArgException& exception)
+	{
+		TEST_TRUE(tstrstr(exception.twhat(), TXT("Test Exception")) != nullptr);
+	}
+}
+TEST_CASE_END
+
+	for (size_t i = 0; i != ARRAY_SIZE(logFiles); ++i)
+		Core::deleteFile(Core::combinePaths(folder, logFiles[i]), true);
+
+	Core::deleteFile(Core::combinePaths(folder, TXT("other.txt")), true);
+	Core::deleteFolder(subFolder, true);
+	Core::deleteFolder(folder, true);
+}
+TEST_SET_END
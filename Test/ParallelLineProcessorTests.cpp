@@ -0,0 +1,247 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ParallelLineProcessorTests.cpp
+//! \brief  The unit tests for the ParallelLineProcessor class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/ParallelLineProcessor.hpp>
+#include <Core/RuntimeException.hpp>
+#include <Core/InvalidArgException.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include <Core/StringUtils.hpp>
+#include "FileTest.hpp"
+
+class LineCollector : public Core::ParallelLineProcessor::Handler
+{
+public:
+	typedef std::vector<tstring> Lines;
+
+	LineCollector(size_t chunks)
+		: m_lines(chunks)
+		, m_reported()
+		, m_processed(0)
+	{
+	}
+
+	virtual void processChunk(size_t chunk, Core::LineReader& lines)
+	{
+		Core::TextRange line;
+
+		while (lines.readLine(line))
+			m_lines[chunk].push_back(Core::toString(line));
+	}
+
+	virtual void chunkCompleted(size_t chunk)
+	{
+		m_reported.push_back(chunk);
+	}
+
+	virtual void progress(ulonglong processed, ulonglong /*total*/)
+	{
+		m_processed = processed;
+	}
+
+	Lines allLines() const
+	{
+		Lines all;
+
+		for (size_t i = 0; i != m_lines.size(); ++i)
+			all.insert(all.end(), m_lines[i].begin(), m_lines[i].end());
+
+		return all;
+	}
+
+	std::vector<Lines>	m_lines;
+	std::vector<size_t>	m_reported;
+	ulonglong			m_processed;
+};
+
+class FailingHandler : public Core::ParallelLineProcessor::Handler
+{
+public:
+	virtual void processChunk(size_t chunk, Core::LineReader& /*lines*/)
+	{
+		if (chunk == 1)
+			throw Core::InvalidArgException(TXT("Test Exception"));
+	}
+};
+
+class CancellingHandler : public Core::ParallelLineProcessor::Handler
+{
+public:
+	CancellingHandler(Core::ParallelLineProcessor& processor)
+		: m_processor(processor)
+		, m_reported(0)
+	{
+	}
+
+	virtual void processChunk(size_t /*chunk*/, Core::LineReader& /*lines*/)
+	{
+	}
+
+	virtual void chunkCompleted(size_t /*chunk*/)
+	{
+		++m_reported;
+		m_processor.cancel();
+	}
+
+	Core::ParallelLineProcessor&	m_processor;
+	size_t							m_reported;
+};
+
+TEST_SET(ParallelLineProcessor)
+{
+	const size_t numLines = 1000;
+
+	std::string          contents;
+	LineCollector::Lines expected;
+
+	for (size_t i = 0; i != numLines; ++i)
+	{
+		tstring line = Core::fmt(TXT("line %u"), static_cast<uint>(i));
+
+		contents += T2A(line) + std::string((i % 3) ? "\n" : "\r\n");
+		expected.push_back(line);
+	}
+
+	contents += "last";
+	expected.push_back(TXT("last"));
+
+	tstring testTextFile = Core::combinePaths(Core::getTempFolder(), TXT("core_parallel_test_file.txt"));
+
+	createFile(testTextFile, contents);
+
+	tstring testEmptyFile = Core::combinePaths(Core::getTempFolder(), TXT("core_parallel_empty_test_file.txt"));
+
+	createFile(testEmptyFile, "");
+
+TEST_CASE("an empty file has no chunks to process")
+{
+	Core::ParallelLineProcessor processor(testEmptyFile, 2);
+	LineCollector               handler(processor.chunkCount());
+
+	TEST_TRUE(processor.chunkCount() == 0);
+	TEST_TRUE(processor.process(handler));
+	TEST_TRUE(handler.m_reported.empty());
+}
+TEST_CASE_END
+
+TEST_CASE("chunks are reported in file order when ordered and every line is processed once")
+{
+	Core::ParallelLineProcessor processor(testTextFile, 4, 100);
+	LineCollector               handler(processor.chunkCount());
+
+	TEST_TRUE(processor.chunkCount() > 4);
+	TEST_TRUE(processor.process(handler, Core::ParallelLineProcessor::ORDERED));
+	TEST_TRUE(handler.allLines() == expected);
+	TEST_TRUE(handler.m_reported.size() == processor.chunkCount());
+	TEST_TRUE(handler.m_processed == processor.fileSize());
+
+	bool ordered = true;
+
+	for (size_t i = 0; i != handler.m_reported.size(); ++i)
+		ordered &= (handler.m_reported[i] == i);
+
+	TEST_TRUE(ordered);
+}
+TEST_CASE_END
+
+TEST_CASE("every chunk is reported once when unordered")
+{
+	Core::ParallelLineProcessor processor(testTextFile, 3, 64);
+	LineCollector               handler(processor.chunkCount());
+
+	TEST_TRUE(processor.process(handler, Core::ParallelLineProcessor::UNORDERED));
+	TEST_TRUE(handler.allLines() == expected);
+
+	std::vector<size_t> reported = handler.m_reported;
+
+	std::sort(reported.begin(), reported.end());
+
+	bool complete = (reported.size() == processor.chunkCount());
+
+	for (size_t i = 0; complete && (i != reported.size()); ++i)
+		complete &= (reported[i] == i);
+
+	TEST_TRUE(complete);
+	TEST_TRUE(handler.m_processed == processor.fileSize());
+}
+TEST_CASE_END
+
+TEST_CASE("a single chunk is used when the chunk size exceeds the file size")
+{
+	Core::ParallelLineProcessor processor(testTextFile, 2);
+	LineCollector               handler(processor.chunkCount());
+
+	TEST_TRUE(processor.chunkCount() == 1);
+	TEST_TRUE(processor.process(handler));
+	TEST_TRUE(handler.allLines() == expected);
+}
+TEST_CASE_END
+
+TEST_CASE("processing stops when cancelled")
+{
+	Core::ParallelLineProcessor processor(testTextFile, 2, 64);
+	CancellingHandler           handler(processor);
+
+	TEST_FALSE(processor.process(handler, Core::ParallelLineProcessor::ORDERED));
+	TEST_TRUE(processor.isCancelled());
+	TEST_TRUE(handler.m_reported == 1);
+}
+TEST_CASE_END
+
+TEST_CASE("a processor can be reused after it has been cancelled")
+{
+	Core::ParallelLineProcessor processor(testTextFile, 2, 64);
+	CancellingHandler           cancelling(processor);
+	LineCollector               collector(processor.chunkCount());
+
+	TEST_FALSE(processor.process(cancelling));
+	TEST_TRUE(processor.process(collector));
+	TEST_FALSE(processor.isCancelled());
+}
+TEST_CASE_END
+
+TEST_CASE("an exception thrown whilst processing a chunk is rethrown")
+{
+	Core::ParallelLineProcessor processor(testTextFile, 2, 64);
+	FailingHandler              handler;
+
+	TEST_THROWS(processor.process(handler));
+}
+TEST_CASE_END
+
+TEST_CASE("an exception thrown whilst processing a chunk keeps its type")
+{
+	Core::ParallelLineProcessor processor(testTextFile, 2, 64);
+	FailingHandler              handler;
+
+	try
+	{
+		processor.process(handler);
+
+		TEST_FAILED("process did not throw");
+	}
+	catch (const Core::InvalidArgException& exception)
+	{
+		TEST_TRUE(tstrstr(exception.twhat(), TXT("Test Exception")) != nullptr);
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("processing an invalid file or using a zero chunk size throws an exception")
+{
+	tstring invalidFile = TXT(".\\invalid_local_file_name.txt");
+
+	TEST_THROWS(Core::ParallelLineProcessor(invalidFile));
+	TEST_THROWS(Core::ParallelLineProcessor(testTextFile, 1, 0));
+}
+TEST_CASE_END
+
+	Core::deleteFile(testTextFile, true);
+	Core::deleteFile(testEmptyFile, true);
+}
+TEST_SET_END
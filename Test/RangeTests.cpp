@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   RangeTests.cpp
+//! \brief  The unit tests for the Range class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/Range.hpp>
+
+TEST_SET(Range)
+{
+	const tchar* text = TXT("hello world");
+
+TEST_CASE("default construction creates an empty range")
+{
+	Core::TextRange range;
+
+	TEST_TRUE(range.empty());
+	TEST_TRUE(range.size() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a range can be constructed from a pair of pointers or a pointer and length")
+{
+	Core::TextRange lhs(text, text+5);
+	Core::TextRange rhs(text, static_cast<size_t>(5));
+
+	TEST_TRUE(lhs.begin() == rhs.begin());
+	TEST_TRUE(lhs.end() == rhs.end());
+	TEST_TRUE(lhs.size() == 5);
+	TEST_TRUE(lhs[4] == TXT('o'));
+}
+TEST_CASE_END
+
+TEST_CASE("ranges compare equal when their contents are the same")
+{
+	const tstring   copy(text);
+	Core::TextRange lhs(text, text+5);
+	Core::TextRange rhs(copy.data(), copy.data()+5);
+
+	TEST_TRUE(lhs == rhs);
+	TEST_FALSE(lhs != rhs);
+	TEST_TRUE(lhs != Core::TextRange(text+6, text+11));
+}
+TEST_CASE_END
+
+TEST_CASE("a range of characters can be compared with a string")
+{
+	Core::TextRange range(text, text+5);
+
+	TEST_TRUE(range == TXT("hello"));
+	TEST_TRUE(range == tstring(TXT("hello")));
+	TEST_TRUE(range != TXT("hell"));
+	TEST_TRUE(range != tstring(TXT("world")));
+}
+TEST_CASE_END
+
+TEST_CASE("a range of characters can be converted to a string")
+{
+	Core::TextRange range(text+6, text+11);
+
+	TEST_TRUE(Core::toString(range) == TXT("world"));
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ReadAheadLineReaderTests.cpp
+//! \brief  The unit tests for the ReadAheadLineReader class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/ReadAheadLineReader.hpp>
+#include <Core/LineIterator.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include <Core/StringUtils.hpp>
+#include <Core/FileSystemException.hpp>
+#include <Core/ParseException.hpp>
+#include <Core/RuntimeException.hpp>
+#include "FileTest.hpp"
+
+class FailingSource : public Core::ByteSource
+{
+public:
+	enum Failure
+	{
+		FILE_SYSTEM_ERROR,
+		ERROR_WITHOUT_DETAILS,
+		UNKNOWN_ERROR,
+	};
+
+	FailingSource(Failure failure = FILE_SYSTEM_ERROR)
+		: m_failure(failure)
+		, m_reads(0)
+	{
+	}
+
+	virtual size_t read(char* buffer, size_t size)
+	{
+		if (m_reads++ != 0)
+		{
+			if (m_failure == ERROR_WITHOUT_DETAILS)
+				throw Core::ParseException(TXT(""));
+
+			if (m_failure == UNKNOWN_ERROR)
+				throw 42;
+
+			throw Core::FileSystemException(TXT("read failed"));
+		}
+
+		const char*  text = "first\nsec";
+		const size_t length = std::min(size, strlen(text));
+
+		memcpy(buffer, text, length);
+
+		return length;
+	}
+
+private:
+	Failure	m_failure;
+	int		m_reads;
+};
+
+TEST_SET(ReadAheadLineReader)
+{
+	const tstring folder = Core::getTempFolder();
+	const tstring testFile = Core::combinePaths(folder, TXT("core_read_ahead_test_file.txt"));
+	const tstring emptyFile = Core::combinePaths(folder, TXT("core_read_ahead_empty_file.txt"));
+
+	createFile(testFile, "first\r\nsecond line\n\nlast");
+	createFile(emptyFile, "");
+
+TEST_CASE("construction with a zero block size or no buffers throws an exception")
+{
+	TEST_THROWS(Core::ReadAheadLineReader(testFile, 0));
+	TEST_THROWS(Core::ReadAheadLineReader(testFile, 16, 0));
+}
+TEST_CASE_END
+
+TEST_CASE("construction from an invalid filename throws an exception")
+{
+	tstring invalidFile = TXT(".\\invalid_local_file_name.txt");
+
+	TEST_THROWS(Core::ReadAheadLineReader(invalidFile));
+}
+TEST_CASE_END
+
+TEST_CASE("lines are read across block boundaries")
+{
+	Core::ReadAheadLineReader reader(testFile, 3);
+	Core::TextRange           line;
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("first")));
+	TEST_TRUE(reader.readLine(line) && (line == TXT("second line")));
+	TEST_TRUE(reader.readLine(line) && line.empty());
+	TEST_TRUE(reader.readLine(line) && (line == TXT("last")));
+	TEST_FALSE(reader.readLine(line));
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("an empty file has no lines")
+{
+	Core::ReadAheadLineReader reader(emptyFile);
+	Core::TextRange           line;
+
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("a large file is read in order when more blocks than buffers are needed")
+{
+	const size_t count = 10000;
+	std::string  contents;
+
+	for (size_t i = 0; i != count; ++i)
+		contents += T2A(Core::fmt(TXT("line %u\n"), static_cast<uint>(i)));
+
+	createFile(testFile, contents);
+
+	Core::LineIterator end;
+	Core::LineIterator it(Core::LineReaderPtr(new Core::ReadAheadLineReader(testFile, 100, 3)));
+	size_t             lines = 0;
+	bool               inOrder = true;
+
+	for (; it != end; ++it, ++lines)
+	{
+		if (*it != Core::fmt(TXT("line %u"), static_cast<uint>(lines)))
+			inOrder = false;
+	}
+
+	TEST_TRUE(inOrder);
+	TEST_TRUE(lines == count);
+}
+TEST_CASE_END
+
+TEST_CASE("destroying the reader before the end of the file stops the background thread")
+{
+	{
+		Core::ReadAheadLineReader reader(testFile, 16);
+		Core::TextRange           line;
+
+		TEST_TRUE(reader.readLine(line) && (line == TXT("line 0")));
+	}
+
+	TEST_PASSED("reader destroyed");
+}
+TEST_CASE_END
+
+TEST_CASE("a read error on the background thread is thrown when the failed block is needed")
+{
+	Core::ReadAheadLineReader reader(Core::ByteSourcePtr(new FailingSource), 64);
+	Core::TextRange           line;
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("first")));
+	TEST_THROWS(reader.readLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("a read error is thrown with its original type")
+{
+	Core::ReadAheadLineReader reader(Core::ByteSourcePtr(new FailingSource), 64);
+	Core::TextRange           line;
+
+	TEST_TRUE(reader.readLine(line));
+
+	try
+	{
+		reader.readLine(line);
+
+		TEST_FAILED("readLine did not throw");
+	}
+	catch (const Core::FileSystemException& /*e*/)
+	{
+		TEST_PASSED("readLine threw the original exception");
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("a read error without any details is not mistaken for the end of the file")
+{
+	Core::ReadAheadLineReader reader(Core::ByteSourcePtr(new FailingSource(FailingSource::ERROR_WITHOUT_DETAILS)), 64);
+	Core::TextRange           line;
+
+	TEST_TRUE(reader.readLine(line));
+
+	try
+	{
+		reader.readLine(line);
+
+		TEST_FAILED("readLine did not throw");
+	}
+	catch (const Core::ParseException& /*e*/)
+	{
+		TEST_PASSED("readLine threw the original exception");
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("an unknown exception thrown by the source is reported rather than hanging the reader")
+{
+	Core::ReadAheadLineReader reader(Core::ByteSourcePtr(new FailingSource(FailingSource::UNKNOWN_ERROR)), 64);
+	Core::TextRange           line;
+
+	TEST_TRUE(reader.readLine(line));
+
+	try
+	{
+		reader.readLine(line);
+
+		TEST_FAILED("readLine did not throw");
+	}
+	catch (const Core::RuntimeException& /*e*/)
+	{
+		TEST_PASSED("readLine threw a runtime exception");
+	}
+}
+TEST_CASE_END
+
+	Core::deleteFile(testFile, true);
+	Core::deleteFile(emptyFile, true);
+}
+TEST_SET_END
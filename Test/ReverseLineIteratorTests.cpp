@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ReverseLineIteratorTests.cpp
+//! \brief  The unit tests for the ReverseLineIterator class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/ReverseLineIterator.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include "FileTest.hpp"
+
+static Core::ReverseLineReaderPtr openFile(const tstring& path)
+{
+	return Core::ReverseLineReaderPtr(new Core::ReverseLineReader(path));
+}
+
+TEST_SET(ReverseLineIterator)
+{
+	tstring testEmptyFile = Core::combinePaths(Core::getTempFolder(), TXT("core_reverse_lines_empty_test_file.txt"));
+
+	createFile(testEmptyFile, "");
+
+	tstring testTextFile = Core::combinePaths(Core::getTempFolder(), TXT("core_reverse_lines_test_file.txt"));
+
+	createFile(testTextFile, "hello world\r\n\nlast line");
+
+TEST_CASE("end iterator throws when incremented or dereferenced")
+{
+	Core::ReverseLineIterator end;
+
+	TEST_THROWS(++end);
+	TEST_THROWS(*end);
+	TEST_THROWS(static_cast<void>(end->empty()));
+}
+TEST_CASE_END
+
+TEST_CASE("end iterator compares equal with itself")
+{
+	Core::ReverseLineIterator lhs;
+	Core::ReverseLineIterator rhs;
+
+	TEST_TRUE(lhs == rhs);
+}
+TEST_CASE_END
+
+TEST_CASE("iterating a file returns each line from last to first")
+{
+	Core::ReverseLineIterator end;
+	Core::ReverseLineIterator it(openFile(testTextFile));
+
+	TEST_TRUE(it != end);
+	TEST_TRUE(*it == TXT("last line"));
+	TEST_TRUE((++it)->empty());
+	TEST_TRUE(*++it == TXT("hello world"));
+	TEST_TRUE(++it == end);
+}
+TEST_CASE_END
+
+TEST_CASE("opening an empty file should set the iterator to the end")
+{
+	Core::ReverseLineIterator end;
+	Core::ReverseLineIterator it(openFile(testEmptyFile));
+
+	TEST_TRUE(it == end);
+}
+TEST_CASE_END
+
+	Core::deleteFile(testEmptyFile, true);
+	Core::deleteFile(testTextFile, true);
+}
+TEST_SET_END
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ReverseLineReaderTests.cpp
+//! \brief  The unit tests for the ReverseLineReader class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/ReverseLineReader.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include <Core/StringUtils.hpp>
+#include "FileTest.hpp"
+
+TEST_SET(ReverseLineReader)
+{
+	const tstring testFile = Core::combinePaths(Core::getTempFolder(), TXT("core_reverse_test_file.txt"));
+
+TEST_CASE("construction with a zero block size throws an exception")
+{
+	createFile(testFile, "");
+
+	TEST_THROWS(Core::ReverseLineReader(testFile, 0));
+}
+TEST_CASE_END
+
+TEST_CASE("construction from an invalid filename throws an exception")
+{
+	tstring invalidFile = TXT(".\\invalid_local_file_name.txt");
+
+	TEST_THROWS(Core::ReverseLineReader(invalidFile));
+}
+TEST_CASE_END
+
+TEST_CASE("an empty file has no lines")
+{
+	createFile(testFile, "");
+
+	Core::ReverseLineReader reader(testFile);
+	Core::TextRange         line;
+
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("lines are read last first across block boundaries")
+{
+	createFile(testFile, "first\r\nsecond line\n\nlast\r\n");
+
+	Core::ReverseLineReader reader(testFile, 3);
+	Core::TextRange         line;
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("last")));
+	TEST_TRUE(reader.readLine(line) && line.empty());
+	TEST_TRUE(reader.readLine(line) && (line == TXT("second line")));
+	TEST_TRUE(reader.readLine(line) && (line == TXT("first")));
+	TEST_FALSE(reader.readLine(line));
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("the final line does not need a terminator")
+{
+	createFile(testFile, "first\nlast");
+
+	Core::ReverseLineReader reader(testFile);
+	Core::TextRange         line;
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("last")));
+	TEST_TRUE(reader.readLine(line) && (line == TXT("first")));
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("a file with only a terminator has a single empty line")
+{
+	createFile(testFile, "\r\n");
+
+	Core::ReverseLineReader reader(testFile);
+	Core::TextRange         line;
+
+	TEST_TRUE(reader.readLine(line) && line.empty());
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("many lines are read in reverse order with a small block size")
+{
+	const size_t count = 1000;
+	std::string  contents;
+
+	for (size_t i = 0; i != count; ++i)
+		contents += T2A(Core::fmt(TXT("line %u\n"), static_cast<uint>(i)));
+
+	createFile(testFile, contents);
+
+	Core::ReverseLineReader reader(testFile, 5);
+	Core::TextRange         line;
+	size_t                  lines = 0;
+	bool                    inOrder = true;
+
+	for (; reader.readLine(line); ++lines)
+	{
+		if (line != Core::fmt(TXT("line %u"), static_cast<uint>(count-lines-1)))
+			inOrder = false;
+	}
+
+	TEST_TRUE(inOrder);
+	TEST_TRUE(lines == count);
+}
+TEST_CASE_END
+
+	Core::deleteFile(testFile, true);
+}
+TEST_SET_END
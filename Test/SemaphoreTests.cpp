@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   SemaphoreTests.cpp
+//! \brief  The unit tests for the Semaphore class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/Semaphore.hpp>
+#include <Core/Thread.hpp>
+
+static void releaseSemaphore(void* param)
+{
+	static_cast<Core::Semaphore*>(param)->release();
+}
+
+TEST_SET(Semaphore)
+{
+
+TEST_CASE("waiting on a semaphore with a zero count times out")
+{
+	Core::Semaphore semaphore(0, 1);
+
+	TEST_FALSE(semaphore.wait(0));
+}
+TEST_CASE_END
+
+TEST_CASE("each wait takes one unit of the count")
+{
+	Core::Semaphore semaphore(2, 2);
+
+	TEST_TRUE(semaphore.wait(0));
+	TEST_TRUE(semaphore.wait(0));
+	TEST_FALSE(semaphore.wait(0));
+}
+TEST_CASE_END
+
+TEST_CASE("releasing returns units to the count")
+{
+	Core::Semaphore semaphore(0, 3);
+
+	semaphore.release(2);
+
+	TEST_TRUE(semaphore.wait(0));
+	TEST_TRUE(semaphore.wait(0));
+	TEST_FALSE(semaphore.wait(0));
+}
+TEST_CASE_END
+
+TEST_CASE("releasing above the maximum count throws an exception")
+{
+	Core::Semaphore semaphore(1, 1);
+
+	TEST_THROWS(semaphore.release());
+}
+TEST_CASE_END
+
+TEST_CASE("a semaphore can be released by another thread")
+{
+	Core::Semaphore semaphore(0, 1);
+	Core::Thread    thread(releaseSemaphore, &semaphore);
+
+	semaphore.wait();
+	thread.join();
+
+	TEST_PASSED("semaphore released");
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -129,6 +129,63 @@ TEST_CASE("opening an empty file should set the iterator to the end")
 
 	TEST_TRUE(it == end);
 }
+TEST_CASE_END
+
+TEST_CASE("a read-ahead iterator returns the same lines as a streamed one")
+{
+	Core::TextFileIterator end;
+	Core::TextFileIterator it(testTextFile, Core::TextFileIterator::READ_AHEAD);
+
+	TEST_TRUE(*it == s_testLine);
+	TEST_TRUE(++it == end);
+	TEST_THROWS(++it);
+}
+TEST_CASE_END
+
+TEST_CASE("a read-ahead iterator on an empty file is the end iterator")
+{
+	Core::TextFileIterator end;
+	Core::TextFileIterator it(testEmptyFile, Core::TextFileIterator::READ_AHEAD);
+
+	TEST_TRUE(it == end);
+}
+TEST_CASE_END
+
+TEST_CASE("a read-ahead iterator on an invalid filename throws an exception")
+{
+	tstring invalidFile = TXT(".\\invalid_local_file_name.txt");
+
+	TEST_THROWS(Core::TextFileIterator(invalidFile, Core::TextFileIterator::READ_AHEAD));
+}
+TEST_CASE_END
+
+TEST_CASE("a decoded iterator returns the same lines as a streamed one")
+{
+	Core::TextFileIterator end;
+	Core::TextFileIterator it(testTextFile, Core::TextFileIterator::DECODED);
+
+	TEST_TRUE(*it == s_testLine);
+	TEST_TRUE(++it == end);
+}
+TEST_CASE_END
+
+TEST_CASE("a decoded iterator skips the BOM of a UTF-16 file")
+{
+	tstring utf16File = Core::combinePaths(Core::getTempFolder(), TXT("core_test_utf16_file.txt"));
+
+	std::ofstream file(T2A(utf16File), std::ios::binary);
+
+	file.write("\xFF\xFEh\0i\0\r\0\n\0", 10);
+	file.close();
+
+	Core::TextFileIterator end;
+	Core::TextFileIterator it(utf16File, Core::TextFileIterator::DECODED);
+
+	TEST_TRUE(*it == TXT("hi"));
+	TEST_TRUE(++it == end);
+
+	Core::deleteFile(utf16File, true);
+}
 TEST_CASE_END
 
 	Core::deleteFile(testEmptyFile, true);
@@ -0,0 +1,297 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   TextFileWriterTests.cpp
+//! \brief  The unit tests for the TextFileWriter class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/TextFileWriter.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include "FileTest.hpp"
+#include <limits>
+
+static std::string toUtf16(const std::string& ascii, bool bigEndian)
+{
+	std::string utf16;
+
+	for (std::string::const_iterator it = ascii.begin(); it != ascii.end(); ++it)
+	{
+		if (bigEndian)
+			utf16 += '\0';
+
+		utf16 += *it;
+
+		if (!bigEndian)
+			utf16 += '\0';
+	}
+
+	return utf16;
+}
+
+TEST_SET(TextFileWriter)
+{
+	const tstring testFile = Core::combinePaths(Core::getTempFolder(), TXT("core_writer_test_file"));
+
+TEST_CASE("construction with a zero buffer size throws an exception")
+{
+	TEST_THROWS(Core::TextFileWriter(testFile, Core::UnicodeLineReader::ANSI, Core::TextFileWriter::FOREGROUND, 0));
+}
+TEST_CASE_END
+
+TEST_CASE("construction from an invalid path throws an exception")
+{
+	tstring invalidFile = TXT(".\\invalid_folder_name\\invalid_file_name.txt");
+
+	TEST_THROWS(Core::TextFileWriter(invalidFile));
+}
+TEST_CASE_END
+
+TEST_CASE("lines are written with a CR/LF terminator")
+{
+	{
+		Core::TextFileWriter writer(testFile);
+
+		writer.writeLine(TXT("first"));
+		writer.writeLine(tstring(TXT("second")));
+		writer.write(Core::TextRange(TXT("th"), 2));
+		writer.writeLine(TXT("ird"));
+		writer.writeLine();
+		writer.write(TXT("last"));
+		writer.close();
+	}
+
+	TEST_TRUE(readFile(testFile) == "first\r\nsecond\r\nthird\r\n\r\nlast");
+}
+TEST_CASE_END
+
+TEST_CASE("integer values are appended in decimal")
+{
+	{
+		Core::TextFileWriter writer(testFile);
+
+		writer.append(0);
+		writer.write(TXT(","));
+		writer.append(-42);
+		writer.write(TXT(","));
+		writer.append(std::numeric_limits<int>::min());
+		writer.write(TXT(","));
+		writer.append(std::numeric_limits<uint>::max());
+		writer.write(TXT(","));
+		writer.append(std::numeric_limits<ulonglong>::max());
+		writer.write(TXT(","));
+		writer.append(std::numeric_limits<longlong>::min());
+		writer.close();
+	}
+
+	TEST_TRUE(readFile(testFile) == "0,-42,-2147483648,4294967295,18446744073709551615,-9223372036854775808");
+}
+TEST_CASE_END
+
+TEST_CASE("floating-point values are appended with the given precision")
+{
+	{
+		Core::TextFileWriter writer(testFile);
+
+		writer.append(1.5);
+		writer.write(TXT(","));
+		writer.append(-0.25);
+		writer.write(TXT(","));
+		writer.append(3.14159265, 3);
+		writer.write(TXT(","));
+		writer.append(1e20);
+		writer.close();
+	}
+
+	TEST_TRUE(readFile(testFile) == "1.5,-0.25,3.14,1e+20");
+}
+TEST_CASE_END
+
+TEST_CASE("a Unicode encoding is written with a BOM")
+{
+	const Core::TextFileWriter::Encoding encodings[] =
+	{
+		Core::UnicodeLineReader::UTF8,
+		Core::UnicodeLineReader::UTF16LE,
+		Core::UnicodeLineReader::UTF16BE,
+	};
+
+	const std::string expected[] =
+	{
+		"\xEF\xBB\xBF" "line 1\r\n",
+		"\xFF\xFE" + toUtf16("line 1\r\n", false),
+		"\xFE\xFF" + toUtf16("line 1\r\n", true),
+	};
+
+	for (size_t i = 0; i != ARRAY_SIZE(encodings); ++i)
+	{
+		{
+			Core::TextFileWriter writer(testFile, encodings[i]);
+
+			TEST_TRUE(writer.encoding() == encodings[i]);
+
+			writer.write(TXT("line "));
+			writer.append(1);
+			writer.writeLine();
+			writer.close();
+		}
+
+		TEST_TRUE(readFile(testFile) == expected[i]);
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("ANSI characters are written unchanged to an ANSI file")
+{
+	std::string expected = "a\xE9\n";
+
+	{
+		Core::TextFileWriter writer(testFile, Core::UnicodeLineReader::ANSI, Core::TextFileWriter::FOREGROUND, 128);
+
+		writer.writeAnsi("a\xE9\n", 3);
+
+		for (size_t i = 0; i != 100; ++i)
+		{
+			writer.writeAnsi("0123456789", 10);
+			expected += "0123456789";
+		}
+
+		writer.close();
+	}
+
+	TEST_TRUE(readFile(testFile) == expected);
+}
+TEST_CASE_END
+
+#ifndef ANSI_BUILD
+TEST_CASE("non-ASCII characters are encoded")
+{
+	std::wstring text = L"a\x00E9\x20AC";
+
+	if (sizeof(wchar_t) == 2)
+		text += L"\xD83D\xDE00";
+	else
+		text += static_cast<wchar_t>(0x1F600);
+
+	{
+		Core::TextFileWriter writer(testFile, Core::UnicodeLineReader::UTF8);
+
+		writer.write(text);
+		writer.close();
+	}
+
+	TEST_TRUE(readFile(testFile) == "\xEF\xBB\xBF" "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+
+	{
+		Core::TextFileWriter writer(testFile, Core::UnicodeLineReader::UTF16LE);
+
+		writer.write(text);
+		writer.close();
+	}
+
+	TEST_TRUE(readFile(testFile) == std::string("\xFF\xFE" "a\0" "\xE9\0" "\xAC\x20" "\x3D\xD8\x00\xDE", 12));
+}
+TEST_CASE_END
+#endif
+
+TEST_CASE("the lines can be read back whatever the encoding, flush mode and buffer size")
+{
+	const Core::TextFileWriter::Encoding encodings[] =
+	{
+		Core::UnicodeLineReader::ANSI,
+		Core::UnicodeLineReader::UTF8,
+		Core::UnicodeLineReader::UTF16LE,
+		Core::UnicodeLineReader::UTF16BE,
+	};
+
+	const Core::TextFileWriter::FlushMode modes[] =
+	{
+		Core::TextFileWriter::FOREGROUND,
+		Core::TextFileWriter::BACKGROUND,
+	};
+
+	const size_t lines = 1000;
+
+	for (size_t i = 0; i != ARRAY_SIZE(encodings); ++i)
+	{
+		for (size_t j = 0; j != ARRAY_SIZE(modes); ++j)
+		{
+			{
+				Core::TextFileWriter writer(testFile, encodings[i], modes[j], 1);
+
+				for (size_t line = 0; line != lines; ++line)
+				{
+					writer.write(TXT("line "));
+					writer.append(line);
+					writer.writeLine();
+				}
+
+				writer.close();
+			}
+
+			Core::UnicodeLineReader reader(testFile);
+			Core::TextRange         line;
+			size_t                  count = 0;
+			bool                    matched = true;
+
+			TEST_TRUE(reader.encoding() == encodings[i]);
+
+			while (reader.readLine(line))
+			{
+				if (tstring(line.begin(), line.end()) != Core::fmt(TXT("line %u"), static_cast<uint>(count)))
+					matched = false;
+
+				++count;
+			}
+
+			TEST_TRUE(matched);
+			TEST_TRUE(count == lines);
+		}
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("flushing writes the buffered text to the file")
+{
+	const Core::TextFileWriter::FlushMode modes[] =
+	{
+		Core::TextFileWriter::FOREGROUND,
+		Core::TextFileWriter::BACKGROUND,
+	};
+
+	for (size_t i = 0; i != ARRAY_SIZE(modes); ++i)
+	{
+		Core::TextFileWriter writer(testFile, Core::UnicodeLineReader::ANSI, modes[i]);
+
+		writer.writeLine(TXT("buffered"));
+
+		TEST_TRUE(readFile(testFile).empty());
+
+		writer.flush();
+
+		TEST_TRUE(readFile(testFile) == "buffered\r\n");
+
+		writer.writeLine(TXT("synced"));
+		writer.sync();
+
+		TEST_TRUE(readFile(testFile) == "buffered\r\nsynced\r\n");
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("the buffered text is written on destruction")
+{
+	{
+		Core::TextFileWriter writer(testFile, Core::UnicodeLineReader::ANSI, Core::TextFileWriter::BACKGROUND);
+
+		writer.write(TXT("unflushed"));
+	}
+
+	TEST_TRUE(readFile(testFile) == "unflushed");
+}
+TEST_CASE_END
+
+	Core::deleteFile(testFile, true);
+}
+TEST_SET_END
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ThreadTests.cpp
+//! \brief  The unit tests for the Thread class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/Thread.hpp>
+#include <Core/RuntimeException.hpp>
+
+static void setFlag(void* param)
+{
+	*static_cast<bool*>(param) = true;
+}
+
+static void throwException(void* /*param*/)
+{
+	throw Core::RuntimeException(TXT("Test Exception"));
+}
+
+TEST_SET(Thread)
+{
+
+TEST_CASE("the thread function has been run once the thread is joined")
+{
+	bool         flag = false;
+	Core::Thread thread(setFlag, &flag);
+
+	thread.join();
+
+	TEST_TRUE(flag);
+}
+TEST_CASE_END
+
+TEST_CASE("the thread is joined on destruction if not already joined")
+{
+	bool flag = false;
+
+	{
+		Core::Thread thread(setFlag, &flag);
+	}
+
+	TEST_TRUE(flag);
+}
+TEST_CASE_END
+
+TEST_CASE("an exception thrown by the thread function is rethrown when joined")
+{
+	Core::Thread thread(throwException, nullptr);
+
+	TEST_THROWS(thread.join());
+}
+TEST_CASE_END
+
+TEST_CASE("joining a thread twice throws an exception")
+{
+	bool         flag = false;
+	Core::Thread thread(setFlag, &flag);
+
+	thread.join();
+
+	TEST_THROWS(thread.join());
+}
+TEST_CASE_END
+
+TEST_CASE("there is always at least one processor")
+{
+	TEST_TRUE(Core::Thread::processorCount() >= 1);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   TokenRangeTests.cpp
+//! \brief  The unit tests for the TokenRange class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/TokenRange.hpp>
+#include <Core/Algorithm.hpp>
+
+static bool IsEmpty(const Core::TextRange& token)
+{
+	return token.empty();
+}
+
+TEST_SET(TokenRange)
+{
+
+TEST_CASE("an empty string has no tokens")
+{
+	const tstring    string;
+	Core::TokenRange range(string, TXT(","));
+
+	TEST_TRUE(range.begin() == range.end());
+}
+TEST_CASE_END
+
+TEST_CASE("iterating a range yields the same tokens as splitting the string")
+{
+	const tchar* strings[] = { TXT(","), TXT("a"), TXT("a,b"), TXT(",a,,b,"), TXT("abc,,def;ghi;;") };
+	const uint   flags[] = { Core::Tokeniser::NONE, Core::Tokeniser::MERGE_SEPS, Core::Tokeniser::RETURN_SEPS,
+						     Core::Tokeniser::MERGE_SEPS|Core::Tokeniser::RETURN_SEPS };
+
+	bool matched = true;
+
+	for (size_t s = 0; s != ARRAY_SIZE(strings); ++s)
+	{
+		const tstring string(strings[s]);
+
+		for (size_t f = 0; f != ARRAY_SIZE(flags); ++f)
+		{
+			Core::Tokeniser::Tokens expected;
+
+			Core::Tokeniser::split(string, TXT(",;"), expected, flags[f]);
+
+			Core::TokenRange                 range(string, TXT(",;"), flags[f]);
+			Core::TokenRange::const_iterator it = range.begin();
+
+			for (size_t i = 0; i != expected.size(); ++i, ++it)
+			{
+				if ( (it == range.end()) || (*it != expected[i]) )
+					matched = false;
+			}
+
+			if (it != range.end())
+				matched = false;
+		}
+	}
+
+	TEST_TRUE(matched);
+}
+TEST_CASE_END
+
+TEST_CASE("a range can be used with the standard algorithms")
+{
+	const tstring    string(TXT("a::b:: ::c"));
+	Core::TokenRange range(string, Core::Tokeniser::Delimiters(1, TXT("::")));
+
+	TEST_TRUE(std::distance(range.begin(), range.end()) == 4);
+	TEST_TRUE(std::count(range.begin(), range.end(), TXT("b")) == 1);
+	TEST_TRUE(std::find(range.begin(), range.end(), TXT("c")) != range.end());
+	TEST_TRUE(Core::exists(range.begin(), range.end(), TXT(" ")));
+	TEST_FALSE(Core::exists_if(range.begin(), range.end(), IsEmpty));
+}
+TEST_CASE_END
+
+TEST_CASE("a copy of an iterator can be advanced independently")
+{
+	const tstring                    string(TXT("a,b,c"));
+	Core::TokenRange                 range(string, TXT(","));
+	Core::TokenRange::const_iterator first = range.begin();
+	Core::TokenRange::const_iterator second = first;
+
+	++second;
+
+	TEST_TRUE(*first == TXT("a"));
+	TEST_TRUE(*second == TXT("b"));
+	TEST_TRUE(first != second);
+	TEST_TRUE(*first++ == TXT("a"));
+	TEST_TRUE(first == second);
+}
+TEST_CASE_END
+
+TEST_CASE("tokens are only found as far as the iterator is advanced")
+{
+	const tstring    string(TXT("a,b,\"unterminated"));
+	Core::TokenRange range(string, TXT(","), Core::Tokeniser::QUOTED_FIELDS);
+
+	TEST_TRUE(Core::exists(range.begin(), range.end(), TXT("b")));
+	TEST_THROWS(Core::exists(range.begin(), range.end(), TXT("z")));
+}
+TEST_CASE_END
+
+TEST_CASE("incrementing the end iterator throws an exception")
+{
+	Core::TokenRange::const_iterator it;
+
+	TEST_THROWS(++it);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -6,6 +6,7 @@
 #include "Common.hpp"
 #include <Core/UnitTest.hpp>
 #include <Core/Tokeniser.hpp>
+#include <Core/TokenIndex.hpp>
 
 TEST_SET(Tokeniser)
 {
@@ -104,6 +105,257 @@ TEST_CASE("separators can be both merged and returned as tokens")
 }
 TEST_CASE_END
 
+TEST_CASE("quoted values can contain separators when quoting is enabled")
+{
+	const tstring           string(TXT("\"1,2\",3"));
+	Core::Tokeniser::Tokens tokens;
+
+	Core::Tokeniser::split(string, TXT(","), tokens, Core::Tokeniser::QUOTED_FIELDS);
+
+	TEST_TRUE(tokens.size() == 2);
+	TEST_TRUE(tokens[0] == TXT("1,2"));
+	TEST_TRUE(tokens[1] == TXT("3"));
+}
+TEST_CASE_END
+
+TEST_CASE("a pair of quotes within a quoted value is returned as a single quote")
+{
+	const tstring           string(TXT("\"a\"\"b\",\"\""));
+	Core::Tokeniser::Tokens tokens;
+
+	Core::Tokeniser::split(string, TXT(","), tokens, Core::Tokeniser::QUOTED_FIELDS);
+
+	TEST_TRUE(tokens.size() == 2);
+	TEST_TRUE(tokens[0] == TXT("a\"b"));
+	TEST_TRUE(tokens[1].empty());
+}
+TEST_CASE_END
+
+TEST_CASE("the quote and escape characters can be changed")
+{
+	const tstring           string(TXT("'a\\'b'|c"));
+	Core::Tokeniser::Tokens tokens;
+
+	Core::Tokeniser::split(string, TXT("|"), tokens, Core::Tokeniser::QUOTED_FIELDS, TXT('\''), TXT('\\'));
+
+	TEST_TRUE(tokens.size() == 2);
+	TEST_TRUE(tokens[0] == TXT("a'b"));
+	TEST_TRUE(tokens[1] == TXT("c"));
+}
+TEST_CASE_END
+
+TEST_CASE("an unterminated quoted value throws an exception")
+{
+	const tstring           string(TXT("\"abc"));
+	Core::Tokeniser::Tokens tokens;
+
+	TEST_THROWS(Core::Tokeniser::split(string, TXT(","), tokens, Core::Tokeniser::QUOTED_FIELDS));
+}
+TEST_CASE_END
+
+TEST_CASE("a token can be returned as a view onto the original string")
+{
+	const tstring   string(TXT("1,22"));
+	Core::Tokeniser tokeniser(string, TXT(","));
+
+	Core::TextRange first = tokeniser.nextTokenRange();
+	Core::TextRange second = tokeniser.nextTokenRange();
+
+	TEST_TRUE(first.begin() == string.data());
+	TEST_TRUE(first == TXT("1"));
+	TEST_TRUE(second.begin() == string.data()+2);
+	TEST_TRUE(second == TXT("22"));
+	TEST_FALSE(tokeniser.moreTokens());
+}
+TEST_CASE_END
+
+TEST_CASE("splitting into an index records the offset and length of each token")
+{
+	const tstring     string(TXT("a,bc,,d"));
+	Core::TokenIndex  index;
+
+	size_t count = Core::Tokeniser::splitIndex(string, TXT(","), index);
+
+	TEST_TRUE(count == 4);
+	TEST_TRUE(index.size() == 4);
+	TEST_TRUE(index[0].m_offset == 0 && index[0].m_length == 1);
+	TEST_TRUE(index[1].m_offset == 2 && index[1].m_length == 2);
+	TEST_TRUE(index[2].m_offset == 5 && index[2].m_length == 0);
+	TEST_TRUE(index[3].m_offset == 6 && index[3].m_length == 1);
+	TEST_TRUE(index.str(string, 1) == TXT("bc"));
+	TEST_TRUE(index.range(string, 3) == TXT("d"));
+}
+TEST_CASE_END
+
+TEST_CASE("splitting into an index matches splitting into strings")
+{
+	const tstring           string(TXT("\r\nabc\r\ndef\r\n"));
+	const uint              flags = Core::Tokeniser::MERGE_SEPS|Core::Tokeniser::RETURN_SEPS;
+	Core::Tokeniser::Tokens tokens;
+	Core::TokenIndex        index;
+
+	Core::Tokeniser::split(string, TXT("\r\n"), tokens, flags);
+	Core::Tokeniser::splitIndex(string, TXT("\r\n"), index, flags);
+
+	TEST_TRUE(index.size() == tokens.size());
+
+	for (size_t i = 0; i != tokens.size(); ++i)
+		TEST_TRUE(index.str(string, i) == tokens[i]);
+}
+TEST_CASE_END
+
+TEST_CASE("splitting into an index clears the index but retains its storage")
+{
+	const tstring    string(TXT("a,b,c"));
+	Core::TokenIndex index;
+
+	Core::Tokeniser::splitIndex(string, TXT(","), index);
+	Core::Tokeniser::splitIndex(string, TXT(","), index);
+
+	TEST_TRUE(index.size() == 3);
+
+	index.clear();
+
+	TEST_TRUE(index.empty());
+}
+TEST_CASE_END
+
+TEST_CASE("a parallel split returns the same tokens as a single threaded split")
+{
+	const tchar* strings[] = { TXT(""), TXT(","), TXT(",,,"), TXT("a"), TXT("a,b"), TXT(",a,,b,"),
+							   TXT("abc,,def;ghi,jkl;;;mno,p,q,,"), TXT(";;a;;;bb;c;;;;ddd;e;;") };
+	const uint   flags[] = { Core::Tokeniser::NONE, Core::Tokeniser::MERGE_SEPS, Core::Tokeniser::RETURN_SEPS,
+							 Core::Tokeniser::MERGE_SEPS|Core::Tokeniser::RETURN_SEPS };
+
+	bool matched = true;
+
+	for (size_t s = 0; s != ARRAY_SIZE(strings); ++s)
+	{
+		const tstring   string(strings[s]);
+		Core::TextRange range(string.data(), string.size());
+
+		for (size_t f = 0; f != ARRAY_SIZE(flags); ++f)
+		{
+			Core::TokenIndex expected;
+
+			Core::Tokeniser::splitIndex(range, TXT(",;"), expected, flags[f]);
+
+			for (size_t threads = 1; threads != 8; ++threads)
+			{
+				Core::TokenIndex actual;
+
+				Core::Tokeniser::splitParallel(range, TXT(",;"), actual, flags[f], threads);
+
+				if (actual.size() != expected.size())
+				{
+					matched = false;
+					continue;
+				}
+
+				for (size_t i = 0; i != expected.size(); ++i)
+				{
+					if ( (actual[i].m_offset != expected[i].m_offset) || (actual[i].m_length != expected[i].m_length) )
+						matched = false;
+				}
+			}
+		}
+	}
+
+	TEST_TRUE(matched);
+}
+TEST_CASE_END
+
+TEST_CASE("a parallel split of quoted values throws an exception")
+{
+	const tstring    string(TXT("\"a,b\",c"));
+	Core::TokenIndex index;
+
+	TEST_THROWS(Core::Tokeniser::splitParallel(Core::TextRange(string.data(), string.size()), TXT(","), index, Core::Tokeniser::QUOTED_FIELDS, 2));
+}
+TEST_CASE_END
+
+TEST_CASE("a delimiter string is matched as a whole rather than as a set of characters")
+{
+	const tstring               string(TXT("a::b:c::"));
+	Core::Tokeniser::Delimiters delims(1, TXT("::"));
+	Core::Tokeniser::Tokens     tokens;
+
+	Core::Tokeniser::split(string, delims, tokens);
+
+	TEST_TRUE(tokens.size() == 3);
+	TEST_TRUE(tokens[0] == TXT("a"));
+	TEST_TRUE(tokens[1] == TXT("b:c"));
+	TEST_TRUE(tokens[2] == TXT(""));
+}
+TEST_CASE_END
+
+TEST_CASE("the longest of several alternative delimiter strings is matched")
+{
+	const tstring               string(TXT("a\r\nb\nc -> d"));
+	Core::Tokeniser::Delimiters delims;
+	Core::Tokeniser::Tokens     tokens;
+
+	delims.push_back(TXT("\n"));
+	delims.push_back(TXT(" -> "));
+	delims.push_back(TXT("\r\n"));
+
+	Core::Tokeniser::split(string, delims, tokens, Core::Tokeniser::RETURN_SEPS);
+
+	TEST_TRUE(tokens.size() == 7);
+	TEST_TRUE(tokens[0] == TXT("a"));
+	TEST_TRUE(tokens[1] == TXT("\r\n"));
+	TEST_TRUE(tokens[2] == TXT("b"));
+	TEST_TRUE(tokens[3] == TXT("\n"));
+	TEST_TRUE(tokens[4] == TXT("c"));
+	TEST_TRUE(tokens[5] == TXT(" -> "));
+	TEST_TRUE(tokens[6] == TXT("d"));
+}
+TEST_CASE_END
+
+TEST_CASE("consecutive delimiter strings can be both merged and returned as tokens")
+{
+	const tstring               string(TXT("\r\nabc\r\n\ndef"));
+	Core::Tokeniser::Delimiters delims;
+	Core::Tokeniser::Tokens     tokens;
+
+	delims.push_back(TXT("\r\n"));
+	delims.push_back(TXT("\n"));
+
+	Core::Tokeniser::split(string, delims, tokens, Core::Tokeniser::MERGE_SEPS|Core::Tokeniser::RETURN_SEPS);
+
+	TEST_TRUE(tokens.size() == 5);
+	TEST_TRUE(tokens[0] == TXT(""));
+	TEST_TRUE(tokens[1] == TXT("\r\n"));
+	TEST_TRUE(tokens[2] == TXT("abc"));
+	TEST_TRUE(tokens[3] == TXT("\r\n\n"));
+	TEST_TRUE(tokens[4] == TXT("def"));
+}
+TEST_CASE_END
+
+TEST_CASE("quoted values can contain delimiter strings")
+{
+	const tstring               string(TXT("\"a::b\"::c"));
+	Core::Tokeniser::Delimiters delims(1, TXT("::"));
+	Core::TokenIndex            index;
+
+	Core::Tokeniser::splitIndex(string, delims, index, Core::Tokeniser::QUOTED_FIELDS);
+
+	TEST_TRUE(index.size() == 2);
+	TEST_TRUE(index.str(string, 0) == TXT("a::b"));
+	TEST_TRUE(index.str(string, 1) == TXT("c"));
+}
+TEST_CASE_END
+
+TEST_CASE("an empty delimiter string throws an exception")
+{
+	Core::Tokeniser::Delimiters delims(1, TXT(""));
+	Core::Tokeniser::Tokens     tokens;
+
+	TEST_THROWS(Core::Tokeniser::split(TXT("abc"), delims, tokens));
+	TEST_THROWS(Core::Tokeniser::split(TXT("abc"), Core::Tokeniser::Delimiters(), tokens));
+}
+TEST_CASE_END
+
 TEST_CASE("requesting another token when at the sequence end throws an exception")
 {
 	Core::Tokeniser tokeniser(TXT(""), TXT(","), Core::Tokeniser::NONE);
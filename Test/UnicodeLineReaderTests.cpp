@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   UnicodeLineReaderTests.cpp
+//! \brief  The unit tests for the UnicodeLineReader class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/UnicodeLineReader.hpp>
+#include <Core/AnsiWide.hpp>
+#include <Core/tfstream.hpp>
+#include <Core/FileSystem.hpp>
+#include "FileTest.hpp"
+
+static std::string toUtf16(const std::string& ascii, bool bigEndian)
+{
+	std::string utf16;
+
+	for (std::string::const_iterator it = ascii.begin(); it != ascii.end(); ++it)
+	{
+		if (bigEndian)
+			utf16 += '\0';
+
+		utf16 += *it;
+
+		if (!bigEndian)
+			utf16 += '\0';
+	}
+
+	return utf16;
+}
+
+TEST_SET(UnicodeLineReader)
+{
+	const tstring testFile = Core::combinePaths(Core::getTempFolder(), TXT("core_unicode_test_file"));
+
+	const std::string text = "first\r\nsecond line\n\nlast";
+
+TEST_CASE("construction with a zero block size throws an exception")
+{
+	createFile(testFile, text);
+
+	TEST_THROWS(Core::UnicodeLineReader(testFile, 0));
+}
+TEST_CASE_END
+
+TEST_CASE("construction from an invalid filename throws an exception")
+{
+	tstring invalidFile = TXT(".\\invalid_local_file_name.txt");
+
+	TEST_THROWS(Core::UnicodeLineReader(invalidFile));
+}
+TEST_CASE_END
+
+TEST_CASE("an empty file has no lines and is treated as ANSI")
+{
+	createFile(testFile, "");
+
+	Core::UnicodeLineReader reader(testFile);
+	Core::TextRange         line;
+
+	TEST_TRUE(reader.encoding() == Core::UnicodeLineReader::ANSI);
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("the encoding is determined by the BOM")
+{
+	createFile(testFile, "\xEF\xBB\xBF" + text);
+	TEST_TRUE(Core::UnicodeLineReader(testFile).encoding() == Core::UnicodeLineReader::UTF8);
+
+	createFile(testFile, "\xFF\xFE" + toUtf16(text, false));
+	TEST_TRUE(Core::UnicodeLineReader(testFile).encoding() == Core::UnicodeLineReader::UTF16LE);
+
+	createFile(testFile, "\xFE\xFF" + toUtf16(text, true));
+	TEST_TRUE(Core::UnicodeLineReader(testFile).encoding() == Core::UnicodeLineReader::UTF16BE);
+
+	createFile(testFile, text);
+	TEST_TRUE(Core::UnicodeLineReader(testFile).encoding() == Core::UnicodeLineReader::ANSI);
+}
+TEST_CASE_END
+
+TEST_CASE("the lines are the same whatever the encoding and block size")
+{
+	const std::string contents[] =
+	{
+		text,
+		"\xEF\xBB\xBF" + text,
+		"\xFF\xFE" + toUtf16(text, false),
+		"\xFE\xFF" + toUtf16(text, true),
+	};
+
+	for (size_t i = 0; i != ARRAY_SIZE(contents); ++i)
+	{
+		for (size_t blockSize = 1; blockSize != 8; ++blockSize)
+		{
+			createFile(testFile, contents[i]);
+
+			Core::UnicodeLineReader reader(testFile, blockSize);
+			Core::TextRange         line;
+
+			TEST_TRUE(reader.readLine(line) && (line == TXT("first")));
+			TEST_TRUE(reader.readLine(line) && (line == TXT("second line")));
+			TEST_TRUE(reader.readLine(line) && line.empty());
+			TEST_TRUE(reader.readLine(line) && (line == TXT("last")));
+			TEST_FALSE(reader.readLine(line));
+		}
+	}
+}
+TEST_CASE_END
+
+#ifndef ANSI_BUILD
+TEST_CASE("non-ASCII characters are decoded whatever the block size")
+{
+	// "\u00E9\u20AC" and U+1F600 in UTF-8 and UTF-16LE.
+	const std::string utf8 = "\xEF\xBB\xBF" "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80z\n";
+	const std::string utf16(
+		"\xFF\xFE" "a\0" "\xE9\0" "\xAC\x20" "\x3D\xD8\x00\xDE" "z\0" "\n\0", 16);
+
+	std::wstring expected = L"a\x00E9\x20AC";
+
+	if (sizeof(wchar_t) == 2)
+		expected += L"\xD83D\xDE00";
+	else
+		expected += static_cast<wchar_t>(0x1F600);
+
+	expected += L"z";
+
+	const std::string contents[] = { utf8, utf16 };
+
+	for (size_t i = 0; i != ARRAY_SIZE(contents); ++i)
+	{
+		for (size_t blockSize = 1; blockSize != 8; ++blockSize)
+		{
+			createFile(testFile, contents[i]);
+
+			Core::UnicodeLineReader reader(testFile, blockSize);
+			Core::TextRange         line;
+
+			TEST_TRUE(reader.readLine(line) && (tstring(line.begin(), line.end()) == expected));
+			TEST_FALSE(reader.readLine(line));
+		}
+	}
+}
+TEST_CASE_END
+#endif
+
+TEST_CASE("invalid UTF-8 sequences are replaced")
+{
+	createFile(testFile, "\xEF\xBB\xBF" "a\xFF" "b\xC3");
+
+	Core::UnicodeLineReader reader(testFile);
+	Core::TextRange         line;
+
+	TEST_TRUE(reader.readLine(line) && (line.size() == 4));
+	TEST_TRUE((line.begin()[0] == TXT('a')) && (line.begin()[2] == TXT('b')));
+	TEST_FALSE(reader.readLine(line));
+}
+TEST_CASE_END
+
+	Core::deleteFile(testFile, true);
+}
+TEST_SET_END
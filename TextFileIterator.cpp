@@ -9,6 +9,7 @@
 #include "AnsiWide.hpp"
 #include "FileSystemException.hpp"
 #include "StringUtils.hpp"
+#include "ReadAheadLineReader.hpp"
 
 namespace Core
 {
@@ -18,21 +19,38 @@ namespace Core
 
 TextFileIterator::TextFileIterator()
 	: m_stream()
+	, m_reader()
+	, m_decoder()
 	, m_value()
 {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//! Constructor for the Begin iterator.
+//! Constructor for the Begin iterator. In READ_AHEAD mode a read error is
+//! thrown from the increment that would have consumed the failed block. In
+//! DECODED mode the BOM is not returned as part of the first line.
 
-TextFileIterator::TextFileIterator(const tstring& filename)
+TextFileIterator::TextFileIterator(const tstring& filename, ReadMode mode)
 	: m_stream()
+	, m_reader()
+	, m_decoder()
 	, m_value()
 {
-	m_stream.reset(new tifstream(T2A(filename)));
-
-	if (!m_stream->is_open())
-		throw FileSystemException(Core::fmt(TXT("Failed to open file '%s'"), filename.c_str()));
+	if (mode == READ_AHEAD)
+	{
+		m_reader.reset(new ReadAheadLineReader(filename));
+	}
+	else if (mode == DECODED)
+	{
+		m_decoder.reset(new UnicodeLineReader(filename));
+	}
+	else
+	{
+		m_stream.reset(new tifstream(T2A(filename)));
+
+		if (!m_stream->is_open())
+			throw FileSystemException(Core::fmt(TXT("Failed to open file '%s'"), filename.c_str()));
+	}
 
 	m_value.reset(new tstring);
 
@@ -73,10 +91,10 @@ const tstring* TextFileIterator::operator->() const
 
 bool TextFileIterator::equals(const TextFileIterator& rhs) const
 {
-	if (m_stream.get() == nullptr)
-		return (rhs.m_stream.get() == nullptr);
+	if (m_value.get() == nullptr)
+		return (rhs.m_value.get() == nullptr);
 
-	return (m_stream.get() == rhs.m_stream.get());
+	return (m_value.get() == rhs.m_value.get());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -84,15 +102,28 @@ bool TextFileIterator::equals(const TextFileIterator& rhs) const
 
 void TextFileIterator::increment()
 {
-	if (m_stream.get() == nullptr)
+	if (m_value.get() == nullptr)
 		throw BadLogicException(TXT("Attempted to increment end iterator"));
 
-	ASSERT(m_value.get() != nullptr);
-
-	std::getline(*m_stream, *m_value);
-
-	if (!(*m_stream))
-		reset();
+	if ( (m_reader.get() != nullptr) || (m_decoder.get() != nullptr) )
+	{
+		TextRange line;
+		bool      read = (m_reader.get() != nullptr) ? m_reader->readLine(line) : m_decoder->readLine(line);
+
+		if (read)
+			m_value->assign(line.begin(), line.end());
+		else
+			reset();
+	}
+	else
+	{
+		ASSERT(m_stream.get() != nullptr);
+
+		std::getline(*m_stream, *m_value);
+
+		if (!(*m_stream))
+			reset();
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -101,6 +132,8 @@ void TextFileIterator::increment()
 void TextFileIterator::reset()
 {
 	m_stream.reset();
+	m_reader.reset();
+	m_decoder.reset();
 	m_value.reset();
 }
 
@@ -13,21 +13,35 @@
 
 #include "UniquePtr.hpp"
 #include "tfstream.hpp"
+#include "LineReader.hpp"
+#include "UnicodeLineReader.hpp"
 
 namespace Core
 {
 
 ////////////////////////////////////////////////////////////////////////////////
-//! The iterator type used to read lines of text from a file.
+//! The iterator type used to read lines of text from a file. By default the
+//! file is read with a file stream; alternatively it can be read ahead on a
+//! background thread, which overlaps the I/O with the processing of each line,
+//! or decoded in blocks according to its byte order mark.
 
 class TextFileIterator
 {
+public:
+	//! The method used to read the file.
+	enum ReadMode
+	{
+		STREAMED,	//!< Read the file using a file stream.
+		READ_AHEAD,	//!< Read the file on a background thread.
+		DECODED,	//!< Read the file as UTF-8, UTF-16 or ANSI based on its BOM.
+	};
+
 public:
 	//! Constructor for the End iterator.
 	TextFileIterator();
 
 	//! Constructor for the Begin iterator.
-	TextFileIterator(const tstring& filename);
+	TextFileIterator(const tstring& filename, ReadMode mode = STREAMED);
 
 	//! Destructor.
 	~TextFileIterator();
@@ -55,6 +69,10 @@ public:
 private:
 	//! The underlying input file stream.
 	typedef UniquePtr<tifstream> StreamPtr;
+	//! The underlying read-ahead line reader.
+	typedef UniquePtr<LineReader> ReaderPtr;
+	//! The underlying decoding line reader.
+	typedef UniquePtr<UnicodeLineReader> DecoderPtr;
 	//! The current value;
 	typedef UniquePtr<tstring> StringPtr;
 
@@ -62,6 +80,8 @@ private:
 	// Members.
 	//
 	StreamPtr	m_stream;	//!< The underlying file stream;
+	ReaderPtr	m_reader;	//!< The underlying read-ahead reader.
+	DecoderPtr	m_decoder;	//!< The underlying decoding reader.
 	StringPtr	m_value;	//!< The current iterator value.
 
 	//
@@ -0,0 +1,603 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   TextFileWriter.cpp
+//! \brief  The TextFileWriter class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "TextFileWriter.hpp"
+#include "Win32Error.hpp"
+#include "FileSystemException.hpp"
+#include "InvalidArgException.hpp"
+#include "StringUtils.hpp"
+#include "AnsiWide.hpp"
+#include <windows.h>
+#include <limits.h>
+#include <stdio.h>
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The largest number of bytes written by a single WriteFile().
+
+static const size_t MAX_WRITE_SIZE = INT_MAX;
+
+////////////////////////////////////////////////////////////////////////////////
+//! The smallest buffer used, which must hold the longest formatted number.
+
+static const size_t MIN_BUFFER_SIZE = 128;
+
+////////////////////////////////////////////////////////////////////////////////
+//! The character used in place of an unpaired surrogate.
+
+static const ulong REPLACEMENT_CHAR = 0xFFFD;
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append a code point as UTF-8.
+
+static char* appendUtf8(ulong codePoint, char* output)
+{
+	if (codePoint < 0x80)
+	{
+		*output++ = static_cast<char>(codePoint);
+	}
+	else if (codePoint < 0x800)
+	{
+		*output++ = static_cast<char>(0xC0 | (codePoint >> 6));
+		*output++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+	else if (codePoint < 0x10000)
+	{
+		*output++ = static_cast<char>(0xE0 | (codePoint >> 12));
+		*output++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		*output++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+	else
+	{
+		*output++ = static_cast<char>(0xF0 | (codePoint >> 18));
+		*output++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+		*output++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		*output++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+
+	return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Encode wide characters as UTF-8. Runs of ASCII are copied directly and
+//! surrogate pairs are combined. An unpaired surrogate is replaced.
+
+static size_t encodeUtf8(const wchar_t* begin, const wchar_t* end, char* output)
+{
+	char* out = output;
+
+	for (const wchar_t* it = begin; it != end; ++it)
+	{
+		ulong codePoint = static_cast<ulong>(*it);
+
+		if (codePoint < 0x80)
+		{
+			*out++ = static_cast<char>(codePoint);
+			continue;
+		}
+
+		if ( (codePoint >= 0xD800) && (codePoint <= 0xDFFF) )
+		{
+			const ulong next = ((it+1) != end) ? static_cast<ulong>(*(it+1)) : 0;
+
+			if ( (codePoint <= 0xDBFF) && (next >= 0xDC00) && (next <= 0xDFFF) )
+			{
+				codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (next - 0xDC00);
+				++it;
+			}
+			else
+			{
+				codePoint = REPLACEMENT_CHAR;
+			}
+		}
+
+		out = appendUtf8(codePoint, out);
+	}
+
+	return out - output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Encode wide characters as UTF-16. With a 16 bit wchar_t on a little-endian
+//! host UTF-16LE is a straight copy. With a 32 bit wchar_t characters outside
+//! the BMP are split into surrogate pairs.
+
+static size_t encodeUtf16(const wchar_t* begin, const wchar_t* end, bool bigEndian, char* output)
+{
+	if ( (sizeof(wchar_t) == 2) && !bigEndian )
+	{
+		const size_t size = (end - begin) * 2;
+
+		memcpy(output, begin, size);
+
+		return size;
+	}
+
+	const size_t high = bigEndian ? 0 : 1;
+	const size_t low = 1 - high;
+	char*        out = output;
+
+	for (const wchar_t* it = begin; it != end; ++it)
+	{
+		ulong units[2] = { static_cast<ulong>(*it), 0 };
+		size_t count = 1;
+
+		if (units[0] > 0xFFFF)
+		{
+			const ulong codePoint = units[0] - 0x10000;
+
+			units[0] = 0xD800 + (codePoint >> 10);
+			units[1] = 0xDC00 + (codePoint & 0x3FF);
+			count = 2;
+		}
+
+		for (size_t i = 0; i != count; ++i)
+		{
+			out[high] = static_cast<char>(units[i] >> 8);
+			out[low] = static_cast<char>(units[i] & 0xFF);
+			out += 2;
+		}
+	}
+
+	return out - output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the file to create, encoding, flush mode and the size of
+//! the buffer. Any existing file is replaced. In BACKGROUND mode a second
+//! buffer of the same size is used.
+
+TextFileWriter::TextFileWriter(const tstring& filename, Encoding encoding, FlushMode mode, size_t bufferSize)
+	: m_filename(filename)
+	, m_file(INVALID_HANDLE_VALUE)
+	, m_encoding(encoding)
+	, m_maxCharSize(1)
+	, m_buffer()
+	, m_used(0)
+	, m_widened()
+	, m_flushBuffer()
+	, m_flushSize(0)
+	, m_flushing(false)
+	, m_failed(false)
+	, m_error()
+	, m_stopping(false)
+	, m_flushRequested(Event::AUTO_RESET)
+	, m_flushCompleted(Event::AUTO_RESET)
+	, m_thread()
+{
+	if (bufferSize == 0)
+		throw InvalidArgException(TXT("The buffer size cannot be zero"));
+
+	if (m_encoding != UnicodeLineReader::ANSI)
+		m_maxCharSize = 4;
+
+	m_file = ::CreateFile(filename.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+							CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (m_file == INVALID_HANDLE_VALUE)
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw FileSystemException(Core::fmt(TXT("Failed to create file '%s' [0x%08lX - %s]"), filename.c_str(), errorCode, errorText.c_str()));
+	}
+
+	try
+	{
+		m_buffer.resize(std::max(bufferSize, MIN_BUFFER_SIZE));
+
+		if (mode == BACKGROUND)
+		{
+			m_flushBuffer.resize(m_buffer.size());
+			m_thread.reset(new Thread(flushThread, this));
+		}
+
+		// The BOM is the encoded U+FEFF.
+		if (m_encoding != UnicodeLineReader::ANSI)
+		{
+			const wchar_t bom = 0xFEFF;
+
+			m_used = (m_encoding == UnicodeLineReader::UTF8) ? encodeUtf8(&bom, &bom + 1, &m_buffer.front())
+							: encodeUtf16(&bom, &bom + 1, (m_encoding == UnicodeLineReader::UTF16BE), &m_buffer.front());
+		}
+	}
+	catch (...)
+	{
+		release();
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. Any buffered text is written, but errors are ignored, so call
+//! close() first to find out if the text was written.
+
+TextFileWriter::~TextFileWriter()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+		release();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append a floating-point value, formatted as "%g" with the given number of
+//! significant digits, which is limited to 17.
+
+void TextFileWriter::append(double value, int precision)
+{
+	char buffer[64];
+
+	precision = std::max(1, std::min(precision, 17));
+
+	int length = _snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+
+	if ( (length < 0) || (static_cast<size_t>(length) >= sizeof(buffer)) )
+		length = static_cast<int>(strlen(buffer));
+
+	writeAscii(buffer, length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write some ANSI characters, such as a line from LineReader::readAnsiLine().
+//! They are copied unchanged to an ANSI file and widened for a Unicode one.
+
+void TextFileWriter::writeAnsi(const char* text, size_t length)
+{
+	if (m_encoding == UnicodeLineReader::ANSI)
+	{
+		while (length != 0)
+		{
+			if (m_used == m_buffer.size())
+				submitBuffer();
+
+			const size_t count = std::min(length, m_buffer.size() - m_used);
+
+			memcpy(&m_buffer[m_used], text, count);
+
+			m_used += count;
+			text += count;
+			length -= count;
+		}
+
+		return;
+	}
+
+#ifdef ANSI_BUILD
+	write(text, text + length);
+#else
+	if (length == 0)
+		return;
+
+	if (m_widened.size() < length)
+		m_widened.resize(length);
+
+	ansiToWide(text, text + length, &m_widened.front());
+
+	write(&m_widened.front(), &m_widened.front() + length);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write the buffered text to the file. In BACKGROUND mode this waits until
+//! the write has completed.
+
+void TextFileWriter::flush()
+{
+	if (m_used != 0)
+		submitBuffer();
+
+	waitForFlush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write the buffered text to the file and then wait for the file system to
+//! write it to the disk.
+
+void TextFileWriter::sync()
+{
+	flush();
+
+	if (!::FlushFileBuffers(m_file))
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw FileSystemException(Core::fmt(TXT("Failed to flush file '%s' [0x%08lX - %s]"), m_filename.c_str(), errorCode, errorText.c_str()));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Flush the buffered text and close the file. The writer cannot be used
+//! afterwards.
+
+void TextFileWriter::close()
+{
+	if (m_file == INVALID_HANDLE_VALUE)
+		return;
+
+	try
+	{
+		flush();
+	}
+	catch (...)
+	{
+		release();
+		throw;
+	}
+
+	release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write some text, encoding it as it is copied into the buffer. The buffer is
+//! handed over to be written each time it fills up. For a UNICODE build a
+//! surrogate pair is never split across two buffers.
+
+void TextFileWriter::write(const tchar* begin, const tchar* end)
+{
+	while (begin != end)
+	{
+		if ((m_buffer.size() - m_used) < (m_maxCharSize * 2))
+			submitBuffer();
+
+		size_t count = std::min<size_t>(end - begin, (m_buffer.size() - m_used) / m_maxCharSize);
+
+#ifndef ANSI_BUILD
+		const wchar_t last = *(begin + count - 1);
+
+		if ( (count != static_cast<size_t>(end - begin)) && (count > 1) && (last >= 0xD800) && (last <= 0xDBFF) )
+			--count;
+#endif
+
+		m_used += encode(begin, begin + count, &m_buffer[m_used]);
+		begin += count;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write some ASCII characters, such as a formatted number, which need no
+//! conversion other than to UTF-16.
+
+void TextFileWriter::writeAscii(const char* text, size_t length)
+{
+	ASSERT((length * 2) <= MIN_BUFFER_SIZE);
+
+	if ((m_buffer.size() - m_used) < (length * 2))
+		submitBuffer();
+
+	char* out = &m_buffer[m_used];
+
+	if (m_encoding == UnicodeLineReader::UTF16LE)
+	{
+		for (size_t i = 0; i != length; ++i)
+		{
+			*out++ = text[i];
+			*out++ = '\0';
+		}
+	}
+	else if (m_encoding == UnicodeLineReader::UTF16BE)
+	{
+		for (size_t i = 0; i != length; ++i)
+		{
+			*out++ = '\0';
+			*out++ = text[i];
+		}
+	}
+	else
+	{
+		memcpy(out, text, length);
+		out += length;
+	}
+
+	m_used = out - &m_buffer.front();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append a signed integer value.
+
+void TextFileWriter::appendSigned(longlong value)
+{
+	// Negate as unsigned so that the most negative value is handled.
+	if (value < 0)
+		appendUnsigned(0 - static_cast<ulonglong>(value), true);
+	else
+		appendUnsigned(static_cast<ulonglong>(value), false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append an unsigned integer value, with a minus sign if negative. The digits
+//! are generated backwards from the end of a local buffer.
+
+void TextFileWriter::appendUnsigned(ulonglong value, bool negative)
+{
+	char  buffer[32];
+	char* end = buffer + sizeof(buffer);
+	char* begin = end;
+
+	do
+	{
+		*--begin = static_cast<char>('0' + (value % 10));
+		value /= 10;
+	}
+	while (value != 0);
+
+	if (negative)
+		*--begin = '-';
+
+	writeAscii(begin, end - begin);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Encode the text into the buffer, returning the number of bytes. For an ANSI
+//! build text for a Unicode encoding is widened first.
+
+size_t TextFileWriter::encode(const tchar* begin, const tchar* end, char* output)
+{
+	const size_t length = end - begin;
+
+#ifdef ANSI_BUILD
+	if (m_encoding == UnicodeLineReader::ANSI)
+	{
+		memcpy(output, begin, length);
+		return length;
+	}
+
+	if (m_widened.size() < length)
+		m_widened.resize(length);
+
+	ansiToWide(begin, end, &m_widened.front());
+
+	const wchar_t* wideBegin = &m_widened.front();
+	const wchar_t* wideEnd = wideBegin + length;
+#else
+	if (m_encoding == UnicodeLineReader::ANSI)
+	{
+		wideToAnsi(begin, end, output);
+		return length;
+	}
+
+	const wchar_t* wideBegin = begin;
+	const wchar_t* wideEnd = end;
+#endif
+
+	if (m_encoding == UnicodeLineReader::UTF8)
+		return encodeUtf8(wideBegin, wideEnd, output);
+
+	return encodeUtf16(wideBegin, wideEnd, (m_encoding == UnicodeLineReader::UTF16BE), output);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Hand the full buffer over to be written. In FOREGROUND mode it is written
+//! straight away. In BACKGROUND mode the buffers are swapped once any previous
+//! write has completed and the background thread is woken to write it.
+
+void TextFileWriter::submitBuffer()
+{
+	if (m_thread.get() == nullptr)
+	{
+		writeFile(&m_buffer.front(), m_used);
+		m_used = 0;
+		return;
+	}
+
+	waitForFlush();
+
+	m_buffer.swap(m_flushBuffer);
+	m_flushSize = m_used;
+	m_used = 0;
+	m_flushing = true;
+
+	m_flushRequested.signal();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait for the background write to complete, rethrowing any error.
+
+void TextFileWriter::waitForFlush()
+{
+	if (!m_flushing)
+		return;
+
+	m_flushCompleted.wait();
+	m_flushing = false;
+
+	if (m_failed)
+	{
+		m_failed = false;
+		throw FileSystemException(m_error);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write the bytes to the file.
+
+void TextFileWriter::writeFile(const char* data, size_t size)
+{
+	while (size != 0)
+	{
+		DWORD written = 0;
+
+		if (!::WriteFile(m_file, data, static_cast<DWORD>(std::min(size, MAX_WRITE_SIZE)), &written, nullptr))
+		{
+			DWORD   errorCode = ::GetLastError();
+			tstring errorText = formatWin32ErrorMessage(errorCode);
+
+			throw FileSystemException(Core::fmt(TXT("Failed to write to file '%s' [0x%08lX - %s]"), m_filename.c_str(), errorCode, errorText.c_str()));
+		}
+
+		data += written;
+		size -= written;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Stop the background thread and close the file, discarding any buffered
+//! text.
+
+void TextFileWriter::release()
+{
+	if (m_thread.get() != nullptr)
+	{
+		m_stopping = true;
+		m_flushRequested.signal();
+
+		m_thread.reset();
+	}
+
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		::CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+	}
+
+	m_used = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write buffers until the writer is closed. An error is recorded to be thrown
+//! on the calling thread.
+
+void TextFileWriter::flushBuffers()
+{
+	for (;;)
+	{
+		m_flushRequested.wait();
+
+		if (m_stopping)
+			break;
+
+		try
+		{
+			writeFile(&m_flushBuffer.front(), m_flushSize);
+		}
+		catch (const Core::Exception& e)
+		{
+			m_error = e.twhat();
+			m_failed = true;
+		}
+
+		m_flushCompleted.signal();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The background thread function.
+
+void TextFileWriter::flushThread(void* param)
+{
+	static_cast<TextFileWriter*>(param)->flushBuffers();
+}
+
+//namespace Core
+}
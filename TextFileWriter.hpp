@@ -0,0 +1,306 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   TextFileWriter.hpp
+//! \brief  The TextFileWriter class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_TEXTFILEWRITER_HPP
+#define CORE_TEXTFILEWRITER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include "Range.hpp"
+#include "UnicodeLineReader.hpp"
+#include "Event.hpp"
+#include "Thread.hpp"
+#include "UniquePtr.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Writes lines of text to a file through a large buffer. The text is encoded
+//! as it is buffered, using the same encodings that a UnicodeLineReader, and
+//! so a TextFileIterator, can read, and a BOM is written for the Unicode ones.
+//! Lines are terminated by "\r\n". The buffer is only written to the file when
+//! it is full or flushed, optionally on a background thread so that the next
+//! buffer can be filled whilst the last one is written.
+
+class TextFileWriter /*: private NotCopyable*/
+{
+public:
+	//! The encoding of the file.
+	typedef UnicodeLineReader::Encoding Encoding;
+
+	//! The thread used to write full buffers to the file.
+	enum FlushMode
+	{
+		FOREGROUND,	//!< Write on the calling thread.
+		BACKGROUND,	//!< Write on a background thread.
+	};
+
+	//! The default buffer size in bytes.
+	static const size_t DEFAULT_BUFFER_SIZE = 1024 * 1024;
+
+public:
+	//! Construction from the file to create, encoding, flush mode and buffer size.
+	TextFileWriter(const tstring& filename, Encoding encoding = UnicodeLineReader::ANSI, FlushMode mode = FOREGROUND, size_t bufferSize = DEFAULT_BUFFER_SIZE); // throw(FileSystemException, InvalidArgException, RuntimeException)
+
+	//! Destructor.
+	~TextFileWriter();
+
+	//
+	// Properties.
+	//
+
+	//! Get the encoding of the file.
+	Encoding encoding() const;
+
+	//
+	// Methods.
+	//
+
+	//! Write some text.
+	void write(const TextRange& text); // throw(FileSystemException)
+
+	//! Write some text.
+	void write(const tstring& text); // throw(FileSystemException)
+
+	//! Write some text.
+	void write(const tchar* text); // throw(FileSystemException)
+
+	//! Write a line of text followed by a line terminator.
+	void writeLine(const TextRange& line); // throw(FileSystemException)
+
+	//! Write a line of text followed by a line terminator.
+	void writeLine(const tstring& line); // throw(FileSystemException)
+
+	//! Write a line of text followed by a line terminator.
+	void writeLine(const tchar* line); // throw(FileSystemException)
+
+	//! Write a line terminator.
+	void writeLine(); // throw(FileSystemException)
+
+	//! Write some ANSI characters.
+	void writeAnsi(const char* text, size_t length); // throw(FileSystemException)
+
+	//! Append an integer value.
+	void append(int value); // throw(FileSystemException)
+
+	//! Append an integer value.
+	void append(uint value); // throw(FileSystemException)
+
+	//! Append an integer value.
+	void append(long value); // throw(FileSystemException)
+
+	//! Append an integer value.
+	void append(ulong value); // throw(FileSystemException)
+
+	//! Append an integer value.
+	void append(longlong value); // throw(FileSystemException)
+
+	//! Append an integer value.
+	void append(ulonglong value); // throw(FileSystemException)
+
+	//! Append a floating-point value.
+	void append(double value, int precision = 6); // throw(FileSystemException)
+
+	//! Write the buffered text to the file.
+	void flush(); // throw(FileSystemException)
+
+	//! Write the buffered text to the file and then to the disk.
+	void sync(); // throw(FileSystemException)
+
+	//! Flush the buffered text and close the file.
+	void close(); // throw(FileSystemException)
+
+private:
+	//! A buffer of encoded text.
+	typedef std::vector<char> CharBuffer;
+	//! A buffer of wide characters.
+	typedef std::vector<wchar_t> WCharBuffer;
+
+	//
+	// Members.
+	//
+	tstring				m_filename;		//!< The file being written.
+	void*				m_file;			//!< The file handle.
+	Encoding			m_encoding;		//!< The encoding of the file.
+	size_t				m_maxCharSize;	//!< The most bytes a character encodes to.
+	CharBuffer			m_buffer;		//!< The buffer being filled.
+	size_t				m_used;			//!< The number of bytes buffered.
+	WCharBuffer			m_widened;		//!< The text converted to UNICODE.
+	CharBuffer			m_flushBuffer;	//!< The buffer being written in the background.
+	size_t				m_flushSize;	//!< The number of bytes being written.
+	bool				m_flushing;		//!< Is a background write in progress?
+	bool				m_failed;		//!< Did the background write fail?
+	tstring				m_error;		//!< The details of the failed write.
+	bool				m_stopping;		//!< Should the background thread stop?
+	Event				m_flushRequested;	//!< Signalled when a buffer needs writing.
+	Event				m_flushCompleted;	//!< Signalled when a buffer has been written.
+	UniquePtr<Thread>	m_thread;		//!< The background thread.
+
+	//
+	// Internal methods.
+	//
+
+	//! Write some text.
+	void write(const tchar* begin, const tchar* end);
+
+	//! Write some ASCII characters.
+	void writeAscii(const char* text, size_t length);
+
+	//! Append a signed integer value.
+	void appendSigned(longlong value);
+
+	//! Append an unsigned integer value.
+	void appendUnsigned(ulonglong value, bool negative);
+
+	//! Encode the text into the buffer.
+	size_t encode(const tchar* begin, const tchar* end, char* output);
+
+	//! Hand the full buffer over to be written.
+	void submitBuffer();
+
+	//! Wait for the background write to complete.
+	void waitForFlush();
+
+	//! Write the bytes to the file.
+	void writeFile(const char* data, size_t size);
+
+	//! Stop the background thread and close the file.
+	void release();
+
+	//! Write buffers until the writer is closed.
+	void flushBuffers();
+
+	//! The background thread function.
+	static void flushThread(void* param);
+
+	// NotCopyable.
+	TextFileWriter(const TextFileWriter&);
+	TextFileWriter& operator=(const TextFileWriter&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the encoding of the file.
+
+inline TextFileWriter::Encoding TextFileWriter::encoding() const
+{
+	return m_encoding;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write some text.
+
+inline void TextFileWriter::write(const TextRange& text)
+{
+	write(text.begin(), text.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write some text.
+
+inline void TextFileWriter::write(const tstring& text)
+{
+	write(text.data(), text.data() + text.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write some text.
+
+inline void TextFileWriter::write(const tchar* text)
+{
+	write(text, text + tstrlen(text));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write a line of text followed by a line terminator.
+
+inline void TextFileWriter::writeLine(const TextRange& line)
+{
+	write(line.begin(), line.end());
+	writeLine();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write a line of text followed by a line terminator.
+
+inline void TextFileWriter::writeLine(const tstring& line)
+{
+	write(line.data(), line.data() + line.size());
+	writeLine();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write a line of text followed by a line terminator.
+
+inline void TextFileWriter::writeLine(const tchar* line)
+{
+	write(line, line + tstrlen(line));
+	writeLine();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write a line terminator.
+
+inline void TextFileWriter::writeLine()
+{
+	writeAscii("\r\n", 2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append an integer value.
+
+inline void TextFileWriter::append(int value)
+{
+	appendSigned(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append an integer value.
+
+inline void TextFileWriter::append(uint value)
+{
+	appendUnsigned(value, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append an integer value.
+
+inline void TextFileWriter::append(long value)
+{
+	appendSigned(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append an integer value.
+
+inline void TextFileWriter::append(ulong value)
+{
+	appendUnsigned(value, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append an integer value.
+
+inline void TextFileWriter::append(longlong value)
+{
+	appendSigned(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append an integer value.
+
+inline void TextFileWriter::append(ulonglong value)
+{
+	appendUnsigned(value, false);
+}
+
+//namespace Core
+}
+
+#endif // CORE_TEXTFILEWRITER_HPP
@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Thread.cpp
+//! \brief  The Thread class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "Thread.hpp"
+#include "AnsiWide.hpp"
+#include "RuntimeException.hpp"
+#include "StringUtils.hpp"
+#include <windows.h>
+#include <process.h>
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the function to run and its parameter. The thread is
+//! started immediately.
+
+Thread::Thread(Function function, void* param)
+	: m_function(function)
+	, m_param(param)
+	, m_handle(nullptr)
+	, m_failed(false)
+	, m_error()
+{
+	ASSERT(m_function != nullptr);
+
+	uintptr_t handle = ::_beginthreadex(nullptr, 0, threadProc, this, 0, nullptr);
+
+	if (handle == 0)
+	{
+		int     errorCode = errno;
+		tstring errorText = A2T(strerror(errorCode));
+
+		throw RuntimeException(Core::fmt(TXT("Failed to create thread [%d - %s]"), errorCode, errorText.c_str()));
+	}
+
+	m_handle = reinterpret_cast<void*>(handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. Waits for the thread to complete, if it hasn't already been
+//! joined. Any exception is discarded.
+
+Thread::~Thread()
+{
+	if (m_handle != nullptr)
+	{
+		::WaitForSingleObject(m_handle, INFINITE);
+		::CloseHandle(m_handle);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait for the thread function to complete. If the function threw an
+//! exception its details are rethrown.
+
+void Thread::join()
+{
+	if (m_handle == nullptr)
+		throw RuntimeException(TXT("Attempted to join a thread that has already been joined"));
+
+	::WaitForSingleObject(m_handle, INFINITE);
+	::CloseHandle(m_handle);
+
+	m_handle = nullptr;
+
+	if (m_failed)
+		throw RuntimeException(Core::fmt(TXT("Unhandled exception on worker thread: %s"), m_error.c_str()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of processors available to run threads.
+
+uint Thread::processorCount()
+{
+	SYSTEM_INFO info;
+
+	::GetSystemInfo(&info);
+
+	return std::max<uint>(info.dwNumberOfProcessors, 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Run the thread function, capturing any exception.
+
+void Thread::run()
+{
+	try
+	{
+		m_function(m_param);
+	}
+	catch (const Core::Exception& e)
+	{
+		m_error = e.twhat();
+		m_failed = true;
+	}
+	catch (const std::exception& e)
+	{
+		m_error = A2T(e.what());
+		m_failed = true;
+	}
+	catch (...)
+	{
+		m_error = TXT("UNKNOWN");
+		m_failed = true;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The thread entry point.
+
+unsigned __stdcall Thread::threadProc(void* param)
+{
+	Thread* thread = static_cast<Thread*>(param);
+
+	thread->run();
+
+	return 0;
+}
+
+//namespace Core
+}
@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Thread.hpp
+//! \brief  The Thread class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_THREAD_HPP
+#define CORE_THREAD_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A worker thread that runs a single function to completion. The thread is
+//! started on construction and joined either explicitly or on destruction. Any
+//! exception that escapes the function is caught and its details are rethrown
+//! as a RuntimeException on the joining thread.
+
+class Thread /*: private NotCopyable*/
+{
+public:
+	//! The type of the function run by the thread.
+	typedef void (*Function)(void* param);
+
+public:
+	//! Construction from the function to run and its parameter.
+	Thread(Function function, void* param); // throw(RuntimeException)
+
+	//! Destructor.
+	~Thread();
+
+	//
+	// Methods.
+	//
+
+	//! Wait for the thread function to complete.
+	void join(); // throw(RuntimeException)
+
+	//
+	// Class methods.
+	//
+
+	//! Get the number of processors available to run threads.
+	static uint processorCount();
+
+private:
+	//
+	// Members.
+	//
+	Function	m_function;		//!< The function to run.
+	void*		m_param;		//!< The function parameter.
+	void*		m_handle;		//!< The thread handle.
+	bool		m_failed;		//!< Did the function throw an exception?
+	tstring		m_error;		//!< The details of the exception.
+
+	//
+	// Internal methods.
+	//
+
+	//! Run the thread function, capturing any exception.
+	void run();
+
+	//! The thread entry point.
+	static unsigned __stdcall threadProc(void* param);
+
+	// NotCopyable.
+	Thread(const Thread&);
+	Thread& operator=(const Thread&);
+};
+
+//namespace Core
+}
+
+#endif // CORE_THREAD_HPP
@@ -0,0 +1,216 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   TokenIndex.hpp
+//! \brief  The TokenIndex class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_TOKENINDEX_HPP
+#define CORE_TOKENINDEX_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include "Range.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The locations of the tokens within a string, as created by
+//! Tokeniser::splitIndex(). Only the offset and length of each token are
+//! stored so that the caller can choose which tokens to materialise. Clearing
+//! the index retains its storage so that it can be reused without allocating.
+
+class TokenIndex
+{
+public:
+	//! The location of a single token.
+	struct Token
+	{
+		size_t	m_offset;	//!< The offset of the token from the start of the string.
+		size_t	m_length;	//!< The length of the token.
+	};
+
+	//! The collection of token locations.
+	typedef std::vector<Token> Tokens;
+
+public:
+	//! Default constructor.
+	TokenIndex();
+
+	//! Destructor.
+	~TokenIndex();
+
+	//
+	// Operators.
+	//
+
+	//! Index operator.
+	const Token& operator[](size_t index) const;
+
+	//
+	// Properties.
+	//
+
+	//! Get the number of tokens.
+	size_t size() const;
+
+	//! Query if there are no tokens.
+	bool empty() const;
+
+	//
+	// Methods.
+	//
+
+	//! Remove all tokens, but retain the storage.
+	void clear();
+
+	//! Reserve space for a number of tokens.
+	void reserve(size_t count);
+
+	//! Append the location of a token.
+	void append(size_t offset, size_t length);
+
+	//! Append the locations from another index, adjusted by an offset.
+	void append(const TokenIndex& index, size_t offset);
+
+	//! Get a token as a view onto the string that was tokenised.
+	TextRange range(const TextRange& string, size_t index) const;
+
+	//! Get a token as a view onto the string that was tokenised.
+	TextRange range(const tstring& string, size_t index) const;
+
+	//! Get a copy of a token from the string that was tokenised.
+	tstring str(const TextRange& string, size_t index) const;
+
+	//! Get a copy of a token from the string that was tokenised.
+	tstring str(const tstring& string, size_t index) const;
+
+private:
+	//
+	// Members.
+	//
+	Tokens	m_tokens;	//!< The token locations.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+inline TokenIndex::TokenIndex()
+	: m_tokens()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+inline TokenIndex::~TokenIndex()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Index operator.
+
+inline const TokenIndex::Token& TokenIndex::operator[](size_t index) const
+{
+	ASSERT(index < m_tokens.size());
+
+	return m_tokens[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of tokens.
+
+inline size_t TokenIndex::size() const
+{
+	return m_tokens.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if there are no tokens.
+
+inline bool TokenIndex::empty() const
+{
+	return m_tokens.empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Remove all tokens, but retain the storage.
+
+inline void TokenIndex::clear()
+{
+	m_tokens.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Reserve space for a number of tokens.
+
+inline void TokenIndex::reserve(size_t count)
+{
+	m_tokens.reserve(count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append the location of a token.
+
+inline void TokenIndex::append(size_t offset, size_t length)
+{
+	Token token = { offset, length };
+
+	m_tokens.push_back(token);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append the locations from another index, adjusted by an offset. This is
+//! used to combine the indices of consecutive parts of the same string.
+
+inline void TokenIndex::append(const TokenIndex& index, size_t offset)
+{
+	m_tokens.reserve(m_tokens.size() + index.size());
+
+	for (Tokens::const_iterator it = index.m_tokens.begin(); it != index.m_tokens.end(); ++it)
+		append(it->m_offset + offset, it->m_length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get a token as a view onto the string that was tokenised.
+
+inline TextRange TokenIndex::range(const TextRange& string, size_t index) const
+{
+	const Token& token = (*this)[index];
+
+	ASSERT((token.m_offset + token.m_length) <= string.size());
+
+	return TextRange(string.begin() + token.m_offset, token.m_length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get a token as a view onto the string that was tokenised.
+
+inline TextRange TokenIndex::range(const tstring& string, size_t index) const
+{
+	return range(TextRange(string.data(), string.size()), index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get a copy of a token from the string that was tokenised.
+
+inline tstring TokenIndex::str(const TextRange& string, size_t index) const
+{
+	return toString(range(string, index));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get a copy of a token from the string that was tokenised.
+
+inline tstring TokenIndex::str(const tstring& string, size_t index) const
+{
+	return string.substr((*this)[index].m_offset, (*this)[index].m_length);
+}
+
+//namespace Core
+}
+
+#endif // CORE_TOKENINDEX_HPP
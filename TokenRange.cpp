@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   TokenRange.cpp
+//! \brief  The TokenRange and TokenIterator class definitions.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "TokenRange.hpp"
+#include "BadLogicException.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Constructor for the End iterator.
+
+TokenIterator::TokenIterator()
+	: m_tokeniser(nullptr)
+	, m_iter(nullptr)
+	, m_nextToken(Tokeniser::END_TOKEN)
+	, m_value()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Constructor for the Begin iterator. The iterator only refers to the
+//! tokeniser's configuration, the position is held by the iterator itself.
+
+TokenIterator::TokenIterator(const Tokeniser& tokeniser)
+	: m_tokeniser(&tokeniser)
+	, m_iter(tokeniser.m_begin)
+	, m_nextToken(tokeniser.m_nextToken)
+	, m_value()
+{
+	increment();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move the iterator forward by finding the next token, or to the End if
+//! there are no more.
+
+void TokenIterator::increment()
+{
+	if (m_tokeniser == nullptr)
+		throw BadLogicException(TXT("Attempted to increment end iterator"));
+
+	if (m_nextToken == Tokeniser::END_TOKEN)
+	{
+		m_tokeniser = nullptr;
+		m_iter = nullptr;
+		m_value = TextRange();
+		return;
+	}
+
+	bool escaped = false;
+
+	m_value = m_tokeniser->readToken(m_iter, m_nextToken, escaped);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a string, separator list, flags and quoting characters.
+
+TokenRange::TokenRange(const tstring& string, const tstring& seps, int flags, tchar quote, tchar escape)
+	: m_tokeniser(string, seps, flags, quote, escape)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a range of characters, separator list, flags and quoting
+//! characters.
+
+TokenRange::TokenRange(const TextRange& string, const tstring& seps, int flags, tchar quote, tchar escape)
+	: m_tokeniser(string, seps, flags, quote, escape)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a string, delimiter strings, flags and quoting characters.
+
+TokenRange::TokenRange(const tstring& string, const Tokeniser::Delimiters& delims, int flags, tchar quote, tchar escape)
+	: m_tokeniser(string, delims, flags, quote, escape)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a range of characters, delimiter strings, flags and
+//! quoting characters.
+
+TokenRange::TokenRange(const TextRange& string, const Tokeniser::Delimiters& delims, int flags, tchar quote, tchar escape)
+	: m_tokeniser(string, delims, flags, quote, escape)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+TokenRange::~TokenRange()
+{
+}
+
+//namespace Core
+}
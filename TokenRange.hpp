@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   TokenRange.hpp
+//! \brief  The TokenRange and TokenIterator class declarations.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_TOKENRANGE_HPP
+#define CORE_TOKENRANGE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Tokeniser.hpp"
+#include <iterator>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The forward iterator type used to visit the tokens of a TokenRange. Each
+//! token is a view onto the string and is only found when the iterator is
+//! advanced. Copies of an iterator can be advanced independently.
+
+class TokenIterator
+{
+public:
+	//
+	// Types.
+	//
+
+	typedef std::forward_iterator_tag	iterator_category;	//!< The iterator category.
+	typedef TextRange					value_type;			//!< The type of value.
+	typedef ptrdiff_t					difference_type;	//!< The distance between iterators.
+	typedef const TextRange*			pointer;			//!< A pointer to a value.
+	typedef const TextRange&			reference;			//!< A reference to a value.
+
+public:
+	//! Constructor for the End iterator.
+	TokenIterator();
+
+	//! Constructor for the Begin iterator.
+	explicit TokenIterator(const Tokeniser& tokeniser);
+
+	//
+	// Operators.
+	//
+
+	//! Dereference operator.
+	const TextRange& operator*() const;
+
+	//! Pointer-to-member operator.
+	const TextRange* operator->() const;
+
+	//! Pre-increment operator.
+	TokenIterator& operator++();
+
+	//! Post-increment operator.
+	TokenIterator operator++(int);
+
+	//
+	// Methods.
+	//
+
+	//! Compare to another iterator for equivalence.
+	bool equals(const TokenIterator& rhs) const;
+
+private:
+	//
+	// Members.
+	//
+	const Tokeniser*		m_tokeniser;	//!< The tokeniser configuration.
+	const tchar*			m_iter;			//!< The position of the next token.
+	Tokeniser::TokenType	m_nextToken;	//!< The next token type expected.
+	TextRange				m_value;		//!< The current token.
+
+	//
+	// Internal methods.
+	//
+
+	//! Move the iterator forward.
+	void increment();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! A lazily evaluated sequence of tokens which can be used with the standard
+//! algorithms. The string must outlive the range and its iterators. The
+//! iterators yield the same tokens as Tokeniser::nextTokenRange().
+
+class TokenRange /*: private NotCopyable*/
+{
+public:
+	//! The iterator type.
+	typedef TokenIterator iterator;
+	//! The const iterator type.
+	typedef TokenIterator const_iterator;
+
+public:
+	//! Construction from a string, separator list, flags and quoting characters.
+	TokenRange(const tstring& string, const tstring& seps, int flags = Tokeniser::NONE, tchar quote = TXT('"'), tchar escape = TXT('"'));
+
+	//! Construction from a range of characters, separator list, flags and quoting characters.
+	TokenRange(const TextRange& string, const tstring& seps, int flags = Tokeniser::NONE, tchar quote = TXT('"'), tchar escape = TXT('"'));
+
+	//! Construction from a string, delimiter strings, flags and quoting characters.
+	TokenRange(const tstring& string, const Tokeniser::Delimiters& delims, int flags = Tokeniser::NONE, tchar quote = TXT('"'), tchar escape = TXT('"')); // throw(InvalidArgException)
+
+	//! Construction from a range of characters, delimiter strings, flags and quoting characters.
+	TokenRange(const TextRange& string, const Tokeniser::Delimiters& delims, int flags = Tokeniser::NONE, tchar quote = TXT('"'), tchar escape = TXT('"')); // throw(InvalidArgException)
+
+	//! Destructor.
+	~TokenRange();
+
+	//
+	// Properties.
+	//
+
+	//! Get the iterator for the first token.
+	const_iterator begin() const;
+
+	//! Get the iterator for the end of the tokens.
+	const_iterator end() const;
+
+private:
+	//
+	// Members.
+	//
+	Tokeniser	m_tokeniser;	//!< The tokeniser configuration.
+
+	// NotCopyable.
+	TokenRange(const TokenRange&);
+	TokenRange& operator=(const TokenRange&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Dereference operator.
+
+inline const TextRange& TokenIterator::operator*() const
+{
+	ASSERT(m_tokeniser != nullptr);
+
+	return m_value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Pointer-to-member operator.
+
+inline const TextRange* TokenIterator::operator->() const
+{
+	ASSERT(m_tokeniser != nullptr);
+
+	return &m_value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Pre-increment operator.
+
+inline TokenIterator& TokenIterator::operator++()
+{
+	increment();
+
+	return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Post-increment operator.
+
+inline TokenIterator TokenIterator::operator++(int)
+{
+	TokenIterator previous(*this);
+
+	increment();
+
+	return previous;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare to another iterator for equivalence.
+
+inline bool TokenIterator::equals(const TokenIterator& rhs) const
+{
+	if (m_tokeniser == nullptr)
+		return (rhs.m_tokeniser == nullptr);
+
+	return (m_iter == rhs.m_iter) && (m_nextToken == rhs.m_nextToken);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare two iterators for equivalence.
+
+inline bool operator==(const TokenIterator& lhs, const TokenIterator& rhs)
+{
+	return lhs.equals(rhs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare two iterators for difference.
+
+inline bool operator!=(const TokenIterator& lhs, const TokenIterator& rhs)
+{
+	return !lhs.equals(rhs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the iterator for the first token.
+
+inline TokenRange::const_iterator TokenRange::begin() const
+{
+	return TokenIterator(m_tokeniser);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the iterator for the end of the tokens.
+
+inline TokenRange::const_iterator TokenRange::end() const
+{
+	return TokenIterator();
+}
+
+//namespace Core
+}
+
+#endif // CORE_TOKENRANGE_HPP
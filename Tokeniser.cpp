@@ -6,21 +6,159 @@
 #include "Common.hpp"
 #include "Tokeniser.hpp"
 #include "BadLogicException.hpp"
+#include "ParseException.hpp"
+#include "StringUtils.hpp"
+#include "TokenIndex.hpp"
+#include "InvalidArgException.hpp"
+#include "Thread.hpp"
+#include <algorithm>
 
 namespace Core
 {
 
 ////////////////////////////////////////////////////////////////////////////////
-//! Construction from a string, separator list and flags.
+//! The minimum number of characters each thread is given when the number of
+//! threads to use for a parallel split is chosen automatically.
 
-Tokeniser::Tokeniser(const tstring& string, const tstring& seps, int flags)
-	: m_string(string)
+static const size_t MIN_PARALLEL_CHUNK_SIZE = 256 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+//! A section of a string being tokenised by a parallel split.
+
+struct SplitChunk
+{
+	const tstring*	m_seps;			//!< The list of separators.
+	uint			m_flags;		//!< The tokenising control flags.
+	const tchar*	m_begin;		//!< The start of the chunk.
+	const tchar*	m_end;			//!< The end of the chunk.
+	const tchar*	m_sepEnd;		//!< The end of the separator(s) after the chunk.
+	TokenIndex		m_index;		//!< The chunk's token locations.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append the locations of the remaining tokens to an index.
+
+static size_t indexTokens(Tokeniser& tokeniser, const TextRange& string, TokenIndex& index)
+{
+	index.clear();
+
+	while (tokeniser.moreTokens())
+	{
+		TextRange token = tokeniser.nextTokenRange();
+
+		index.append(token.begin() - string.begin(), token.size());
+	}
+
+	return index.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Order delimiters so that the longest ones are matched first.
+
+static bool isLonger(const tstring& lhs, const tstring& rhs)
+{
+	return (lhs.size() > rhs.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Tokenise a single chunk of a string for a parallel split.
+
+static void splitChunk(void* param)
+{
+	SplitChunk* chunk = static_cast<SplitChunk*>(param);
+
+	Tokeniser::splitIndex(TextRange(chunk->m_begin, chunk->m_end), *chunk->m_seps, chunk->m_index, chunk->m_flags);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a string, separator list, flags and quoting characters.
+//! The quote and escape characters are only used when QUOTED_FIELDS is set.
+//! When they are the same character an embedded quote is written as a pair of
+//! quotes as per RFC 4180, otherwise the escape character precedes it.
+
+Tokeniser::Tokeniser(const tstring& string, const tstring& seps, int flags, tchar quote, tchar escape)
+	: m_begin(string.data())
+	, m_end(string.data() + string.size())
 	, m_seps(seps)
+	, m_delims()
+	, m_delimChars()
 	, m_flags(flags)
+	, m_quote(quote)
+	, m_escape(escape)
 	, m_nextToken(END_TOKEN)
-	, m_iter(m_string.begin())
+	, m_iter(m_begin)
+	, m_escaped(false)
 {
-	if (m_iter != m_string.end())
+	if (m_iter != m_end)
+		m_nextToken = VALUE_TOKEN;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a range of characters, separator list, flags and quoting
+//! characters. The characters must remain valid for the Tokeniser's lifetime.
+
+Tokeniser::Tokeniser(const TextRange& string, const tstring& seps, int flags, tchar quote, tchar escape)
+	: m_begin(string.begin())
+	, m_end(string.end())
+	, m_seps(seps)
+	, m_delims()
+	, m_delimChars()
+	, m_flags(flags)
+	, m_quote(quote)
+	, m_escape(escape)
+	, m_nextToken(END_TOKEN)
+	, m_iter(m_begin)
+	, m_escaped(false)
+{
+	if (m_iter != m_end)
+		m_nextToken = VALUE_TOKEN;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a string, delimiter strings, flags and quoting characters.
+//! Each separator is one of the delimiter strings, rather than a single
+//! character, and where more than one delimiter matches the longest is used.
+
+Tokeniser::Tokeniser(const tstring& string, const Delimiters& delims, int flags, tchar quote, tchar escape)
+	: m_begin(string.data())
+	, m_end(string.data() + string.size())
+	, m_seps()
+	, m_delims(delims)
+	, m_delimChars()
+	, m_flags(flags)
+	, m_quote(quote)
+	, m_escape(escape)
+	, m_nextToken(END_TOKEN)
+	, m_iter(m_begin)
+	, m_escaped(false)
+{
+	compileDelimiters();
+
+	if (m_iter != m_end)
+		m_nextToken = VALUE_TOKEN;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a range of characters, delimiter strings, flags and
+//! quoting characters. The characters must remain valid for the Tokeniser's
+//! lifetime.
+
+Tokeniser::Tokeniser(const TextRange& string, const Delimiters& delims, int flags, tchar quote, tchar escape)
+	: m_begin(string.begin())
+	, m_end(string.end())
+	, m_seps()
+	, m_delims(delims)
+	, m_delimChars()
+	, m_flags(flags)
+	, m_quote(quote)
+	, m_escape(escape)
+	, m_nextToken(END_TOKEN)
+	, m_iter(m_begin)
+	, m_escaped(false)
+{
+	compileDelimiters();
+
+	if (m_iter != m_end)
 		m_nextToken = VALUE_TOKEN;
 }
 
@@ -31,6 +169,118 @@ Tokeniser::~Tokeniser()
 {
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! Validate the delimiter strings and order them so that the longest is matched
+//! first. The set of their first characters is used to find candidates.
+
+void Tokeniser::compileDelimiters()
+{
+	if (m_delims.empty())
+		throw InvalidArgException(TXT("No delimiters have been specified"));
+
+	for (Delimiters::const_iterator it = m_delims.begin(); it != m_delims.end(); ++it)
+	{
+		if (it->empty())
+			throw InvalidArgException(TXT("A delimiter cannot be an empty string"));
+
+		if (m_delimChars.find_first_of((*it)[0]) == npos)
+			m_delimChars += (*it)[0];
+	}
+
+	std::stable_sort(m_delims.begin(), m_delims.end(), isLonger);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the character is a separator.
+
+inline bool Tokeniser::isSeparator(tchar c) const
+{
+	return (m_seps.find_first_of(c) != npos);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the length of the separator at the iterator, or zero if there isn't
+//! one. When using delimiter strings the longest matching one is used.
+
+inline size_t Tokeniser::separatorLength(const tchar* it) const
+{
+	ASSERT(it != m_end);
+
+	if (m_delims.empty())
+		return isSeparator(*it) ? 1 : 0;
+
+	if (m_delimChars.find_first_of(*it) == npos)
+		return 0;
+
+	const size_t remaining = m_end - it;
+
+	for (Delimiters::const_iterator delim = m_delims.begin(); delim != m_delims.end(); ++delim)
+	{
+		if ( (delim->size() <= remaining) && (delim->compare(0, npos, it, delim->size()) == 0) )
+			return delim->size();
+	}
+
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Find the start of the next separator, or the end of the string. When there
+//! is only a single separator character, or all delimiter strings share the
+//! same first character, memchr() is used to find the candidates.
+
+const tchar* Tokeniser::findSeparator(const tchar* it) const
+{
+	const tstring& chars = (m_delims.empty()) ? m_seps : m_delimChars;
+
+	while (it != m_end)
+	{
+		if (chars.size() == 1)
+		{
+			it = static_cast<const tchar*>(tmemchr(it, chars[0], m_end - it));
+
+			if (it == nullptr)
+				return m_end;
+		}
+		else
+		{
+			while ( (it != m_end) && (chars.find_first_of(*it) == npos) )
+				++it;
+
+			if (it == m_end)
+				return m_end;
+		}
+
+		// Verify the full delimiter.
+		if (separatorLength(it) != 0)
+			return it;
+
+		++it;
+	}
+
+	return m_end;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Skip the separator at the iterator, and any that follow when merging.
+
+const tchar* Tokeniser::skipSeparators(const tchar* it) const
+{
+	size_t length = separatorLength(it);
+
+	ASSERT(length != 0);
+
+	it += length;
+
+	// Merge consecutive separators?
+	if (m_flags & MERGE_SEPS)
+	{
+		while ( (it != m_end) && ((length = separatorLength(it)) != 0) )
+			it += length;
+	}
+
+	return it;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Query if we've reached the end.
 
@@ -44,63 +294,59 @@ bool Tokeniser::moreTokens() const
 
 tstring Tokeniser::nextToken()
 {
-	tstring::const_iterator start = m_iter;
-	tstring::const_iterator end   = start;
+	TextRange token = nextTokenRange();
+
+	if (m_escaped)
+		return unescape(token);
+
+	return toString(token);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the next token as a view onto the string. Quoted values are returned
+//! without their surrounding quotes, but any escaped quotes within them are
+//! left as-is, use nextToken() if they need to be removed.
+
+TextRange Tokeniser::nextTokenRange()
+{
+	return readToken(m_iter, m_nextToken, m_escaped);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the token at the position described by the iterator and next token
+//! type, and then advance them. This allows the tokenising state to be held
+//! outside the Tokeniser, e.g. by a TokenIterator.
+
+TextRange Tokeniser::readToken(const tchar*& iter, TokenType& nextToken, bool& escaped) const
+{
+	const tchar* start = iter;
+	const tchar* end   = start;
+
+	escaped = false;
 
 	// Next token is a value?
-	if (m_nextToken == VALUE_TOKEN)
+	if (nextToken == VALUE_TOKEN)
 	{
+		// Quoted value?
+		if ( (m_flags & QUOTED_FIELDS) && (iter != m_end) && (*iter == m_quote) )
+			return readQuotedToken(iter, nextToken, escaped);
+
 		// Find next separator or EOS.
-		while ( (m_iter != m_string.end()) && (m_seps.find_first_of(*m_iter) == npos) )
-			++m_iter;
+		iter = findSeparator(iter);
 
-		end = m_iter;
+		end = iter;
 
-		// Stopped on a separator?
-		if (m_iter != m_string.end())
-		{
-			// Switch state, if returning separators.
-			if (m_flags & RETURN_SEPS)
-			{
-				m_nextToken = SEPARATOR_TOKEN;
-			}
-			// Skip separators.
-			else 
-			{
-				++m_iter;
-
-				// Merge consecutive separators?
-				if (m_flags & MERGE_SEPS)
-				{
-					while ( (m_iter != m_string.end()) && (m_seps.find_first_of(*m_iter) != npos) )
-						++m_iter;
-				}
-			}
-		}
-		// Reached EOS.
-		else
-		{
-			m_nextToken = END_TOKEN;
-		}
+		endValueToken(iter, nextToken);
 	}
 	// Next token is a separator?
-	else if (m_nextToken == SEPARATOR_TOKEN)
+	else if (nextToken == SEPARATOR_TOKEN)
 	{
-		ASSERT(m_seps.find_first_of(*m_iter) != npos);
-
-		++m_iter;
+		iter = skipSeparators(iter);
 
-		// Merge consecutive separators?
-		if (m_flags & MERGE_SEPS)
-		{
-			while ( (m_iter != m_string.end()) && (m_seps.find_first_of(*m_iter) != npos) )
-				++m_iter;
-		}
-
-		end = m_iter;
+		end = iter;
 
 		// Switch state back to normal.
-		m_nextToken = VALUE_TOKEN;
+		nextToken = VALUE_TOKEN;
 	}
 	// Already reached the end.
 	else
@@ -108,15 +354,15 @@ tstring Tokeniser::nextToken()
 		throw BadLogicException(TXT("Attempted to iterate past the end of a Tokeniser"));
 	}
 
-	return tstring(start, end);
+	return TextRange(start, end);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //! Tokenise the string into an array of strings.
 
-size_t Tokeniser::split(const tstring& string, const tstring& seps, Tokens& tokens, uint flags)
+size_t Tokeniser::split(const tstring& string, const tstring& seps, Tokens& tokens, uint flags, tchar quote, tchar escape)
 {
-	Tokeniser tokeniser(string, seps, flags);
+	Tokeniser tokeniser(string, seps, flags, quote, escape);
 
 	while (tokeniser.moreTokens())
 		tokens.push_back(tokeniser.nextToken());
@@ -124,5 +370,268 @@ size_t Tokeniser::split(const tstring& string, const tstring& seps, Tokens& toke
 	return tokens.size();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! Tokenise the range of characters into an index of token locations. Unlike
+//! split() the index is cleared first, but its storage is reused, so that a
+//! single index can be used to tokenise many strings without allocating. The
+//! tokens are the same as those returned by nextTokenRange().
+
+size_t Tokeniser::splitIndex(const TextRange& string, const tstring& seps, TokenIndex& index, uint flags, tchar quote, tchar escape)
+{
+	Tokeniser tokeniser(string, seps, flags, quote, escape);
+
+	return indexTokens(tokeniser, string, index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Tokenise the string into an index of token locations.
+
+size_t Tokeniser::splitIndex(const tstring& string, const tstring& seps, TokenIndex& index, uint flags, tchar quote, tchar escape)
+{
+	return splitIndex(TextRange(string.data(), string.size()), seps, index, flags, quote, escape);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Tokenise the string into an array of strings using delimiter strings.
+
+size_t Tokeniser::split(const tstring& string, const Delimiters& delims, Tokens& tokens, uint flags, tchar quote, tchar escape)
+{
+	Tokeniser tokeniser(string, delims, flags, quote, escape);
+
+	while (tokeniser.moreTokens())
+		tokens.push_back(tokeniser.nextToken());
+
+	return tokens.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Tokenise the range of characters into an index of token locations using
+//! delimiter strings.
+
+size_t Tokeniser::splitIndex(const TextRange& string, const Delimiters& delims, TokenIndex& index, uint flags, tchar quote, tchar escape)
+{
+	Tokeniser tokeniser(string, delims, flags, quote, escape);
+
+	return indexTokens(tokeniser, string, index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Tokenise the string into an index of token locations using delimiter
+//! strings.
+
+size_t Tokeniser::splitIndex(const tstring& string, const Delimiters& delims, TokenIndex& index, uint flags, tchar quote, tchar escape)
+{
+	return splitIndex(TextRange(string.data(), string.size()), delims, index, flags, quote, escape);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Tokenise a large range of characters into an index using multiple threads.
+//! The string is cut into roughly equal chunks, with each cut moved forward to
+//! the next separator (or the start of the next run of separators when
+//! merging), so that the separator(s) between two chunks belong to neither.
+//! The chunks are then tokenised concurrently and their indices concatenated,
+//! along with the separators between them when they are being returned. The
+//! result is identical to splitIndex(). If the number of threads is zero it
+//! is chosen from the number of processors and size of the string. Quoted
+//! values are not supported as a cut cannot be found without scanning from
+//! the start of the string.
+
+size_t Tokeniser::splitParallel(const TextRange& string, const tstring& seps, TokenIndex& index, uint flags, size_t threads)
+{
+	typedef std::vector<SplitChunk> Chunks;
+	typedef SharedPtr<Thread> ThreadPtr;
+	typedef std::vector<ThreadPtr> Threads;
+
+	if (flags & QUOTED_FIELDS)
+		throw InvalidArgException(TXT("Quoted values are not supported by a parallel split"));
+
+	if (threads == 0)
+		threads = std::min<size_t>(Thread::processorCount(), (string.size() / MIN_PARALLEL_CHUNK_SIZE) + 1);
+
+	threads = std::min(threads, string.size());
+
+	if (threads <= 1)
+		return splitIndex(string, seps, index, flags);
+
+	const bool   merging = ((flags & MERGE_SEPS) != 0);
+	const tchar* begin = string.begin();
+	const tchar* end = string.end();
+	const size_t chunkSize = string.size() / threads;
+
+	Chunks chunks;
+
+	chunks.reserve(threads);
+
+	// Cut the string into chunks at separators.
+	for (const tchar* start = begin; ; )
+	{
+		SplitChunk chunk = { &seps, flags, start, end, end, TokenIndex() };
+
+		const tchar* it = std::max(start, begin + (chunks.size()+1) * chunkSize);
+
+		if (chunks.size() != threads-1)
+		{
+			while ( (it != end) && ( (seps.find_first_of(*it) == npos)
+								|| (merging && (it != begin) && (seps.find_first_of(*(it-1)) != npos)) ) )
+				++it;
+		}
+		else
+		{
+			it = end;
+		}
+
+		chunk.m_end = it;
+
+		if (it != end)
+		{
+			++it;
+
+			if (merging)
+			{
+				while ( (it != end) && (seps.find_first_of(*it) != npos) )
+					++it;
+			}
+		}
+
+		chunk.m_sepEnd = it;
+
+		chunks.push_back(chunk);
+
+		if (chunk.m_end == end)
+			break;
+
+		start = it;
+	}
+
+	Threads workers;
+
+	workers.reserve(chunks.size()-1);
+
+	// Tokenise the chunks, using the calling thread for the first one.
+	for (Chunks::iterator it = chunks.begin()+1; it != chunks.end(); ++it)
+		workers.push_back(ThreadPtr(new Thread(splitChunk, &*it)));
+
+	splitChunk(&chunks.front());
+
+	for (Threads::iterator it = workers.begin(); it != workers.end(); ++it)
+		(*it)->join();
+
+	index.clear();
+
+	// Concatenate the chunk indices.
+	for (Chunks::const_iterator it = chunks.begin(); it != chunks.end(); ++it)
+	{
+		// An empty chunk is still an empty value.
+		if (it->m_index.empty())
+			index.append(it->m_begin - begin, 0);
+		else
+			index.append(it->m_index, it->m_begin - begin);
+
+		if ( (flags & RETURN_SEPS) && (it->m_end != end) )
+			index.append(it->m_end - begin, it->m_sepEnd - it->m_end);
+	}
+
+	return index.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the token at the position when it's a quoted value. The surrounding
+//! quotes are excluded from the token. A closing quote must be followed by a
+//! separator or the end of the string.
+
+TextRange Tokeniser::readQuotedToken(const tchar*& iter, TokenType& nextToken, bool& escaped) const
+{
+	ASSERT(*iter == m_quote);
+
+	// Skip opening quote.
+	const tchar* start = ++iter;
+	const tchar* end   = start;
+
+	for (;;)
+	{
+		// Find next quote or escape character.
+		while ( (iter != m_end) && (*iter != m_quote) && (*iter != m_escape) )
+			++iter;
+
+		if (iter == m_end)
+			throw ParseException(TXT("Unterminated quoted value"));
+
+		const tchar* next = iter + 1;
+
+		// Escaped character?
+		if ( (next != m_end) && ( ((*iter == m_escape) && (m_escape != m_quote))
+								|| ((*next == m_quote) && (m_escape == m_quote)) ) )
+		{
+			escaped = true;
+			iter = next + 1;
+		}
+		// Closing quote?
+		else if (*iter == m_quote)
+		{
+			end = iter;
+			iter = next;
+			break;
+		}
+		else
+		{
+			throw ParseException(TXT("Unterminated quoted value"));
+		}
+	}
+
+	if ( (iter != m_end) && (separatorLength(iter) == 0) )
+		throw ParseException(Core::fmt(TXT("Unexpected character '%c' after closing quote"), *iter));
+
+	endValueToken(iter, nextToken);
+
+	return TextRange(start, end);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Remove the escape characters from a quoted value.
+
+tstring Tokeniser::unescape(const TextRange& token) const
+{
+	tstring value;
+
+	value.reserve(token.size());
+
+	for (const tchar* it = token.begin(); it != token.end(); ++it)
+	{
+		if ( ((*it == m_escape) || (*it == m_quote)) && (it+1 != token.end()) )
+			++it;
+
+		value += *it;
+	}
+
+	return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Skip the separator(s) following a value token, or switch to the separator
+//! state if they are being returned.
+
+void Tokeniser::endValueToken(const tchar*& iter, TokenType& nextToken) const
+{
+	// Stopped on a separator?
+	if (iter != m_end)
+	{
+		// Switch state, if returning separators.
+		if (m_flags & RETURN_SEPS)
+		{
+			nextToken = SEPARATOR_TOKEN;
+		}
+		// Skip separators.
+		else
+		{
+			iter = skipSeparators(iter);
+		}
+	}
+	// Reached EOS.
+	else
+	{
+		nextToken = END_TOKEN;
+	}
+}
+
 //namespace Core
 }
@@ -12,10 +12,15 @@
 #endif
 
 #include <vector>
+#include "Range.hpp"
 
 namespace Core
 {
 
+// Forward declarations.
+class TokenIndex;
+class TokenIterator;
+
 ////////////////////////////////////////////////////////////////////////////////
 //! A class to split a string into separate tokens.
 
@@ -29,17 +34,30 @@ public:
 	//! An array of strings.
 	typedef std::vector<tstring> Tokens;
 
+	//! A list of alternative delimiter strings.
+	typedef std::vector<tstring> Delimiters;
+
 	//! The flags that control the tokenisation.
 	enum Flags
 	{
 		NONE		= 0x0000,	//!< Default.
 		MERGE_SEPS	= 0x0001,	//!< Merge consecutive separators.
 		RETURN_SEPS = 0x0002,	//!< Return separators as tokens.
+		QUOTED_FIELDS = 0x0004,	//!< Values may be quoted (RFC 4180).
 	};
 
 public:
-	//! Construction from a string, separator list and flags.
-	Tokeniser(const tstring& string, const tstring& seps, int flags = NONE);
+	//! Construction from a string, separator list, flags and quoting characters.
+	Tokeniser(const tstring& string, const tstring& seps, int flags = NONE, tchar quote = TXT('"'), tchar escape = TXT('"'));
+
+	//! Construction from a range of characters, separator list, flags and quoting characters.
+	Tokeniser(const TextRange& string, const tstring& seps, int flags = NONE, tchar quote = TXT('"'), tchar escape = TXT('"'));
+
+	//! Construction from a string, delimiter strings, flags and quoting characters.
+	Tokeniser(const tstring& string, const Delimiters& delims, int flags = NONE, tchar quote = TXT('"'), tchar escape = TXT('"')); // throw(InvalidArgException)
+
+	//! Construction from a range of characters, delimiter strings, flags and quoting characters.
+	Tokeniser(const TextRange& string, const Delimiters& delims, int flags = NONE, tchar quote = TXT('"'), tchar escape = TXT('"')); // throw(InvalidArgException)
 
 	//! Destructor.
 	~Tokeniser();
@@ -54,14 +72,38 @@ public:
 	//! Get the next token.
 	tstring nextToken();
 
+	//! Get the next token as a view onto the string.
+	TextRange nextTokenRange();
+
 	//
 	// Class methods.
 	//
 
 	//! Tokenise the string into an array of strings.
-	static size_t split(const tstring& string, const tstring& seps, Tokens& tokens, uint flags = NONE);
+	static size_t split(const tstring& string, const tstring& seps, Tokens& tokens, uint flags = NONE, tchar quote = TXT('"'), tchar escape = TXT('"'));
+
+	//! Tokenise the string into an array of strings using delimiter strings.
+	static size_t split(const tstring& string, const Delimiters& delims, Tokens& tokens, uint flags = NONE, tchar quote = TXT('"'), tchar escape = TXT('"'));
+
+	//! Tokenise the range of characters into an index of token locations.
+	static size_t splitIndex(const TextRange& string, const tstring& seps, TokenIndex& index, uint flags = NONE, tchar quote = TXT('"'), tchar escape = TXT('"'));
+
+	//! Tokenise the string into an index of token locations.
+	static size_t splitIndex(const tstring& string, const tstring& seps, TokenIndex& index, uint flags = NONE, tchar quote = TXT('"'), tchar escape = TXT('"'));
+
+	//! Tokenise the range of characters into an index of token locations using delimiter strings.
+	static size_t splitIndex(const TextRange& string, const Delimiters& delims, TokenIndex& index, uint flags = NONE, tchar quote = TXT('"'), tchar escape = TXT('"'));
+
+	//! Tokenise the string into an index of token locations using delimiter strings.
+	static size_t splitIndex(const tstring& string, const Delimiters& delims, TokenIndex& index, uint flags = NONE, tchar quote = TXT('"'), tchar escape = TXT('"'));
+
+	//! Tokenise a large range of characters into an index using multiple threads.
+	static size_t splitParallel(const TextRange& string, const tstring& seps, TokenIndex& index, uint flags = NONE, size_t threads = 0);
 
 private:
+	// Allow the iterator to hold the tokenising state.
+	friend class TokenIterator;
+
 	//! The token types.
 	enum TokenType
 	{
@@ -74,11 +116,48 @@ private:
 	//
 	// Members.
 	//
-	const tstring&			m_string;		//!< The string to tokenise.
-	const tstring&			m_seps;			//!< The list of separators.
-	uint					m_flags;		//!< The tokenising control flags.
-	TokenType				m_nextToken;	//!< The next token type expected.
-	tstring::const_iterator	m_iter;			//!< The string iterator.
+	const tchar*	m_begin;		//!< The start of the string to tokenise.
+	const tchar*	m_end;			//!< The end of the string to tokenise.
+	tstring			m_seps;			//!< The list of separators.
+	Delimiters		m_delims;		//!< The delimiter strings, longest first.
+	tstring			m_delimChars;	//!< The first character of each delimiter.
+	uint			m_flags;		//!< The tokenising control flags.
+	tchar			m_quote;		//!< The character used to quote values.
+	tchar			m_escape;		//!< The character used to escape a quote.
+	TokenType		m_nextToken;	//!< The next token type expected.
+	const tchar*	m_iter;			//!< The string iterator.
+	bool			m_escaped;		//!< Does the last quoted token contain escapes?
+
+	//
+	// Internal methods.
+	//
+
+	//! Validate and order the delimiter strings.
+	void compileDelimiters();
+
+	//! Query if the character is a separator.
+	bool isSeparator(tchar c) const;
+
+	//! Get the length of the separator at the iterator, if any.
+	size_t separatorLength(const tchar* it) const;
+
+	//! Find the start of the next separator, or the end of the string.
+	const tchar* findSeparator(const tchar* it) const;
+
+	//! Skip the separator at the iterator, and any that follow when merging.
+	const tchar* skipSeparators(const tchar* it) const;
+
+	//! Read the token at the position and advance it.
+	TextRange readToken(const tchar*& iter, TokenType& nextToken, bool& escaped) const;
+
+	//! Read the token at the position when it's a quoted value.
+	TextRange readQuotedToken(const tchar*& iter, TokenType& nextToken, bool& escaped) const;
+
+	//! Remove the escape characters from a quoted value.
+	tstring unescape(const TextRange& token) const;
+
+	//! Skip the separator(s) following a value token.
+	void endValueToken(const tchar*& iter, TokenType& nextToken) const;
 };
 
 //namespace Core
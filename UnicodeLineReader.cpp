@@ -0,0 +1,520 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   UnicodeLineReader.cpp
+//! \brief  The UnicodeLineReader class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "UnicodeLineReader.hpp"
+#include "Win32Error.hpp"
+#include "FileSystemException.hpp"
+#include "InvalidArgException.hpp"
+#include "StringUtils.hpp"
+#include "AnsiWide.hpp"
+#include <windows.h>
+#include <limits.h>
+#include <algorithm>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The largest number of bytes that can be requested by a single ReadFile().
+
+static const size_t MAX_BLOCK_SIZE = INT_MAX - 4;
+
+////////////////////////////////////////////////////////////////////////////////
+//! The most bytes of an incomplete character that can be carried over from
+//! one block to the next. This is also enough for the longest BOM.
+
+static const size_t MAX_CARRIED = 4;
+
+////////////////////////////////////////////////////////////////////////////////
+//! The character used in place of an invalid sequence.
+
+static const wchar_t REPLACEMENT_CHAR = 0xFFFD;
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append a code point, as a surrogate pair when wchar_t is 16 bits.
+
+static wchar_t* appendCodePoint(ulong codePoint, wchar_t* output)
+{
+	if ( (codePoint > 0xFFFF) && (sizeof(wchar_t) == 2) )
+	{
+		codePoint -= 0x10000;
+
+		*output++ = static_cast<wchar_t>(0xD800 + (codePoint >> 10));
+		*output++ = static_cast<wchar_t>(0xDC00 + (codePoint & 0x3FF));
+	}
+	else
+	{
+		*output++ = static_cast<wchar_t>(codePoint);
+	}
+
+	return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Decode a block of UTF-8. Runs of ASCII are handled four bytes at a time.
+//! A sequence cut short by the end of the block is left unconsumed, unless it
+//! is the final block. Each byte produces at most one character, except for a
+//! four byte sequence, and so the output needs as many characters as bytes.
+
+static size_t decodeUtf8(const byte* begin, const byte* end, bool final, wchar_t* output, size_t& consumed)
+{
+	const byte* it = begin;
+	wchar_t*    out = output;
+
+	while (it != end)
+	{
+		// Copy a run of ASCII characters.
+		while ((end - it) >= 4)
+		{
+			uint word;
+
+			memcpy(&word, it, sizeof(word));
+
+			if ((word & 0x80808080) != 0)
+				break;
+
+			out[0] = it[0];
+			out[1] = it[1];
+			out[2] = it[2];
+			out[3] = it[3];
+
+			it += 4;
+			out += 4;
+		}
+
+		if (it == end)
+			break;
+
+		if (*it < 0x80)
+		{
+			*out++ = *it++;
+			continue;
+		}
+
+		size_t length = 0;
+		ulong  codePoint = 0;
+		ulong  minimum = 0;
+
+		if ((*it & 0xE0) == 0xC0)
+		{
+			length = 2;
+			codePoint = *it & 0x1F;
+			minimum = 0x80;
+		}
+		else if ((*it & 0xF0) == 0xE0)
+		{
+			length = 3;
+			codePoint = *it & 0x0F;
+			minimum = 0x800;
+		}
+		else if ((*it & 0xF8) == 0xF0)
+		{
+			length = 4;
+			codePoint = *it & 0x07;
+			minimum = 0x10000;
+		}
+		else
+		{
+			*out++ = REPLACEMENT_CHAR;
+			++it;
+			continue;
+		}
+
+		const size_t remaining = end - it;
+		size_t       i = 1;
+
+		for (; (i != length) && (i != remaining) && ((it[i] & 0xC0) == 0x80); ++i)
+			codePoint = (codePoint << 6) | (it[i] & 0x3F);
+
+		if (i != length)
+		{
+			// Continued in the next block?
+			if ( (i == remaining) && !final )
+				break;
+
+			*out++ = REPLACEMENT_CHAR;
+			it += i;
+			continue;
+		}
+
+		it += length;
+
+		// Overlong, out of range or a surrogate?
+		if ( (codePoint < minimum) || (codePoint > 0x10FFFF) || ((codePoint >= 0xD800) && (codePoint <= 0xDFFF)) )
+			*out++ = REPLACEMENT_CHAR;
+		else
+			out = appendCodePoint(codePoint, out);
+	}
+
+	consumed = it - begin;
+
+	return out - output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Decode a block of UTF-16. With a 16 bit wchar_t the code units are copied
+//! as is, and so on a little-endian host a UTF-16LE block is a straight copy.
+//! With a 32 bit wchar_t surrogate pairs are combined. A trailing odd byte, or
+//! a surrogate pair cut short by the end of the block, is left unconsumed
+//! unless it is the final block.
+
+static size_t decodeUtf16(const byte* begin, const byte* end, bool bigEndian, bool final, wchar_t* output, size_t& consumed)
+{
+	const byte* it = begin;
+	wchar_t*    out = output;
+
+	if ( (sizeof(wchar_t) == 2) && !bigEndian )
+	{
+		const size_t units = (end - begin) / 2;
+
+		memcpy(out, it, units * 2);
+
+		it += units * 2;
+		out += units;
+	}
+	else
+	{
+		const size_t high = bigEndian ? 0 : 1;
+		const size_t low = 1 - high;
+
+		while ((end - it) >= 2)
+		{
+			const ulong unit = (static_cast<ulong>(it[high]) << 8) | it[low];
+
+			if ( (sizeof(wchar_t) != 2) && (unit >= 0xD800) && (unit <= 0xDBFF) )
+			{
+				if ((end - it) < 4)
+				{
+					// Continued in the next block?
+					if (!final)
+						break;
+
+					*out++ = REPLACEMENT_CHAR;
+					it += 2;
+					continue;
+				}
+
+				const ulong next = (static_cast<ulong>(it[2+high]) << 8) | it[2+low];
+
+				if ( (next >= 0xDC00) && (next <= 0xDFFF) )
+				{
+					*out++ = static_cast<wchar_t>(0x10000 + ((unit - 0xD800) << 10) + (next - 0xDC00));
+					it += 4;
+					continue;
+				}
+			}
+
+			*out++ = static_cast<wchar_t>(unit);
+			it += 2;
+		}
+	}
+
+	// Trailing odd byte in the final block?
+	if ( (it != end) && final )
+	{
+		*out++ = REPLACEMENT_CHAR;
+		it = end;
+	}
+
+	consumed = it - begin;
+
+	return out - output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the file to read and the block size. The BOM is read
+//! straight away so that the encoding is known after construction.
+
+UnicodeLineReader::UnicodeLineReader(const tstring& filename, size_t blockSize)
+	: m_filename(filename)
+	, m_file(INVALID_HANDLE_VALUE)
+	, m_encoding(ANSI)
+	, m_input()
+	, m_carried(0)
+	, m_eof(false)
+	, m_wide()
+	, m_text()
+	, m_next(0)
+	, m_end(0)
+	, m_partial()
+	, m_clearPartial(false)
+{
+	if (blockSize == 0)
+		throw InvalidArgException(TXT("The block size cannot be zero"));
+
+	blockSize = std::min(blockSize, MAX_BLOCK_SIZE);
+
+	m_file = ::CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+							OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (m_file == INVALID_HANDLE_VALUE)
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw FileSystemException(Core::fmt(TXT("Failed to open file '%s' [0x%08lX - %s]"), filename.c_str(), errorCode, errorText.c_str()));
+	}
+
+	try
+	{
+		m_input.resize(blockSize + MAX_CARRIED);
+		m_text.resize(m_input.size());
+#ifdef ANSI_BUILD
+		m_wide.resize(m_input.size());
+#endif
+
+		readBom();
+	}
+	catch (...)
+	{
+		close();
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+UnicodeLineReader::~UnicodeLineReader()
+{
+	close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the next line, if there is one. This follows LineReader except that
+//! the scanning is done on the decoded characters.
+
+bool UnicodeLineReader::readLine(TextRange& line)
+{
+	if (m_clearPartial)
+	{
+		m_partial.clear();
+		m_clearPartial = false;
+	}
+
+	for (;;)
+	{
+		if (m_next != m_end)
+		{
+			const tchar* begin = &m_text.front() + m_next;
+			const tchar* end = &m_text.front() + m_end;
+			const tchar* newline = std::char_traits<tchar>::find(begin, end - begin, TXT('\n'));
+
+			if (newline != nullptr)
+			{
+				m_next = (newline + 1) - &m_text.front();
+
+				// Line is wholly within the block?
+				if (m_partial.empty())
+				{
+					setLine(begin, newline, line);
+				}
+				else
+				{
+					m_partial.insert(m_partial.end(), begin, newline);
+					setLine(&m_partial.front(), &m_partial.front() + m_partial.size(), line);
+					m_clearPartial = true;
+				}
+
+				return true;
+			}
+
+			m_partial.insert(m_partial.end(), begin, end);
+			m_next = m_end;
+		}
+
+		if (!nextBlock())
+			break;
+	}
+
+	m_next = m_end = 0;
+
+	// Final line without a terminator?
+	if (!m_partial.empty())
+	{
+		setLine(&m_partial.front(), &m_partial.front() + m_partial.size(), line);
+		m_clearPartial = true;
+		return true;
+	}
+
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the BOM to determine the encoding. Any bytes read which are not part
+//! of a BOM are carried over to the first block.
+
+void UnicodeLineReader::readBom()
+{
+	const size_t maxBomSize = 3;
+	size_t       read = 0;
+
+	while (read != maxBomSize)
+	{
+		const size_t count = readFile(&m_input[read], maxBomSize - read);
+
+		if (count == 0)
+		{
+			m_eof = true;
+			break;
+		}
+
+		read += count;
+	}
+
+	const byte* bom = reinterpret_cast<const byte*>(&m_input.front());
+	size_t      bomSize = 0;
+
+	if ( (read >= 3) && (bom[0] == 0xEF) && (bom[1] == 0xBB) && (bom[2] == 0xBF) )
+	{
+		m_encoding = UTF8;
+		bomSize = 3;
+	}
+	else if ( (read >= 2) && (bom[0] == 0xFF) && (bom[1] == 0xFE) )
+	{
+		m_encoding = UTF16LE;
+		bomSize = 2;
+	}
+	else if ( (read >= 2) && (bom[0] == 0xFE) && (bom[1] == 0xFF) )
+	{
+		m_encoding = UTF16BE;
+		bomSize = 2;
+	}
+
+	m_carried = read - bomSize;
+
+	if (m_carried != 0)
+		memmove(&m_input[0], &m_input[bomSize], m_carried);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read bytes from the file, returning 0 at the end.
+
+size_t UnicodeLineReader::readFile(char* buffer, size_t size)
+{
+	DWORD read = 0;
+
+	if (!::ReadFile(m_file, buffer, static_cast<DWORD>(size), &read, nullptr))
+	{
+		DWORD   errorCode = ::GetLastError();
+		tstring errorText = formatWin32ErrorMessage(errorCode);
+
+		throw FileSystemException(Core::fmt(TXT("Failed to read from file '%s' [0x%08lX - %s]"), m_filename.c_str(), errorCode, errorText.c_str()));
+	}
+
+	return read;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read and decode the next block, if there is one. The block is read after
+//! any bytes carried over from the previous one.
+
+bool UnicodeLineReader::nextBlock()
+{
+	for (;;)
+	{
+		size_t available = m_carried;
+
+		if (!m_eof)
+		{
+			const size_t read = readFile(&m_input[m_carried], m_input.size() - m_carried);
+
+			if (read == 0)
+				m_eof = true;
+
+			available += read;
+		}
+
+		if (available == 0)
+			return false;
+
+		size_t consumed = 0;
+		size_t length = decode(available, consumed);
+
+		m_carried = available - consumed;
+
+		if (m_carried != 0)
+			memmove(&m_input[0], &m_input[consumed], m_carried);
+
+		if (length != 0)
+		{
+			m_next = 0;
+			m_end = length;
+			return true;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Decode the bytes read so far into the text buffer, returning the number of
+//! characters. For an ANSI build UTF-8 and UTF-16 are decoded to wide
+//! characters first and then narrowed.
+
+size_t UnicodeLineReader::decode(size_t available, size_t& consumed)
+{
+	if (m_encoding == ANSI)
+	{
+		const char* begin = &m_input.front();
+
+#ifdef ANSI_BUILD
+		std::copy(begin, begin + available, &m_text.front());
+#else
+		ansiToWide(begin, begin + available, &m_text.front());
+#endif
+
+		consumed = available;
+
+		return available;
+	}
+
+	const byte* begin = reinterpret_cast<const byte*>(&m_input.front());
+	const byte* end = begin + available;
+
+#ifdef ANSI_BUILD
+	wchar_t* output = &m_wide.front();
+#else
+	wchar_t* output = &m_text.front();
+#endif
+	size_t   length = 0;
+
+	if (m_encoding == UTF8)
+		length = decodeUtf8(begin, end, m_eof, output, consumed);
+	else
+		length = decodeUtf16(begin, end, (m_encoding == UTF16BE), m_eof, output, consumed);
+
+#ifdef ANSI_BUILD
+	if (length != 0)
+		wideToAnsi(output, output + length, &m_text.front());
+#endif
+
+	return length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Return the line, trimming any trailing CR.
+
+void UnicodeLineReader::setLine(const tchar* begin, const tchar* end, TextRange& line)
+{
+	if ( (begin != end) && (*(end-1) == TXT('\r')) )
+		--end;
+
+	line = TextRange(begin, end);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Close the file.
+
+void UnicodeLineReader::close()
+{
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		::CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+	}
+}
+
+//namespace Core
+}
@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   UnicodeLineReader.hpp
+//! \brief  The UnicodeLineReader class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_UNICODELINEREADER_HPP
+#define CORE_UNICODELINEREADER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include "Range.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Reads the lines of a text file whose encoding is given by its byte order
+//! mark. Each block is decoded into the build's character type in one pass
+//! before it is scanned for lines, rather than a character at a time. A file
+//! without a BOM is treated as ANSI text. As with LineReader, each line is
+//! returned as a view which remains valid until the next line is read.
+
+class UnicodeLineReader /*: private NotCopyable*/
+{
+public:
+	//! The encoding of the file.
+	enum Encoding
+	{
+		ANSI,		//!< No BOM, so ANSI text.
+		UTF8,		//!< UTF-8 with a BOM.
+		UTF16LE,	//!< Little-endian UTF-16.
+		UTF16BE,	//!< Big-endian UTF-16.
+	};
+
+	//! The default number of bytes read at a time.
+	static const size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+public:
+	//! Construction from the file to read and the block size.
+	explicit UnicodeLineReader(const tstring& filename, size_t blockSize = DEFAULT_BLOCK_SIZE); // throw(FileSystemException, InvalidArgException)
+
+	//! Destructor.
+	~UnicodeLineReader();
+
+	//
+	// Properties.
+	//
+
+	//! Get the encoding of the file.
+	Encoding encoding() const;
+
+	//
+	// Methods.
+	//
+
+	//! Read the next line, if there is one.
+	bool readLine(TextRange& line); // throw(FileSystemException)
+
+private:
+	//! A buffer of bytes.
+	typedef std::vector<char> CharBuffer;
+	//! A buffer of wide characters.
+	typedef std::vector<wchar_t> WCharBuffer;
+	//! A buffer of build specific characters.
+	typedef std::vector<tchar> TCharBuffer;
+
+	//
+	// Members.
+	//
+	tstring		m_filename;		//!< The file being read.
+	void*		m_file;			//!< The file handle.
+	Encoding	m_encoding;		//!< The encoding of the file.
+	CharBuffer	m_input;		//!< The undecoded bytes.
+	size_t		m_carried;		//!< The incomplete character from the last block.
+	bool		m_eof;			//!< Has the end of the file been reached?
+	WCharBuffer	m_wide;			//!< The decoded block.
+	TCharBuffer	m_text;			//!< The decoded block as build specific characters.
+	size_t		m_next;			//!< The start of the next line in the block.
+	size_t		m_end;			//!< The end of the decoded block.
+	TCharBuffer	m_partial;		//!< The start of a line that straddles blocks.
+	bool		m_clearPartial;	//!< Was the partial line returned last time?
+
+	//
+	// Internal methods.
+	//
+
+	//! Read the BOM to determine the encoding.
+	void readBom();
+
+	//! Read bytes from the file.
+	size_t readFile(char* buffer, size_t size);
+
+	//! Read and decode the next block, if there is one.
+	bool nextBlock();
+
+	//! Decode the bytes read so far.
+	size_t decode(size_t available, size_t& consumed);
+
+	//! Return the line, trimming any trailing CR.
+	static void setLine(const tchar* begin, const tchar* end, TextRange& line);
+
+	//! Close the file.
+	void close();
+
+	// NotCopyable.
+	UnicodeLineReader(const UnicodeLineReader&);
+	UnicodeLineReader& operator=(const UnicodeLineReader&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the encoding of the file.
+
+inline UnicodeLineReader::Encoding UnicodeLineReader::encoding() const
+{
+	return m_encoding;
+}
+
+//namespace Core
+}
+
+#endif // CORE_UNICODELINEREADER_HPP
@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Win32Error.cpp
+//! \brief  WIN32 error helper functions.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "Win32Error.hpp"
+#include "StringUtils.hpp"
+#include "FileSystemException.hpp"
+#include "Scoped.hpp"
+#include <windows.h>
+
+#if (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 2)) // GCC 4.2+
+#pragma GCC diagnostic ignored "-Wunused-value"
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wrapper to invoke LocalFree on the buffer pointer.
+
+static void localFree(tchar* buffer)
+{
+	HLOCAL handle = ::LocalFree(buffer);
+
+	ASSERT(handle == NULL);
+	DEBUG_USE_ONLY(handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert the WIN32 error code into a text message.
+
+tstring formatWin32ErrorMessage(ulong errorCode)
+{
+	typedef Core::Scoped<tchar*> BufferPtr;
+
+	tchar* buffer;
+
+	DWORD result = ::FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+									nullptr, errorCode, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
+									reinterpret_cast<tchar*>(&buffer), 0, nullptr);
+
+	if (result == 0)
+		return TXT("Failed to format message with::FormatMessage()");
+
+	ASSERT(buffer != nullptr);
+
+	BufferPtr managedBuffer(buffer, localFree);
+	tstring   message(buffer);
+
+	trim(message);
+
+	return message;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Throw an exception for the last WIN32 error when accessing the path.
+
+void throwLastError(const tchar* operation, const tstring& path)
+{
+	DWORD   errorCode = ::GetLastError();
+	tstring errorText = formatWin32ErrorMessage(errorCode);
+
+	throw FileSystemException(Core::fmt(TXT("%s '%s' [0x%08lX - %s]"), operation, path.c_str(), errorCode, errorText.c_str()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wrapper to invoke CloseHandle on a WIN32 handle.
+
+void closeHandle(HANDLE handle)
+{
+	::CloseHandle(handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read a block from the file at the given offset. The offset is passed via an
+//! OVERLAPPED structure so that the handle's file pointer is neither used nor
+//! moved, which allows the handle to be shared between threads. Returns 0 at
+//! the end of the file.
+
+size_t readAt(HANDLE file, const tstring& filename, ulonglong offset, char* buffer, size_t size)
+{
+	OVERLAPPED overlapped;
+	DWORD      read = 0;
+
+	memset(&overlapped, 0, sizeof(overlapped));
+
+	overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+	overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+	if (!::ReadFile(file, buffer, static_cast<DWORD>(size), &read, &overlapped))
+	{
+		if (::GetLastError() == ERROR_HANDLE_EOF)
+			return 0;
+
+		throwLastError(TXT("Failed to read from file"), filename);
+	}
+
+	return read;
+}
+
+//namespace Core
+}
@@ -0,0 +1,47 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Win32Error.hpp
+//! \brief  WIN32 error helper functions.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_WIN32ERROR_HPP
+#define CORE_WIN32ERROR_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Scoped.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+// Convert the WIN32 error code into a text message.
+
+tstring formatWin32ErrorMessage(ulong errorCode);
+
+////////////////////////////////////////////////////////////////////////////////
+// Throw an exception for the last WIN32 error when accessing the path.
+
+void throwLastError(const tchar* operation, const tstring& path); // throw(FileSystemException)
+
+////////////////////////////////////////////////////////////////////////////////
+// Wrapper to invoke CloseHandle on a WIN32 handle.
+
+void closeHandle(void* handle);
+
+////////////////////////////////////////////////////////////////////////////////
+// The smart pointer type used to close a WIN32 handle.
+
+typedef Scoped<void*> HandlePtr;
+
+////////////////////////////////////////////////////////////////////////////////
+// Read a block from the file at the given offset, returning 0 at the end.
+
+size_t readAt(void* file, const tstring& filename, ulonglong offset, char* buffer, size_t size); // throw(FileSystemException)
+
+//namespace Core
+}
+
+#endif // CORE_WIN32ERROR_HPP
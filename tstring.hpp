@@ -28,6 +28,7 @@
 
 #include <string>
 #include <string.h>
+#include <wchar.h>
 
 namespace Core
 {
@@ -105,6 +106,7 @@ typedef std::istream	tistream;	//!< Build agnostic input stream type.
 #define tstrchr			strchr
 #define	tstrrchr		strrchr
 #define	tstrstr			strstr
+#define tmemchr			memchr
 #define tstrtol			strtol
 #define tstrtoul		strtoul
 #define tstrtod			strtod
@@ -151,6 +153,7 @@ typedef std::wistream	tistream;	//!< Build agnostic input stream type.
 #define tstrchr			wcschr
 #define	tstrrchr		wcsrchr
 #define	tstrstr			wcsstr
+#define tmemchr			wmemchr
 #define tstrtol			wcstol
 #define tstrtoul		wcstoul
 #define tstrtod			wcstod